@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <iostream>
+
+#include "airspace_index.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int volumeCount = 20000;
+constexpr int queryCount = 10000;
+
+// Irregular star shaped polygons, several kilometers across, over a 10 by 10 degrees area
+QVector<AirspaceVolume> randomVolumes(QRandomGenerator& random, int count)
+{
+    QVector<AirspaceVolume> volumes;
+    volumes.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        AirspaceVolume volume;
+        volume.id = QString::number(i);
+        volume.inclusion = random.bounded(2);
+        volume.floor = random.bounded(3000);
+        volume.ceiling = volume.floor + random.bounded(100, 5000);
+
+        const double centerX = 30 + random.generateDouble() * 10;
+        const double centerY = 50 + random.generateDouble() * 10;
+        const int vertices = random.bounded(3, 16);
+        for (int vertex = 0; vertex < vertices; ++vertex)
+        {
+            const double angle = 2 * M_PI * vertex / vertices;
+            const double radius = 0.01 + random.generateDouble() * 0.2;
+            volume.boundary.append(
+                QPointF(centerX + radius * qCos(angle), centerY + radius * qSin(angle)));
+        }
+        volumes.append(volume);
+    }
+    return volumes;
+}
+} // namespace
+
+TEST(AirspaceIndexBenchmark, benchmarkQueries)
+{
+    QRandomGenerator random(42);
+    const QVector<AirspaceVolume> volumes = ::randomVolumes(random, ::volumeCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    AirspaceIndex index;
+    index.build(volumes);
+    const qint64 buildElapsed = timer.elapsed();
+
+    QVector<double> latitudes, longitudes, altitudes;
+    for (int i = 0; i < ::queryCount; ++i)
+    {
+        latitudes.append(50 + random.generateDouble() * 10);
+        longitudes.append(30 + random.generateDouble() * 10);
+        altitudes.append(random.bounded(8000));
+    }
+
+    int hits = 0;
+    timer.restart();
+    for (int i = 0; i < ::queryCount; ++i)
+    {
+        hits += index.query(latitudes.at(i), longitudes.at(i), altitudes.at(i)).count();
+    }
+    const qint64 queryElapsed = timer.nsecsElapsed();
+
+    EXPECT_GT(hits, 0);
+    std::cout << ::volumeCount << " volumes built in " << buildElapsed << " ms, "
+              << queryElapsed / ::queryCount << " ns per query, " << hits << " hits"
+              << std::endl;
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <iostream>
+
+#include "conflict_detector.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int ownCount = 20;
+constexpr int trafficCount = 5000;
+constexpr int runCount = 100;
+} // namespace
+
+TEST(ConflictDetectorBenchmark, benchmark5000Targets)
+{
+    // Dense traffic over a 300 km square, own vehicles in the middle of it
+    QRandomGenerator random(42);
+    QVector<OwnState> own;
+    for (int i = 0; i < ::ownCount; ++i)
+    {
+        OwnState vehicle;
+        vehicle.id = QString::number(i);
+        vehicle.latitude = 55 + random.generateDouble() * 0.5;
+        vehicle.longitude = 37 + random.generateDouble() * 0.5;
+        vehicle.altitude = 500 + random.bounded(1000);
+        vehicle.groundSpeed = 20 + random.bounded(30);
+        vehicle.course = random.bounded(360);
+        own.append(vehicle);
+    }
+
+    QVector<TrafficState> traffic;
+    for (int i = 0; i < ::trafficCount; ++i)
+    {
+        TrafficState target;
+        target.code = QString::number(100000 + i);
+        target.latitude = 53.8 + random.generateDouble() * 2.7;
+        target.longitude = 35 + random.generateDouble() * 4.5;
+        target.altitude = random.bounded(2000);
+        target.heading = random.bounded(360);
+        target.groundSpeed = 50 + random.bounded(200);
+        target.verticalSpeed = random.bounded(-10, 10);
+        traffic.append(target);
+    }
+
+    const ConflictParameters parameters;
+    int total = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < ::runCount; ++run)
+    {
+        for (const QVector<Conflict>& conflicts :
+             ConflictDetector::detect(own, traffic, parameters))
+        {
+            total += conflicts.count();
+        }
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    EXPECT_GT(total, 0);
+    std::cout << own.count() << " vehicles against " << traffic.count() << " targets: "
+              << elapsed / ::runCount / 1000 << " us, " << total / ::runCount << " conflicts"
+              << std::endl;
+}
@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <iostream>
+
+#include "coverage_path_planner.h"
+
+using namespace md::domain;
+
+TEST(CoveragePathPlannerBenchmark, benchmark10kWaypoints)
+{
+    const QPolygonF square(
+        QVector<QPointF>{ { 0, 0 }, { 50000, 0 }, { 50000, 50000 }, { 0, 50000 } });
+    CoverageParameters parameters;
+    parameters.spacing = 10;
+
+    const CoveragePathPlanner planner(square);
+    QElapsedTimer timer;
+    timer.start();
+    const QPolygonF path = planner.plan(parameters, QPointF(0, 0));
+    const qint64 elapsed = timer.elapsed();
+
+    EXPECT_GE(path.count(), 10000);
+    std::cout << path.count() << " waypoints: " << elapsed << " ms" << std::endl;
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <iostream>
+
+#include "elevation_service.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int tileSize = 1201;
+constexpr int pointCount = 1000000;
+} // namespace
+
+TEST(ElevationServiceBenchmark, benchmark1MPoints)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    QByteArray data(::tileSize * ::tileSize * 2, Qt::Uninitialized);
+    for (int row = 0; row < ::tileSize; ++row)
+    {
+        for (int column = 0; column < ::tileSize; ++column)
+        {
+            const qint16 sample = column * 2 + (::tileSize - 1 - row);
+            qToBigEndian(sample, data.data() + (row * ::tileSize + column) * 2);
+        }
+    }
+
+    QFile file(dir.filePath("N55E037.hgt"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+
+    ElevationService service(dir.path());
+    QVector<double> latitudes(::pointCount);
+    QVector<double> longitudes(::pointCount);
+    QRandomGenerator random(42);
+    for (int i = 0; i < ::pointCount; ++i)
+    {
+        latitudes[i] = 55 + random.generateDouble();
+        longitudes[i] = 37 + random.generateDouble();
+    }
+    QVector<float> heights(::pointCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    service.heights(latitudes.constData(), longitudes.constData(), heights.data(), ::pointCount);
+    const qint64 batchElapsed = timer.elapsed();
+
+    timer.restart();
+    double scalarSum = 0;
+    for (int i = 0; i < ::pointCount; ++i)
+    {
+        scalarSum += service.height(latitudes.at(i), longitudes.at(i));
+    }
+    const qint64 scalarElapsed = timer.elapsed();
+
+    // Both sides produce every height
+    double batchSum = 0;
+    for (float height : qAsConst(heights))
+    {
+        batchSum += height;
+    }
+    EXPECT_NEAR(batchSum, scalarSum, qAbs(scalarSum) * 1e-6);
+    std::cout << ::pointCount << " points: " << batchElapsed << " ms batch, " << scalarElapsed
+              << " ms one by one" << std::endl;
+}
@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <iostream>
+
+#include "fenwick_tree.h"
+
+using namespace md::domain;
+
+TEST(FenwickTreeBenchmark, benchmarkAppends)
+{
+    const int count = 1000000;
+    FenwickTree<double> tree;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i)
+    {
+        tree.append(1.0);
+    }
+    const qint64 elapsed = timer.elapsed();
+
+    EXPECT_DOUBLE_EQ(tree.total(), count);
+    std::cout << count << " appends: " << elapsed << " ms" << std::endl;
+}
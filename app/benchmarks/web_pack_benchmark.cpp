@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <iostream>
+
+#include "web_pack_scheme_handler.h"
+
+using namespace md::app;
+
+namespace
+{
+// Touches every byte, pack data is a view of the mapped file until it is read
+quint32 checksum(const QByteArray& bytes)
+{
+    quint32 hash = 2166136261u;
+    for (char byte : bytes)
+    {
+        hash = (hash ^ quint8(byte)) * 16777619u;
+    }
+    return hash;
+}
+} // namespace
+
+TEST(WebPackBenchmark, benchmarkPackAgainstFiles)
+{
+    if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+        GTEST_SKIP() << "Web pack is served with Qt 5.14 or newer";
+    if (QString(PYTHON_EXECUTABLE).isEmpty())
+        GTEST_SKIP() << "Python is required to generate the pack";
+
+    const QDir webDir(QString(DREKA_SOURCE_DIR) + "/app/web");
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString packPath = dir.filePath("web.pack");
+    ASSERT_EQ(QProcess::execute(PYTHON_EXECUTABLE,
+                                { QString(DREKA_SOURCE_DIR) + "/scripts/webpackgen.py", packPath,
+                                  webDir.absolutePath() + "=web" }),
+              0);
+
+    QStringList paths;
+    QDirIterator files(webDir.absolutePath(), QDir::Files, QDirIterator::Subdirectories);
+    while (files.hasNext())
+    {
+        paths.append(webDir.relativeFilePath(files.next()));
+    }
+
+    // Both sides run from the page cache, the files were just read by the generator
+    QElapsedTimer timer;
+    timer.start();
+    quint32 filesChecksum = 0;
+    for (const QString& path : qAsConst(paths))
+    {
+        QFile file(webDir.absoluteFilePath(path));
+        file.open(QIODevice::ReadOnly);
+        filesChecksum += ::checksum(file.readAll());
+    }
+    const qint64 filesElapsed = timer.nsecsElapsed();
+
+    timer.restart();
+    WebPackSchemeHandler handler(packPath);
+    quint32 packChecksum = 0;
+    for (const QString& path : qAsConst(paths))
+    {
+        packChecksum += ::checksum(handler.data("web/" + path));
+    }
+    const qint64 packElapsed = timer.nsecsElapsed();
+
+    EXPECT_EQ(packChecksum, filesChecksum);
+    std::cout << paths.count() << " files: " << filesElapsed / 1000 << " us from files, "
+              << packElapsed / 1000 << " us from the pack" << std::endl;
+}
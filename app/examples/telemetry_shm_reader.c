@@ -0,0 +1,61 @@
+/* Prints vehicle states exported by Dreka started with --telemetry-shm [name],
+ * the segment name is the only argument and defaults to DREKA_SHM_NAME.
+ * Build: cc -I../src/core telemetry_shm_reader.c -o telemetry_shm_reader -lrt */
+
+/* usleep is not POSIX any more, strict C modes hide it without that */
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "dreka_telemetry_shm.h"
+
+int main(int argc, char* argv[])
+{
+    const int fd = shm_open(argc > 1 ? argv[1] : DREKA_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        perror("shm_open");
+        return 1;
+    }
+
+    const dreka_telemetry_shm_t* shm =
+        mmap(NULL, sizeof(dreka_telemetry_shm_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED)
+    {
+        perror("mmap");
+        return 1;
+    }
+
+    while (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != DREKA_SHM_MAGIC)
+    {
+        usleep(10000);
+    }
+    if (shm->version != DREKA_SHM_VERSION || shm->slot_size != sizeof(dreka_vehicle_slot_t))
+    {
+        fprintf(stderr, "Unsupported layout version %u\n", shm->version);
+        return 1;
+    }
+
+    for (;;)
+    {
+        const uint32_t count = __atomic_load_n(&shm->slot_count, __ATOMIC_ACQUIRE);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dreka_vehicle_state_t state;
+            if (!dreka_shm_read(shm, i, &state, 100))
+                continue;
+
+            printf("%s: %.7f %.7f %.1f m, roll %.1f pitch %.1f heading %.1f, gs %.1f m/s, "
+                   "battery %.2f V\n",
+                   state.vehicle_id, state.latitude, state.longitude, state.altitude_amsl,
+                   state.roll, state.pitch, state.heading, state.ground_speed,
+                   state.battery_voltage);
+        }
+        usleep(100000);
+    }
+    return 0;
+}
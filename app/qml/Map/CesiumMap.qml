@@ -18,9 +18,16 @@ Item {
 
     WebEngineView {
         anchors.fill: parent
-        url: "file:" + applicationDirPath + "/web/index.html"
+        url: webIndexUrl
         webChannel: WebChannel { id: webChannel }
         onJavaScriptConsoleMessage: console.log(message)
+        onLoadingChanged: {
+            if (loadRequest.status === WebEngineView.LoadStartedStatus)
+                return;
+
+            startupReport.end(startupMapPhase);
+            startupReport.finish();
+        }
     }
 
     MapCross {
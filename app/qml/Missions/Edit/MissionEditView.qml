@@ -12,6 +12,17 @@ Controls.Pane {
 
     MissionEditController { id: editController }
 
+    function distanceText(distance) {
+        return distance > 1000 ? ((Math.round(distance / 100) * 0.1).toFixed(1) + " " + qsTr("km")):
+                                 (Math.round(distance) + " " + qsTr("m"));
+    }
+
+    function durationText(duration) {
+        var minutes = Math.floor(duration / 60);
+        var seconds = Math.round(duration % 60);
+        return minutes + ":" + (seconds < 10 ? "0" : "") + seconds;
+    }
+
     ColumnLayout {
         anchors.fill: parent
         spacing: Controls.Theme.spacing
@@ -53,20 +64,57 @@ Controls.Pane {
             }
 
             Controls.MenuButton {
+                id: actionsButton
                 iconSource: "qrc:/icons/dots.svg"
                 tipText: qsTr("Mission actions")
                 flat: true
                 leftCropped: true
                 enabled: editController.online
-                model: ListModel {
-                    ListElement { text: qsTr("Upload"); property var action: () => { editController.upload() } }
-                    ListElement { text: qsTr("Download"); property var action: () => { editController.download() } }
-                    ListElement { text: qsTr("Clear"); property var action: () => { editController.clear() } }
+                // Invalid routes are not uploaded, the controller refuses them as well
+                model: [
+                    { text: editController.validating ? qsTr("Upload (validating)") : qsTr("Upload"),
+                      enabled: editController.valid, action: () => { editController.upload() } },
+                    { text: qsTr("Download"), enabled: true,
+                      action: () => { editController.download() } },
+                    { text: qsTr("Clear"), enabled: true, action: () => { editController.clear() } }
+                ]
+                delegate: Controls.MenuItem {
+                    text: modelData.text
+                    enabled: modelData.enabled
+                    onTriggered: {
+                        actionsButton.close();
+                        modelData.action();
+                    }
                 }
-                onTriggered: modelData.action()
             }
         }
 
+        Controls.Label {
+            readonly property var statistics: editController.statistics
+            visible: statistics.distance !== undefined
+            text: qsTr("Length") + ": " + distanceText(statistics.distance) + "\t" +
+                  qsTr("ETA") + ": " + durationText(statistics.duration) + "\t" +
+                  qsTr("Climb") + ": " + distanceText(statistics.climb) + "\t" +
+                  qsTr("Descent") + ": " + distanceText(statistics.descent)
+            Layout.fillWidth: true
+        }
+
+        Controls.Label {
+            readonly property var syncState: editController.syncState
+            visible: syncState.known === true && !syncState.synced
+            text: qsTr("Not synced, items to upload") + ": " + syncState.transferCount
+            color: Controls.Theme.colors.description
+            Layout.fillWidth: true
+        }
+
+        Controls.Label {
+            visible: editController.validationErrors.length > 0
+            text: editController.validationErrors.join("\n")
+            color: Controls.Theme.colors.negative
+            elide: Text.ElideRight
+            Layout.fillWidth: true
+        }
+
         Controls.TabBar {
             id: tab
             flat: true
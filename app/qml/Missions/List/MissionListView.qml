@@ -15,6 +15,11 @@ Controls.Pane {
 
     MissionListController { id: controller }
 
+    function filteredMissionIds() {
+        return controller.missions.filter(mission => mission.name.indexOf(filterField.text) > -1)
+                                  .map(mission => mission.id);
+    }
+
     ColumnLayout {
         anchors.fill: parent
         spacing: Controls.Theme.spacing
@@ -28,6 +33,38 @@ Controls.Pane {
                 placeholderText: qsTr("Filter missions")
                 Layout.fillWidth: true
             }
+
+            Controls.ProgressBar {
+                visible: controller.batchProgress != -1
+                flat: true
+                from: 0
+                to: 100
+                value: controller.batchProgress
+                implicitHeight: Controls.Theme.baseSize / 2
+                Layout.fillWidth: true
+
+                Controls.Button {
+                    anchors.fill: parent
+                    flat: true
+                    tipText: controller.batchFailed ? qsTr("Cancel, failed: ") + controller.batchFailed
+                                                    : qsTr("Cancel")
+                    onClicked: controller.cancelBatch()
+                }
+            }
+
+            Controls.MenuButton {
+                iconSource: "qrc:/icons/dots.svg"
+                tipText: qsTr("Actions for filtered missions")
+                flat: true
+                leftCropped: true
+                enabled: controller.batchProgress == -1
+                model: ListModel {
+                    ListElement { text: qsTr("Upload all"); property var action: () => { controller.uploadMissions(filteredMissionIds()) } }
+                    ListElement { text: qsTr("Download all"); property var action: () => { controller.downloadMissions(filteredMissionIds()) } }
+                    ListElement { text: qsTr("Clear all"); property var action: () => { controller.clearMissions(filteredMissionIds()) } }
+                }
+                onTriggered: modelData.action()
+            }
         }
 
         Widgets.ListWrapper {
@@ -0,0 +1,81 @@
+import QtQuick 2.12
+import QtQuick.Layouts 1.12
+import Industrial.Controls 1.0 as Controls
+import Dreka.Vehicles 1.0
+
+Controls.Pane {
+    id: root
+
+    property var selectedVehicle: null
+
+    LogPlaybackController { id: controller }
+
+    Component.onCompleted: map.registerController("logPlaybackController", controller)
+
+    function timeText(time) {
+        var seconds = Math.floor(time / 1000);
+        var minutes = Math.floor(seconds / 60);
+        return minutes + ":" + (seconds % 60 < 10 ? "0" : "") + seconds % 60;
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        spacing: Controls.Theme.spacing
+
+        RowLayout {
+            spacing: 0
+
+            Controls.TextField {
+                id: pathField
+                flat: true
+                placeholderText: qsTr("Log file (.tlog, .bin)")
+                text: controller.path
+                enabled: !controller.loading
+                onAccepted: if (selectedVehicle) controller.open(text, selectedVehicle.id)
+                Layout.fillWidth: true
+            }
+
+            Controls.Button {
+                flat: true
+                leftCropped: true
+                tipText: controller.opened ? qsTr("Close log") : qsTr("Open log")
+                iconSource: controller.opened ? "qrc:/icons/close.svg" : "qrc:/icons/ok.svg"
+                enabled: !controller.loading && (controller.opened || (selectedVehicle && pathField.text))
+                onClicked: controller.opened ? controller.close()
+                                             : controller.open(pathField.text, selectedVehicle.id)
+            }
+        }
+
+        RowLayout {
+            visible: controller.opened
+            spacing: Controls.Theme.spacing
+
+            Controls.Button {
+                flat: true
+                tipText: controller.playing ? qsTr("Pause") : qsTr("Play")
+                iconSource: controller.playing ? "qrc:/icons/cancel.svg" : "qrc:/icons/right.svg"
+                onClicked: controller.playing ? controller.pause() : controller.play()
+            }
+
+            Controls.Slider {
+                from: 0
+                to: controller.duration
+                value: controller.time
+                onMoved: controller.time = value
+                Layout.fillWidth: true
+            }
+
+            Controls.Label {
+                text: timeText(controller.time) + " / " + timeText(controller.duration)
+            }
+
+            Controls.ComboBox {
+                flat: true
+                model: [ 1, 2, 4, 8, 16 ]
+                displayText: "x" + controller.rate
+                onActivated: controller.rate = model[index]
+                Layout.preferredWidth: Controls.Theme.baseSize * 2
+            }
+        }
+    }
+}
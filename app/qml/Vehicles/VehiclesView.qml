@@ -94,4 +94,11 @@ ColumnLayout {
         Layout.preferredWidth: root.width
         selectedVehicle: root.selectedVehicle
     }
+
+    LogPlaybackView {
+        visible: maximized
+        topCropped: true
+        Layout.preferredWidth: root.width
+        selectedVehicle: root.selectedVehicle
+    }
 }
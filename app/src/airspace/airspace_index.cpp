@@ -0,0 +1,168 @@
+#include "airspace_index.h"
+
+#include <QPair>
+#include <QVarLengthArray>
+#include <QtMath>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace md::domain;
+
+void AirspaceIndex::build(const QVector<AirspaceVolume>& volumes)
+{
+    m_volumes = volumes;
+    m_xs.clear();
+    m_ys.clear();
+    m_ringOffsets.clear();
+    m_boxes.clear();
+    m_levelOffsets.clear();
+    m_leafVolumes.clear();
+
+    QVector<Box> volumeBoxes;
+    volumeBoxes.reserve(m_volumes.count());
+    m_ringOffsets.reserve(m_volumes.count() + 1);
+    for (const AirspaceVolume& volume : qAsConst(m_volumes))
+    {
+        m_ringOffsets.append(m_xs.count());
+
+        Box box = { qInf(), qInf(), -qInf(), -qInf() };
+        for (const QPointF& point : volume.boundary)
+        {
+            m_xs.append(point.x());
+            m_ys.append(point.y());
+            box = { qMin(box.minX, point.x()), qMin(box.minY, point.y()),
+                    qMax(box.maxX, point.x()), qMax(box.maxY, point.y()) };
+        }
+        if (!volume.boundary.isEmpty())
+        {
+            m_xs.append(volume.boundary.first().x());
+            m_ys.append(volume.boundary.first().y());
+        }
+        volumeBoxes.append(box);
+    }
+    m_ringOffsets.append(m_xs.count());
+
+    const int count = m_volumes.count();
+    if (!count)
+        return;
+
+    // STR: sort by x, cut into vertical slices, sort every slice by y
+    m_leafVolumes.resize(count);
+    std::iota(m_leafVolumes.begin(), m_leafVolumes.end(), 0);
+    auto centerX = [&](int i) { return volumeBoxes.at(i).minX + volumeBoxes.at(i).maxX; };
+    auto centerY = [&](int i) { return volumeBoxes.at(i).minY + volumeBoxes.at(i).maxY; };
+
+    std::sort(m_leafVolumes.begin(), m_leafVolumes.end(),
+              [&](int a, int b) { return centerX(a) < centerX(b); });
+
+    const int leafNodes = (count + nodeCapacity - 1) / nodeCapacity;
+    const int sliceSize = qCeil(qSqrt(leafNodes)) * nodeCapacity;
+    for (int slice = 0; slice < count; slice += sliceSize)
+    {
+        std::sort(m_leafVolumes.begin() + slice,
+                  m_leafVolumes.begin() + qMin(slice + sliceSize, count),
+                  [&](int a, int b) { return centerY(a) < centerY(b); });
+    }
+
+    m_boxes.reserve(count * 2);
+    for (int volume : qAsConst(m_leafVolumes))
+    {
+        m_boxes.append(volumeBoxes.at(volume));
+    }
+
+    // Upper levels group consecutive nodes, which are already spatially sorted
+    m_levelOffsets.append(0);
+    int levelBegin = 0;
+    int levelEnd = count;
+    while (levelEnd - levelBegin > 1)
+    {
+        m_levelOffsets.append(levelEnd);
+        for (int i = levelBegin; i < levelEnd; i += nodeCapacity)
+        {
+            Box box = m_boxes.at(i);
+            for (int child = i + 1; child < qMin(i + nodeCapacity, levelEnd); ++child)
+            {
+                const Box& childBox = m_boxes.at(child);
+                box = { qMin(box.minX, childBox.minX), qMin(box.minY, childBox.minY),
+                        qMax(box.maxX, childBox.maxX), qMax(box.maxY, childBox.maxY) };
+            }
+            m_boxes.append(box);
+        }
+        levelBegin = levelEnd;
+        levelEnd = m_boxes.count();
+    }
+}
+
+int AirspaceIndex::count() const
+{
+    return m_volumes.count();
+}
+
+const AirspaceVolume& AirspaceIndex::volume(int index) const
+{
+    return m_volumes.at(index);
+}
+
+QVector<int> AirspaceIndex::query(double latitude, double longitude, double altitude) const
+{
+    QVector<int> result;
+    if (m_boxes.isEmpty())
+        return result;
+
+    const double x = longitude;
+    const double y = latitude;
+
+    // Pairs of level and box index inside the level
+    QVarLengthArray<QPair<int, int>, 64> stack;
+    const int rootLevel = m_levelOffsets.count() - 1;
+    stack.append({ rootLevel, m_boxes.count() - 1 - m_levelOffsets.at(rootLevel) });
+
+    while (!stack.isEmpty())
+    {
+        const QPair<int, int> node = stack.takeLast();
+        const int level = node.first;
+        const int offset = m_levelOffsets.at(level);
+        if (!m_boxes.at(offset + node.second).contains(x, y))
+            continue;
+
+        if (level == 0)
+        {
+            const int volume = m_leafVolumes.at(node.second);
+            const AirspaceVolume& airspace = m_volumes.at(volume);
+            if (altitude >= airspace.floor && altitude <= airspace.ceiling &&
+                this->contains(volume, x, y))
+                result.append(volume);
+            continue;
+        }
+
+        const int childLevelSize = m_levelOffsets.at(level) - m_levelOffsets.at(level - 1);
+        const int firstChild = node.second * nodeCapacity;
+        for (int child = firstChild; child < qMin(firstChild + nodeCapacity, childLevelSize);
+             ++child)
+        {
+            stack.append({ level - 1, child });
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool AirspaceIndex::contains(int volume, double x, double y) const
+{
+    const int begin = m_ringOffsets.at(volume);
+    const int end = m_ringOffsets.at(volume + 1);
+    const double* xs = m_xs.constData();
+    const double* ys = m_ys.constData();
+
+    // Crossing number without branches, so the loop vectorises
+    int crossings = 0;
+    for (int i = begin; i < end - 1; ++i)
+    {
+        const bool spans = (ys[i] > y) != (ys[i + 1] > y);
+        const double crossX = xs[i] + (xs[i + 1] - xs[i]) * (y - ys[i]) / (ys[i + 1] - ys[i]);
+        crossings += spans & (x < crossX);
+    }
+    return crossings & 1;
+}
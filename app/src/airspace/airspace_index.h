@@ -0,0 +1,66 @@
+#ifndef AIRSPACE_INDEX_H
+#define AIRSPACE_INDEX_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include <limits>
+
+namespace md::domain
+{
+struct AirspaceVolume
+{
+    QString id;
+    QString name;
+    bool inclusion = false; // Geofence to stay inside, otherwise a volume to stay out of
+    double floor = -std::numeric_limits<double>::infinity();
+    double ceiling = std::numeric_limits<double>::infinity();
+    QVector<QPointF> boundary; // x is longitude, y is latitude
+};
+
+// Static packed R-tree over volume bounding boxes, built with Sort-Tile-Recursive
+class AirspaceIndex
+{
+public:
+    static constexpr int nodeCapacity = 16;
+
+    void build(const QVector<AirspaceVolume>& volumes);
+
+    int count() const;
+    const AirspaceVolume& volume(int index) const;
+
+    // Indices of volumes containing the point
+    QVector<int> query(double latitude, double longitude, double altitude) const;
+
+private:
+    struct Box
+    {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+
+        bool contains(double x, double y) const
+        {
+            return x >= minX && x <= maxX && y >= minY && y <= maxY;
+        }
+    };
+
+    bool contains(int volume, double x, double y) const;
+
+    QVector<AirspaceVolume> m_volumes;
+
+    // Closed rings of all volumes in contiguous arrays
+    QVector<double> m_xs;
+    QVector<double> m_ys;
+    QVector<int> m_ringOffsets;
+
+    // Tree levels are stored leaves first, the root is the last box
+    QVector<Box> m_boxes;
+    QVector<int> m_levelOffsets;
+    QVector<int> m_leafVolumes;
+};
+} // namespace md::domain
+
+#endif // AIRSPACE_INDEX_H
@@ -0,0 +1,158 @@
+#include "airspace_service.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+constexpr char volumes[] = "volumes";
+constexpr char id[] = "id";
+constexpr char name[] = "name";
+constexpr char inclusion[] = "inclusion";
+constexpr char floor[] = "floor";
+constexpr char ceiling[] = "ceiling";
+constexpr char boundary[] = "boundary";
+constexpr char latitude[] = "latitude";
+constexpr char longitude[] = "longitude";
+constexpr char altitudeAmsl[] = "altitudeAmsl";
+
+constexpr char airspaces[] = "airspaces";
+constexpr char geofenceBreach[] = "geofenceBreach";
+} // namespace
+
+using namespace md::domain;
+
+AirspaceService::AirspaceService(IPropertyTree* pTree, TrafficService* traffic,
+                                 const QString& path, QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree)
+{
+    this->load(path);
+
+    connect(m_pTree, &IPropertyTree::propertiesChanged, this,
+            &AirspaceService::onPropertiesChanged);
+    connect(traffic, &TrafficService::trafficUpdated, this, &AirspaceService::onTrafficUpdated);
+    connect(traffic, &TrafficService::trafficRemoved, this, &AirspaceService::onTrafficRemoved);
+}
+
+const AirspaceIndex& AirspaceService::index() const
+{
+    return m_index;
+}
+
+void AirspaceService::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Airspace file is not available:" << path;
+        m_index.build({});
+        return;
+    }
+
+    const QJsonArray items = QJsonDocument::fromJson(file.readAll())
+                                 .object()
+                                 .value(::volumes)
+                                 .toArray();
+
+    QVector<AirspaceVolume> volumes;
+    volumes.reserve(items.count());
+    m_hasInclusions = false;
+    for (const QJsonValue& item : items)
+    {
+        const QJsonObject object = item.toObject();
+
+        AirspaceVolume volume;
+        volume.id = object.value(::id).toVariant().toString();
+        volume.name = object.value(::name).toString(volume.id);
+        volume.inclusion = object.value(::inclusion).toBool();
+        volume.floor = object.value(::floor).toDouble(volume.floor);
+        volume.ceiling = object.value(::ceiling).toDouble(volume.ceiling);
+        for (const QJsonValue& point : object.value(::boundary).toArray())
+        {
+            volume.boundary.append(QPointF(point.toObject().value(::longitude).toDouble(),
+                                           point.toObject().value(::latitude).toDouble()));
+        }
+
+        if (volume.boundary.count() < 3)
+            continue;
+
+        m_hasInclusions |= volume.inclusion;
+        volumes.append(volume);
+    }
+
+    m_index.build(volumes);
+    m_vehicleResults.clear();
+    m_trafficResults.clear();
+    qInfo() << "Airspace volumes loaded:" << m_index.count();
+}
+
+void AirspaceService::onPropertiesChanged(const QString& nodeId, const QVariantMap& properties)
+{
+    if (!properties.contains(::latitude) && !properties.contains(::longitude))
+        return;
+
+    const QVariantMap telemetry = m_pTree->properties(nodeId);
+    if (!telemetry.contains(::latitude) || !telemetry.contains(::longitude))
+        return;
+
+    const bool changed = this->check(nodeId, telemetry.value(::latitude).toDouble(),
+                                     telemetry.value(::longitude).toDouble(),
+                                     telemetry.value(::altitudeAmsl).toDouble(),
+                                     m_vehicleResults);
+    if (!changed)
+        return;
+
+    // Published properties have no position, so they do not trigger a new check
+    const Result result = m_vehicleResults.value(nodeId);
+    m_pTree->appendProperties(nodeId, { { ::airspaces, result.volumeIds },
+                                        { ::geofenceBreach, result.breach } });
+    emit airspacesChanged(nodeId, result.volumeIds, result.breach);
+}
+
+void AirspaceService::onTrafficUpdated(const QVector<TrafficState>& states)
+{
+    for (const TrafficState& state : states)
+    {
+        if (!this->check(state.code, state.latitude, state.longitude, state.altitude,
+                         m_trafficResults))
+            continue;
+
+        const Result result = m_trafficResults.value(state.code);
+        emit airspacesChanged(state.code, result.volumeIds, result.breach);
+    }
+}
+
+void AirspaceService::onTrafficRemoved(const QStringList& codes)
+{
+    for (const QString& code : codes)
+    {
+        m_trafficResults.remove(code);
+    }
+}
+
+bool AirspaceService::check(const QString& objectId, double latitude, double longitude,
+                            double altitude, QHash<QString, Result>& results)
+{
+    Result result;
+    bool insideInclusion = false;
+    bool insideExclusion = false;
+    for (int index : m_index.query(latitude, longitude, altitude))
+    {
+        const AirspaceVolume& volume = m_index.volume(index);
+        result.volumeIds.append(volume.id);
+        insideInclusion |= volume.inclusion;
+        insideExclusion |= !volume.inclusion;
+    }
+    result.breach = insideExclusion || (m_hasInclusions && !insideInclusion);
+
+    auto it = results.find(objectId);
+    if (it != results.end() && *it == result)
+        return false;
+
+    results.insert(objectId, result);
+    return true;
+}
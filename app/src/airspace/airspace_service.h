@@ -0,0 +1,58 @@
+#ifndef AIRSPACE_SERVICE_H
+#define AIRSPACE_SERVICE_H
+
+#include "airspace_index.h"
+#include "i_property_tree.h"
+#include "traffic_service.h"
+
+#include <QHash>
+
+namespace md::domain
+{
+// Checks vehicles and traffic against geofences and airspaces loaded from a file
+class AirspaceService : public QObject
+{
+    Q_OBJECT
+
+public:
+    AirspaceService(IPropertyTree* pTree, TrafficService* traffic, const QString& path,
+                    QObject* parent = nullptr);
+
+    const AirspaceIndex& index() const;
+
+public slots:
+    void load(const QString& path);
+
+signals:
+    // Object is a vehicle id or a traffic code
+    void airspacesChanged(const QString& objectId, const QStringList& volumeIds, bool breach);
+
+private:
+    void onPropertiesChanged(const QString& nodeId, const QVariantMap& properties);
+    void onTrafficUpdated(const QVector<TrafficState>& states);
+    void onTrafficRemoved(const QStringList& codes);
+
+    struct Result
+    {
+        QStringList volumeIds;
+        bool breach = false;
+
+        bool operator==(const Result& other) const
+        {
+            return breach == other.breach && volumeIds == other.volumeIds;
+        }
+    };
+
+    // False if the result has not changed since the last check
+    bool check(const QString& objectId, double latitude, double longitude, double altitude,
+               QHash<QString, Result>& results);
+
+    IPropertyTree* const m_pTree;
+    AirspaceIndex m_index;
+    bool m_hasInclusions = false;
+    QHash<QString, Result> m_vehicleResults;
+    QHash<QString, Result> m_trafficResults;
+};
+} // namespace md::domain
+
+#endif // AIRSPACE_SERVICE_H
@@ -0,0 +1,264 @@
+#include "command_pipeline.h"
+
+#include <QDebug>
+#include <QSet>
+
+namespace
+{
+// MAV_RESULT values of COMMAND_ACK
+constexpr int mavResultAccepted = 0;
+constexpr int mavResultInProgress = 5;
+constexpr int mavResultCancelled = 6;
+} // namespace
+
+using namespace md::domain;
+
+CommandPipeline::CommandPipeline(ICommandsService* commands, TimerWheel* timers,
+                                 QObject* parent) :
+    QObject(parent),
+    m_commands(commands),
+    m_timers(timers)
+{
+}
+
+CommandPipeline::~CommandPipeline()
+{
+    for (const Request& request : qAsConst(m_requests))
+    {
+        m_timers->cancel(request.timer);
+    }
+}
+
+int CommandPipeline::send(const QVariant& vehicleId, const QString& commandId,
+                          const QVariantList& args)
+{
+    return this->broadcast({ vehicleId }, commandId, args);
+}
+
+int CommandPipeline::broadcast(const QVariantList& vehicleIds, const QString& commandId,
+                               const QVariantList& args)
+{
+    const int handle = ++m_lastHandle;
+    Batch& batch = m_batches[handle];
+
+    if (m_remote)
+    {
+        for (const QVariant& vehicleId : vehicleIds)
+        {
+            batch.results.insert(vehicleId.toString(), Pending);
+        }
+        batch.pending = batch.results.count();
+        m_remote(handle, vehicleIds, commandId, args);
+        return handle;
+    }
+
+    Command* command = this->command(commandId);
+    for (const QVariant& vehicleId : vehicleIds)
+    {
+        batch.results.insert(vehicleId.toString(), command ? Pending : Rejected);
+    }
+
+    if (!command || vehicleIds.isEmpty())
+    {
+        qWarning() << "Can't send command" << commandId;
+        this->finishLater(handle, false);
+        return handle;
+    }
+
+    if (!m_ackTracking)
+    {
+        QSet<QString> sent;
+        for (const QVariant& vehicleId : vehicleIds)
+        {
+            if (sent.contains(vehicleId.toString()))
+                continue;
+
+            sent.insert(vehicleId.toString());
+            emit command->exec(vehicleId, args);
+        }
+        this->finishLater(handle, false);
+        return handle;
+    }
+
+    for (const QVariant& vehicleId : vehicleIds)
+    {
+        // A newer command of the same kind supersedes the one awaiting ack
+        const QString key = requestKey(vehicleId, commandId);
+        if (m_requests.contains(key))
+        {
+            if (m_requests.value(key).handle == handle) // Listed twice
+                continue;
+
+            this->complete(key, Canceled);
+        }
+
+        m_batches[handle].pending++;
+        Request& request = m_requests[key];
+        request = { handle, vehicleId, commandId, args };
+        this->transmit(request);
+    }
+    return handle;
+}
+
+void CommandPipeline::cancel(int handle)
+{
+    if (m_remote)
+    {
+        QVariantMap results = m_batches.value(handle).results;
+        for (QVariant& result : results)
+        {
+            if (result.toInt() == Pending)
+                result = Canceled;
+        }
+        this->finishRemote(handle, false, results);
+        return;
+    }
+
+    // The vehicle may still execute it, only the ack is no longer awaited
+    for (const QString& key : m_requests.keys())
+    {
+        if (m_requests.value(key).handle == handle)
+            this->complete(key, Canceled);
+    }
+}
+
+bool CommandPipeline::isPending(int handle) const
+{
+    return m_batches.contains(handle);
+}
+
+QVariantMap CommandPipeline::results(int handle) const
+{
+    return m_batches.value(handle).results;
+}
+
+void CommandPipeline::setRemote(Remote remote)
+{
+    m_remote = std::move(remote);
+}
+
+bool CommandPipeline::isAckTracking() const
+{
+    return m_ackTracking;
+}
+
+void CommandPipeline::setAckTracking(bool ackTracking)
+{
+    // Commands already awaiting acks still end by ack or timeout
+    m_ackTracking = ackTracking;
+}
+
+void CommandPipeline::acknowledge(const QVariant& vehicleId, const QString& commandId,
+                                  int mavResult)
+{
+    const QString key = requestKey(vehicleId, commandId);
+    auto it = m_requests.find(key);
+    if (it == m_requests.end())
+        return;
+
+    switch (mavResult)
+    {
+    case ::mavResultInProgress:
+        m_timers->restart(it->timer, inProgressTimeout);
+        break;
+    case ::mavResultAccepted:
+        this->complete(key, Accepted);
+        break;
+    case ::mavResultCancelled:
+        this->complete(key, Canceled);
+        break;
+    default:
+        this->complete(key, Rejected);
+        break;
+    }
+}
+
+void CommandPipeline::finishRemote(int handle, bool accepted, const QVariantMap& results)
+{
+    if (!m_batches.remove(handle))
+        return;
+
+    emit finished(handle, accepted, results);
+}
+
+Command* CommandPipeline::command(const QString& commandId)
+{
+    auto it = m_commandCache.constFind(commandId);
+    if (it != m_commandCache.constEnd())
+        return it.value();
+
+    Command* command = m_commands->requestCommand(commandId);
+    if (command)
+        m_commandCache.insert(commandId, command);
+    return command;
+}
+
+void CommandPipeline::transmit(Request& request)
+{
+    request.attempts++;
+    if (!m_timers->restart(request.timer, ackTimeout))
+    {
+        const QString key = requestKey(request.vehicleId, request.commandId);
+        request.timer = m_timers->schedule(ackTimeout, [this, key]() {
+            this->onTimeout(key);
+        });
+    }
+
+    emit m_commandCache.value(request.commandId)->exec(request.vehicleId, request.args);
+}
+
+void CommandPipeline::complete(const QString& key, Result result)
+{
+    const Request request = m_requests.take(key);
+    m_timers->cancel(request.timer);
+
+    auto batch = m_batches.find(request.handle);
+    if (batch == m_batches.end())
+        return;
+
+    batch->results.insert(request.vehicleId.toString(), result);
+    if (--batch->pending > 0)
+        return;
+
+    bool accepted = true;
+    for (const QVariant& vehicleResult : qAsConst(batch->results))
+    {
+        accepted &= vehicleResult.toInt() == Accepted;
+    }
+
+    const QVariantMap results = batch->results;
+    m_batches.erase(batch);
+    emit finished(request.handle, accepted, results);
+}
+
+void CommandPipeline::onTimeout(const QString& key)
+{
+    auto it = m_requests.find(key);
+    if (it == m_requests.end())
+        return;
+
+    // The fired timer is gone, a resend schedules a new one
+    it->timer = 0;
+    if (it->attempts < maxAttempts)
+        this->transmit(*it);
+    else
+        this->complete(key, Timeout);
+}
+
+void CommandPipeline::finishLater(int handle, bool accepted)
+{
+    const QVariantMap results = m_batches.take(handle).results;
+
+    // Report after the caller got its handle
+    QMetaObject::invokeMethod(
+        this,
+        [this, handle, accepted, results]() {
+            emit finished(handle, accepted, results);
+        },
+        Qt::QueuedConnection);
+}
+
+QString CommandPipeline::requestKey(const QVariant& vehicleId, const QString& commandId)
+{
+    return vehicleId.toString() + '/' + commandId;
+}
@@ -0,0 +1,101 @@
+#ifndef COMMAND_PIPELINE_H
+#define COMMAND_PIPELINE_H
+
+#include "i_command_service.h"
+#include "timer_wheel.h"
+
+#include <QHash>
+#include <functional>
+
+namespace md::domain
+{
+// Sends commands to one or many vehicles and tracks their COMMAND_ACK with timeouts and retries
+class CommandPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Result
+    {
+        Pending,
+        Accepted,
+        Rejected,
+        Timeout,
+        Canceled
+    };
+    Q_ENUM(Result)
+
+    static constexpr int ackTimeout = 1500;
+    static constexpr int inProgressTimeout = 5000;
+    static constexpr int maxAttempts = 3;
+
+    using Remote = std::function<void(int handle, const QVariantList& vehicleIds,
+                                      const QString& commandId, const QVariantList& args)>;
+
+    CommandPipeline(ICommandsService* commands, TimerWheel* timers, QObject* parent = nullptr);
+    ~CommandPipeline() override;
+
+    // Returns a handle, finished is emitted once every vehicle has acked or given up,
+    // or right after sending without ack tracking
+    int send(const QVariant& vehicleId, const QString& commandId, const QVariantList& args);
+    int broadcast(const QVariantList& vehicleIds, const QString& commandId,
+                  const QVariantList& args);
+    void cancel(int handle);
+
+    bool isPending(int handle) const;
+    QVariantMap results(int handle) const; // Result by vehicle id
+
+    // Hands batches over to another pipeline, e.g. the one of a headless core
+    void setRemote(Remote remote);
+
+    // Set by a link module that reports acks. Without it commands are sent once and their
+    // results stay Pending, since no ack would ever stop the retries.
+    bool isAckTracking() const;
+    void setAckTracking(bool ackTracking);
+
+public slots:
+    // MAV_RESULT of the COMMAND_ACK, reported by the link module
+    void acknowledge(const QVariant& vehicleId, const QString& commandId, int mavResult);
+    // Outcome of a batch handed over to the remote pipeline
+    void finishRemote(int handle, bool accepted, const QVariantMap& results);
+
+signals:
+    void finished(int handle, bool accepted, QVariantMap results);
+
+private:
+    struct Request
+    {
+        int handle;
+        QVariant vehicleId;
+        QString commandId;
+        QVariantList args;
+        int attempts = 0;
+        TimerWheel::TimerId timer = 0;
+    };
+
+    struct Batch
+    {
+        QVariantMap results;
+        int pending = 0;
+    };
+
+    Command* command(const QString& commandId);
+    void transmit(Request& request);
+    void complete(const QString& key, Result result);
+    void onTimeout(const QString& key);
+    void finishLater(int handle, bool accepted);
+
+    static QString requestKey(const QVariant& vehicleId, const QString& commandId);
+
+    ICommandsService* const m_commands;
+    TimerWheel* const m_timers;
+    QHash<QString, Command*> m_commandCache;
+    QHash<QString, Request> m_requests; // Awaiting ack by vehicle and command
+    QHash<int, Batch> m_batches;
+    Remote m_remote;
+    bool m_ackTracking = false;
+    int m_lastHandle = 0;
+};
+} // namespace md::domain
+
+#endif // COMMAND_PIPELINE_H
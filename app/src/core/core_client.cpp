@@ -0,0 +1,260 @@
+#include "core_client.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+constexpr char type[] = "type";
+constexpr char properties[] = "properties";
+constexpr char nodes[] = "nodes";
+constexpr char command[] = "command";
+constexpr char ack[] = "ack";
+constexpr char requestId[] = "requestId";
+constexpr char vehicleIds[] = "vehicleIds";
+constexpr char commandId[] = "commandId";
+constexpr char args[] = "args";
+constexpr char accepted[] = "accepted";
+constexpr char results[] = "results";
+constexpr char view[] = "view";
+constexpr char selectedVehicle[] = "selectedVehicle";
+constexpr char tracking[] = "tracking";
+constexpr char center[] = "center";
+constexpr char camera[] = "camera";
+constexpr char mission[] = "mission";
+constexpr char missionCancel[] = "missionCancel";
+constexpr char operation[] = "operation";
+constexpr char missionId[] = "missionId";
+constexpr char operationType[] = "operationType";
+constexpr char progress[] = "progress";
+constexpr char total[] = "total";
+constexpr char state[] = "state";
+} // namespace
+
+using namespace md::app;
+
+CoreClient::CoreClient(domain::IPropertyTree* pTree, domain::CommandPipeline* commands,
+                       domain::IMissionsService* missions, domain::TelemetryRateService* rates,
+                       QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree),
+    m_commands(commands),
+    m_missions(missions),
+    m_rates(rates)
+{
+    m_commands->setRemote([this](int handle, const QVariantList& vehicleIds,
+                                 const QString& commandId, const QVariantList& args) {
+        this->sendCommand(handle, vehicleIds, commandId, args);
+    });
+
+    connect(&m_socket, &QLocalSocket::readyRead, this, &CoreClient::read);
+    connect(&m_socket, &QLocalSocket::connected, this, [this]() {
+        this->sendView();
+        emit attachedChanged(true);
+    });
+    connect(&m_socket, &QLocalSocket::disconnected, this, &CoreClient::onDisconnected);
+
+    const auto onError = [this]() {
+        if (m_socket.state() == QLocalSocket::UnconnectedState)
+            m_reconnectTimer.start();
+    };
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    connect(&m_socket, &QLocalSocket::errorOccurred, this, onError);
+#else
+    connect(&m_socket, QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error), this,
+            onError);
+#endif
+
+    // Camera moves come at the frame rate, the core gets the latest view a few times a second
+    m_viewTimer.setInterval(viewInterval);
+    m_viewTimer.setSingleShot(true);
+    connect(&m_viewTimer, &QTimer::timeout, this, &CoreClient::sendView);
+    connect(m_rates, &domain::TelemetryRateService::viewChanged, this, [this]() {
+        if (!m_viewTimer.isActive())
+            m_viewTimer.start();
+    });
+
+    connect(m_missions, &domain::IMissionsService::operationStarted, this,
+            &CoreClient::onOperationStarted);
+    connect(m_missions, &domain::IMissionsService::operationEnded, this,
+            &CoreClient::onOperationEnded);
+
+    // The core may start later or be restarted under the GUI
+    m_reconnectTimer.setInterval(reconnectInterval);
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, [this]() {
+        m_socket.connectToServer(m_name);
+    });
+}
+
+CoreClient::~CoreClient()
+{
+    m_commands->setRemote(nullptr);
+    m_socket.disconnect(this);
+}
+
+bool CoreClient::isAttached() const
+{
+    return m_socket.state() == QLocalSocket::ConnectedState;
+}
+
+void CoreClient::attach(const QString& name)
+{
+    m_name = name;
+    m_socket.abort();
+    m_socket.connectToServer(m_name);
+}
+
+void CoreClient::sendCommand(int handle, const QVariantList& vehicleIds, const QString& commandId,
+                             const QVariantList& args)
+{
+    if (!this->isAttached())
+    {
+        qWarning() << "Can't send command" << commandId << ", core is not attached";
+        // Report after the caller got its handle
+        QMetaObject::invokeMethod(
+            m_commands,
+            [this, handle]() {
+                m_commands->finishRemote(handle, false, m_commands->results(handle));
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    const QJsonObject json({ { ::type, ::command },
+                             { ::requestId, handle },
+                             { ::vehicleIds, QJsonArray::fromVariantList(vehicleIds) },
+                             { ::commandId, commandId },
+                             { ::args, QJsonArray::fromVariantList(args) } });
+    m_socket.write(QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+    m_pendingCommands.insert(handle);
+}
+
+void CoreClient::sendView()
+{
+    if (!this->isAttached())
+        return;
+
+    const QJsonObject json(
+        { { ::type, ::view },
+          { ::selectedVehicle, QJsonValue::fromVariant(m_rates->selectedVehicle()) },
+          { ::tracking, m_rates->isTracking() },
+          { ::center, QJsonObject::fromVariantMap(m_rates->viewCenter().toVariantMap()) },
+          { ::camera, QJsonObject::fromVariantMap(m_rates->viewCamera().toVariantMap()) } });
+    m_socket.write(QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void CoreClient::onOperationStarted(domain::MissionOperation* operation)
+{
+    domain::Mission* mission = operation->mission();
+    if (!this->isAttached())
+    {
+        qWarning() << "Can't start mission operation, core is not attached";
+        QMetaObject::invokeMethod(
+            this,
+            [this, operation]() {
+                m_missions->endOperation(operation, domain::MissionOperation::Canceled);
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    // Edits are already saved, the core reads the mission by its id
+    const QJsonObject json({ { ::type, ::mission },
+                             { ::missionId, QJsonValue::fromVariant(mission->id()) },
+                             { ::operationType, int(operation->type()) } });
+    m_socket.write(QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+    m_operations.insert(mission->id().toString(), operation);
+}
+
+void CoreClient::onOperationEnded(domain::MissionOperation* operation)
+{
+    // Canceled in the GUI, the core still runs it
+    const QVariant missionId = operation->mission()->id();
+    if (m_operations.value(missionId.toString()) != operation)
+        return;
+
+    m_operations.remove(missionId.toString());
+    const QJsonObject json({ { ::type, ::missionCancel },
+                             { ::missionId, QJsonValue::fromVariant(missionId) } });
+    m_socket.write(QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void CoreClient::updateOperation(const QJsonObject& json)
+{
+    const QString missionId = json.value(::missionId).toVariant().toString();
+    domain::MissionOperation* operation = m_operations.value(missionId);
+    if (!operation)
+        return;
+
+    if (json.contains(::progress))
+    {
+        operation->progress.set(json.value(::progress).toInt());
+        operation->total.set(json.value(::total).toInt());
+    }
+    if (!json.contains(::state))
+        return;
+
+    // Taken out first, so the end is not sent back as a cancel
+    m_operations.remove(missionId);
+    const auto state = domain::MissionOperation::State(json.value(::state).toInt());
+    if (state == domain::MissionOperation::Succeeded &&
+        operation->type() == domain::MissionOperation::Download)
+        m_missions->restoreMission(operation->mission());
+
+    m_missions->endOperation(operation, state);
+}
+
+void CoreClient::read()
+{
+    while (m_socket.canReadLine())
+    {
+        const QJsonObject json = QJsonDocument::fromJson(m_socket.readLine()).object();
+        const QString messageType = json.value(::type).toString();
+
+        if (messageType == ::properties)
+        {
+            const QJsonObject nodes = json.value(::nodes).toObject();
+            for (auto it = nodes.constBegin(); it != nodes.constEnd(); ++it)
+            {
+                m_pTree->appendProperties(it.key(), it.value().toObject().toVariantMap());
+            }
+        }
+        else if (messageType == ::ack)
+        {
+            const int handle = json.value(::requestId).toInt();
+            if (m_pendingCommands.remove(handle))
+                m_commands->finishRemote(handle, json.value(::accepted).toBool(),
+                                         json.value(::results).toObject().toVariantMap());
+        }
+        else if (messageType == ::operation)
+        {
+            this->updateOperation(json);
+        }
+    }
+}
+
+void CoreClient::onDisconnected()
+{
+    emit attachedChanged(false);
+
+    // Acks of the lost core will never come
+    const QSet<int> pendingCommands = m_pendingCommands;
+    m_pendingCommands.clear();
+    for (int handle : pendingCommands)
+    {
+        m_commands->finishRemote(handle, false, m_commands->results(handle));
+    }
+
+    // So are the ends of mission operations
+    const QList<domain::MissionOperation*> operations = m_operations.values();
+    m_operations.clear();
+    for (domain::MissionOperation* operation : operations)
+    {
+        m_missions->endOperation(operation, domain::MissionOperation::Canceled);
+    }
+
+    m_reconnectTimer.start();
+}
@@ -0,0 +1,64 @@
+#ifndef CORE_CLIENT_H
+#define CORE_CLIENT_H
+
+#include "command_pipeline.h"
+#include "i_missions_service.h"
+#include "i_property_tree.h"
+#include "telemetry_rate_service.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QSet>
+#include <QTimer>
+
+namespace md::app
+{
+// Attaches the GUI to a headless core, mirrors its telemetry and hands commands, mission
+// operations and the view for telemetry rates over to it. Operations go by mission id, the core
+// reads the mission from the shared database and runs them on its links.
+class CoreClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int reconnectInterval = 1000;
+    static constexpr int viewInterval = 200;
+
+    CoreClient(domain::IPropertyTree* pTree, domain::CommandPipeline* commands,
+               domain::IMissionsService* missions, domain::TelemetryRateService* rates,
+               QObject* parent = nullptr);
+    ~CoreClient() override;
+
+    bool isAttached() const;
+
+public slots:
+    void attach(const QString& name);
+
+signals:
+    void attachedChanged(bool attached);
+
+private:
+    void sendCommand(int handle, const QVariantList& vehicleIds, const QString& commandId,
+                     const QVariantList& args);
+    void sendView();
+    void onOperationStarted(domain::MissionOperation* operation);
+    void onOperationEnded(domain::MissionOperation* operation);
+    void updateOperation(const QJsonObject& json);
+    void read();
+    void onDisconnected();
+
+    domain::IPropertyTree* const m_pTree;
+    domain::CommandPipeline* const m_commands;
+    domain::IMissionsService* const m_missions;
+    domain::TelemetryRateService* const m_rates;
+    QLocalSocket m_socket;
+    QTimer m_reconnectTimer;
+    QTimer m_viewTimer;
+    QString m_name;
+    QSet<int> m_pendingCommands;
+    QHash<QString, domain::MissionOperation*> m_operations; // Running in the core, by mission id
+};
+} // namespace md::app
+
+#endif // CORE_CLIENT_H
@@ -0,0 +1,297 @@
+#include "core_server.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+constexpr char type[] = "type";
+constexpr char properties[] = "properties";
+constexpr char nodes[] = "nodes";
+constexpr char command[] = "command";
+constexpr char ack[] = "ack";
+constexpr char requestId[] = "requestId";
+constexpr char vehicleIds[] = "vehicleIds";
+constexpr char commandId[] = "commandId";
+constexpr char args[] = "args";
+constexpr char accepted[] = "accepted";
+constexpr char results[] = "results";
+constexpr char view[] = "view";
+constexpr char selectedVehicle[] = "selectedVehicle";
+constexpr char tracking[] = "tracking";
+constexpr char center[] = "center";
+constexpr char camera[] = "camera";
+constexpr char mission[] = "mission";
+constexpr char missionCancel[] = "missionCancel";
+constexpr char operation[] = "operation";
+constexpr char missionId[] = "missionId";
+constexpr char operationType[] = "operationType";
+constexpr char progress[] = "progress";
+constexpr char total[] = "total";
+constexpr char state[] = "state";
+
+QByteArray propertiesMessage(const QHash<QString, QVariantMap>& nodes)
+{
+    QJsonObject json;
+    for (auto it = nodes.constBegin(); it != nodes.constEnd(); ++it)
+    {
+        json.insert(it.key(), QJsonObject::fromVariantMap(it.value()));
+    }
+    return QJsonDocument(QJsonObject({ { ::type, ::properties }, { ::nodes, json } }))
+               .toJson(QJsonDocument::Compact) +
+           '\n';
+}
+} // namespace
+
+using namespace md::app;
+
+CoreServer::CoreServer(domain::IPropertyTree* pTree, domain::CommandPipeline* commands,
+                       domain::TelemetryRateService* rates, domain::IVehiclesService* vehicles,
+                       domain::MissionsService* missions, QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree),
+    m_commands(commands),
+    m_rates(rates),
+    m_vehicles(vehicles),
+    m_missions(missions)
+{
+    connect(m_pTree, &domain::IPropertyTree::propertiesChanged, this,
+            &CoreServer::onPropertiesChanged);
+    connect(m_commands, &domain::CommandPipeline::finished, this,
+            &CoreServer::onCommandFinished);
+    connect(m_missions, &domain::IMissionsService::operationStarted, this,
+            &CoreServer::onOperationStarted);
+    connect(m_missions, &domain::IMissionsService::operationEnded, this,
+            &CoreServer::onOperationEnded);
+    connect(&m_server, &QLocalServer::newConnection, this, &CoreServer::onNewConnection);
+
+    // Attaching GUIs must not get nodes of vehicles that are gone
+    connect(m_vehicles, &domain::IVehiclesService::vehicleRemoved, this,
+            [this](domain::Vehicle* vehicle) {
+                m_nodes.remove(vehicle->id().toString());
+                m_pending.remove(vehicle->id().toString());
+            });
+
+    // Telemetry comes in bursts of small changes, clients get them merged
+    m_flushTimer.setInterval(flushInterval);
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &CoreServer::flush);
+}
+
+CoreServer::~CoreServer()
+{
+    for (QLocalSocket* client : qAsConst(m_clients))
+    {
+        client->disconnect(this);
+    }
+}
+
+bool CoreServer::listen(const QString& name)
+{
+    // A crashed core leaves its socket file behind
+    QLocalServer::removeServer(name);
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+
+    if (!m_server.listen(name))
+    {
+        qWarning() << "Can't listen for GUI clients on" << name << m_server.errorString();
+        return false;
+    }
+    return true;
+}
+
+int CoreServer::clientCount() const
+{
+    return m_clients.count();
+}
+
+void CoreServer::onNewConnection()
+{
+    while (QLocalSocket* client = m_server.nextPendingConnection())
+    {
+        connect(client, &QLocalSocket::readyRead, this, [this, client]() {
+            this->readClient(client);
+        });
+        connect(client, &QLocalSocket::disconnected, this, [this, client]() {
+            m_clients.removeOne(client);
+            client->deleteLater();
+        });
+        m_clients.append(client);
+
+        // Pending changes are already merged into the snapshot
+        this->write(client, ::propertiesMessage(m_nodes));
+    }
+}
+
+void CoreServer::onPropertiesChanged(const QString& nodeId, const QVariantMap& properties)
+{
+    QVariantMap& node = m_nodes[nodeId];
+    QVariantMap& pending = m_pending[nodeId];
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it)
+    {
+        node.insert(it.key(), it.value());
+        pending.insert(it.key(), it.value());
+    }
+
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void CoreServer::onCommandFinished(int handle, bool accepted, const QVariantMap& results)
+{
+    const CommandRequest request = m_commandRequests.take(handle);
+    if (!request.client)
+        return;
+
+    const QJsonObject json({ { ::type, ::ack },
+                             { ::requestId, request.requestId },
+                             { ::accepted, accepted },
+                             { ::results, QJsonObject::fromVariantMap(results) } });
+    this->write(request.client, QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void CoreServer::onOperationStarted(domain::MissionOperation* operation)
+{
+    const QString missionId = operation->mission()->id().toString();
+    QLocalSocket* client = m_operationRequests.value(missionId);
+    if (!client || m_operations.contains(missionId))
+        return;
+
+    m_operations.insert(missionId, operation);
+    connect(operation, &domain::MissionOperation::changed, this, [this, operation, missionId]() {
+        if (QLocalSocket* client = m_operationRequests.value(missionId))
+            this->sendOperation(client, operation, false);
+    });
+    this->sendOperation(client, operation, false);
+}
+
+void CoreServer::onOperationEnded(domain::MissionOperation* operation)
+{
+    const QString missionId = operation->mission()->id().toString();
+    if (m_operations.value(missionId) != operation)
+        return;
+
+    m_operations.remove(missionId);
+    operation->disconnect(this);
+
+    const QPointer<QLocalSocket> client = m_operationRequests.take(missionId);
+    if (client)
+        this->sendOperation(client, operation, true);
+}
+
+void CoreServer::readClient(QLocalSocket* client)
+{
+    while (client->canReadLine())
+    {
+        const QJsonObject json = QJsonDocument::fromJson(client->readLine()).object();
+        const QString messageType = json.value(::type).toString();
+
+        if (messageType == ::command)
+        {
+            const int handle = m_commands->broadcast(
+                json.value(::vehicleIds).toArray().toVariantList(),
+                json.value(::commandId).toString(), json.value(::args).toArray().toVariantList());
+            m_commandRequests.insert(handle, { client, json.value(::requestId).toInt() });
+        }
+        else if (messageType == ::view)
+        {
+            m_rates->setSelectedVehicle(json.value(::selectedVehicle).toVariant());
+            m_rates->setTracking(json.value(::tracking).toBool());
+            m_rates->setViewport(
+                domain::Geodetic(json.value(::center).toObject().toVariantMap()),
+                domain::Geodetic(json.value(::camera).toObject().toVariantMap()));
+        }
+        else if (messageType == ::mission)
+        {
+            this->startOperation(
+                client, json.value(::missionId).toVariant(),
+                domain::MissionOperation::Type(json.value(::operationType).toInt()));
+        }
+        else if (messageType == ::missionCancel)
+        {
+            this->cancelOperation(json.value(::missionId).toVariant());
+        }
+    }
+}
+
+void CoreServer::startOperation(QLocalSocket* client, const QVariant& missionId,
+                                domain::MissionOperation::Type type)
+{
+    // The GUI saved its edits to the shared database, a mission it created is read there too
+    domain::Mission* mission = m_missions->mission(missionId);
+    if (mission)
+    {
+        m_missions->restoreMission(mission);
+    }
+    else
+    {
+        m_missions->readAll();
+        mission = m_missions->mission(missionId);
+    }
+
+    // One operation per mission, a request of a gone client does not hold it
+    if (!mission || m_operationRequests.value(missionId.toString()))
+    {
+        qWarning() << "Can't start mission operation for GUI client" << missionId;
+        const QJsonObject json({ { ::type, ::operation },
+                                 { ::missionId, QJsonValue::fromVariant(missionId) },
+                                 { ::state, domain::MissionOperation::Canceled } });
+        this->write(client, QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+        return;
+    }
+
+    m_operationRequests.insert(missionId.toString(), client);
+    m_missions->startOperation(mission, type);
+}
+
+void CoreServer::cancelOperation(const QVariant& missionId)
+{
+    // A start the vehicle never took only has its request to forget
+    domain::MissionOperation* operation = m_operations.value(missionId.toString());
+    if (operation)
+        m_missions->endOperation(operation, domain::MissionOperation::Canceled);
+
+    m_operationRequests.remove(missionId.toString());
+}
+
+void CoreServer::sendOperation(QLocalSocket* client, domain::MissionOperation* operation,
+                               bool ended)
+{
+    QJsonObject json({ { ::type, ::operation },
+                       { ::missionId, QJsonValue::fromVariant(operation->mission()->id()) },
+                       { ::progress, int(operation->progress) },
+                       { ::total, int(operation->total) } });
+    if (ended)
+        json.insert(::state, int(operation->state()));
+
+    this->write(client, QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void CoreServer::flush()
+{
+    if (m_pending.isEmpty())
+        return;
+
+    // Serialized once, the buffer is shared by all the clients
+    const QByteArray message = ::propertiesMessage(m_pending);
+    m_pending.clear();
+
+    for (QLocalSocket* client : QList<QLocalSocket*>(m_clients))
+    {
+        this->write(client, message);
+    }
+}
+
+void CoreServer::write(QLocalSocket* client, const QByteArray& message)
+{
+    // A stalled GUI must not grow the core memory, it gets a fresh snapshot on reattach
+    if (client->bytesToWrite() > maxPendingBytes)
+    {
+        qWarning() << "Dropping stalled GUI client";
+        client->abort();
+        return;
+    }
+    client->write(message);
+}
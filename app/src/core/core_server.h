@@ -0,0 +1,74 @@
+#ifndef CORE_SERVER_H
+#define CORE_SERVER_H
+
+#include "command_pipeline.h"
+#include "i_property_tree.h"
+#include "i_vehicles_service.h"
+#include "missions_service.h"
+#include "telemetry_rate_service.h"
+
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QTimer>
+
+namespace md::app
+{
+// Lets GUI processes attach to a headless core: telemetry snapshot and deltas out, commands,
+// mission operations and the view for telemetry rates in. With several GUIs the latest view wins.
+class CoreServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int flushInterval = 20;
+    static constexpr qint64 maxPendingBytes = 4 * 1024 * 1024;
+
+    CoreServer(domain::IPropertyTree* pTree, domain::CommandPipeline* commands,
+               domain::TelemetryRateService* rates, domain::IVehiclesService* vehicles,
+               domain::MissionsService* missions, QObject* parent = nullptr);
+    ~CoreServer() override;
+
+    bool listen(const QString& name);
+    int clientCount() const;
+
+private slots:
+    void onNewConnection();
+    void onPropertiesChanged(const QString& nodeId, const QVariantMap& properties);
+    void onCommandFinished(int handle, bool accepted, const QVariantMap& results);
+    void onOperationStarted(domain::MissionOperation* operation);
+    void onOperationEnded(domain::MissionOperation* operation);
+
+private:
+    struct CommandRequest
+    {
+        QPointer<QLocalSocket> client;
+        int requestId;
+    };
+
+    void readClient(QLocalSocket* client);
+    void startOperation(QLocalSocket* client, const QVariant& missionId,
+                        domain::MissionOperation::Type type);
+    void cancelOperation(const QVariant& missionId);
+    void sendOperation(QLocalSocket* client, domain::MissionOperation* operation, bool ended);
+    void flush();
+    void write(QLocalSocket* client, const QByteArray& message);
+
+    domain::IPropertyTree* const m_pTree;
+    domain::CommandPipeline* const m_commands;
+    domain::TelemetryRateService* const m_rates;
+    domain::IVehiclesService* const m_vehicles;
+    domain::MissionsService* const m_missions;
+    QLocalServer m_server;
+    QList<QLocalSocket*> m_clients;
+    QHash<QString, QVariantMap> m_nodes;   // Everything published so far, for attaching clients
+    QHash<QString, QVariantMap> m_pending; // Changes since the last flush
+    QHash<int, CommandRequest> m_commandRequests;
+    QHash<QString, QPointer<QLocalSocket>> m_operationRequests; // By mission id
+    QHash<QString, domain::MissionOperation*> m_operations;     // Started for clients
+    QTimer m_flushTimer;
+};
+} // namespace md::app
+
+#endif // CORE_SERVER_H
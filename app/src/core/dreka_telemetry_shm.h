@@ -0,0 +1,96 @@
+/* Layout of the vehicle states exported by Dreka into POSIX shared memory.
+ * Plain C, so companion processes can map the segment without Qt or the app sources.
+ *
+ * Each slot is guarded by a seqlock: the single writer makes the sequence odd while it updates
+ * the slot, readers copy the slot and retry if the sequence was odd or changed meanwhile.
+ * Readers never block the writer and any number of them may read at once. */
+
+#ifndef DREKA_TELEMETRY_SHM_H
+#define DREKA_TELEMETRY_SHM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DREKA_SHM_NAME "/dreka_telemetry"
+#define DREKA_SHM_MAGIC 0x544b5244u /* "DRKT" */
+#define DREKA_SHM_VERSION 1u
+#define DREKA_SHM_MAX_VEHICLES 64
+#define DREKA_SHM_ID_SIZE 40
+
+/* Units: degrees, meters, m/s, volts, amperes, percents. NaN if the vehicle did not report it */
+typedef struct
+{
+    char vehicle_id[DREKA_SHM_ID_SIZE]; /* Zero terminated, empty for a free slot */
+    int64_t timestamp_us;               /* Unix time of the last update */
+    double latitude;
+    double longitude;
+    double altitude_amsl;
+    double altitude_relative;
+    float roll;
+    float pitch;
+    float heading;
+    float course;
+    float ground_speed;
+    float air_speed;
+    float climb;
+    float battery_voltage;
+    float battery_current;
+    float battery_remaining;
+} dreka_vehicle_state_t;
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t reserved;
+    dreka_vehicle_state_t state;
+} dreka_vehicle_slot_t;
+
+typedef struct
+{
+    uint32_t magic; /* Written last, the segment is not ready until it matches */
+    uint32_t version;
+    uint32_t slot_size;
+    uint32_t slot_count; /* Slots in use are below that, freed ones have an empty id */
+    dreka_vehicle_slot_t slots[DREKA_SHM_MAX_VEHICLES];
+} dreka_telemetry_shm_t;
+
+static inline void dreka_shm_write_begin(dreka_vehicle_slot_t* slot)
+{
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void dreka_shm_write_end(dreka_vehicle_slot_t* slot)
+{
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Returns 1 with a consistent copy of the slot, 0 if it is free or still being written */
+static inline int dreka_shm_read(const dreka_telemetry_shm_t* shm, uint32_t index,
+                                 dreka_vehicle_state_t* state, int attempts)
+{
+    const dreka_vehicle_slot_t* slot = &shm->slots[index];
+    while (attempts-- > 0)
+    {
+        const uint32_t begin = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (begin & 1u)
+            continue;
+
+        memcpy(state, &slot->state, sizeof(*state));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == begin)
+            return state->vehicle_id[0] != '\0';
+    }
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DREKA_TELEMETRY_SHM_H */
@@ -0,0 +1,251 @@
+#include "telemetry_shm_exporter.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+template<typename T>
+struct Field
+{
+    const char* key;
+    T dreka_vehicle_state_t::*member;
+};
+
+const Field<double> doubleFields[] = {
+    { "latitude", &dreka_vehicle_state_t::latitude },
+    { "longitude", &dreka_vehicle_state_t::longitude },
+    { "altitudeAmsl", &dreka_vehicle_state_t::altitude_amsl },
+    { "altitudeRelative", &dreka_vehicle_state_t::altitude_relative },
+};
+
+const Field<float> floatFields[] = {
+    { "roll", &dreka_vehicle_state_t::roll },
+    { "pitch", &dreka_vehicle_state_t::pitch },
+    { "heading", &dreka_vehicle_state_t::heading },
+    { "course", &dreka_vehicle_state_t::course },
+    { "gs", &dreka_vehicle_state_t::ground_speed },
+    { "ias", &dreka_vehicle_state_t::air_speed },
+    { "climb", &dreka_vehicle_state_t::climb },
+    { "batteryVoltage", &dreka_vehicle_state_t::battery_voltage },
+    { "batteryCurrent", &dreka_vehicle_state_t::battery_current },
+    { "batteryRemaining", &dreka_vehicle_state_t::battery_remaining },
+};
+
+bool isExported(const QVariantMap& properties)
+{
+    for (const auto& field : ::doubleFields)
+    {
+        if (properties.contains(field.key))
+            return true;
+    }
+    for (const auto& field : ::floatFields)
+    {
+        if (properties.contains(field.key))
+            return true;
+    }
+    return false;
+}
+} // namespace
+
+using namespace md::app;
+
+TelemetryShmExporter::TelemetryShmExporter(domain::IPropertyTree* pTree,
+                                           domain::IVehiclesService* vehicles, QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree),
+    m_vehicles(vehicles),
+    m_nodeFilter([vehicles](const QString& nodeId) {
+        return vehicles->vehicle(nodeId) != nullptr;
+    })
+{
+    connect(m_pTree, &domain::IPropertyTree::propertiesChanged, this,
+            &TelemetryShmExporter::onPropertiesChanged);
+    connect(m_vehicles, &domain::IVehiclesService::vehicleRemoved, this,
+            &TelemetryShmExporter::onVehicleRemoved);
+}
+
+TelemetryShmExporter::~TelemetryShmExporter()
+{
+    this->close();
+}
+
+bool TelemetryShmExporter::open(const QString& name)
+{
+#ifdef Q_OS_UNIX
+    this->close();
+    m_name = name.toLocal8Bit();
+
+    const int fd = ::shm_open(m_name.constData(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        qWarning() << "Can't open telemetry shared memory" << name << strerror(errno);
+        return false;
+    }
+
+    const size_t size = sizeof(dreka_telemetry_shm_t);
+    void* data = MAP_FAILED;
+    if (::ftruncate(fd, size) == 0)
+        data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        qWarning() << "Can't map telemetry shared memory" << name << strerror(errno);
+        ::shm_unlink(m_name.constData());
+        return false;
+    }
+
+    // Readers wait for the magic, so it goes last
+    m_shm = static_cast<dreka_telemetry_shm_t*>(data);
+    __atomic_store_n(&m_shm->magic, 0, __ATOMIC_RELAXED);
+    std::memset(m_shm->slots, 0, sizeof(m_shm->slots));
+    m_shm->version = DREKA_SHM_VERSION;
+    m_shm->slot_size = sizeof(dreka_vehicle_slot_t);
+    m_shm->slot_count = 0;
+    __atomic_store_n(&m_shm->magic, DREKA_SHM_MAGIC, __ATOMIC_RELEASE);
+    return true;
+#else
+    Q_UNUSED(name)
+    qWarning() << "Telemetry shared memory export is not supported on this platform";
+    return false;
+#endif
+}
+
+void TelemetryShmExporter::close()
+{
+#ifdef Q_OS_UNIX
+    if (!m_shm)
+        return;
+
+    // Mapped readers keep the memory, new ones won't find the stale segment
+    ::munmap(m_shm, sizeof(dreka_telemetry_shm_t));
+    ::shm_unlink(m_name.constData());
+    m_shm = nullptr;
+    m_slots.clear();
+    m_freeSlots.clear();
+#endif
+}
+
+bool TelemetryShmExporter::isOpen() const
+{
+    return m_shm != nullptr;
+}
+
+void TelemetryShmExporter::setNodeFilter(const NodeFilter& filter)
+{
+    m_nodeFilter = filter;
+}
+
+void TelemetryShmExporter::onPropertiesChanged(const QString& nodeId,
+                                               const QVariantMap& properties)
+{
+    if (!m_shm || !::isExported(properties))
+        return;
+
+    dreka_vehicle_slot_t* slot = this->slot(nodeId);
+    if (!slot)
+        return;
+
+    // Only changed fields are written, readers get the slot consistent anyway
+    ::dreka_shm_write_begin(slot);
+    for (const auto& field : ::doubleFields)
+    {
+        auto it = properties.constFind(field.key);
+        if (it != properties.constEnd())
+            slot->state.*field.member = it->isValid() ? it->toDouble() : NAN;
+    }
+    for (const auto& field : ::floatFields)
+    {
+        auto it = properties.constFind(field.key);
+        if (it != properties.constEnd())
+            slot->state.*field.member = it->isValid() ? it->toFloat() : NAN;
+    }
+    slot->state.timestamp_us = QDateTime::currentMSecsSinceEpoch() * 1000;
+    ::dreka_shm_write_end(slot);
+}
+
+void TelemetryShmExporter::onVehicleRemoved(domain::Vehicle* vehicle)
+{
+    auto it = m_slots.find(vehicle->id().toString());
+    if (it == m_slots.end())
+        return;
+
+    const int index = it.value();
+    m_slots.erase(it);
+    if (!m_shm || index < 0)
+        return;
+
+    // Readers skip a slot with an empty id, until it is given to another vehicle
+    this->resetSlot(&m_shm->slots[index], QString());
+    m_freeSlots.append(index);
+
+    // Nodes that found no slot get one on their next update
+    for (auto it = m_slots.begin(); it != m_slots.end();)
+    {
+        if (it.value() < 0)
+            it = m_slots.erase(it);
+        else
+            ++it;
+    }
+}
+
+dreka_vehicle_slot_t* TelemetryShmExporter::slot(const QString& nodeId)
+{
+    auto it = m_slots.constFind(nodeId);
+    if (it != m_slots.constEnd())
+        return it.value() < 0 ? nullptr : &m_shm->slots[it.value()];
+
+    if (!m_nodeFilter(nodeId))
+        return nullptr;
+
+    const quint32 slotCount = m_shm->slot_count;
+    int index = -1;
+    if (!m_freeSlots.isEmpty())
+    {
+        index = m_freeSlots.takeLast();
+    }
+    else if (slotCount < DREKA_SHM_MAX_VEHICLES)
+    {
+        index = int(slotCount);
+    }
+    else
+    {
+        qWarning() << "No telemetry shared memory slot left for" << nodeId;
+        m_slots.insert(nodeId, -1);
+        return nullptr;
+    }
+
+    dreka_vehicle_slot_t* slot = &m_shm->slots[index];
+    this->resetSlot(slot, nodeId);
+    m_slots.insert(nodeId, index);
+
+    if (quint32(index) >= slotCount)
+        __atomic_store_n(&m_shm->slot_count, index + 1, __ATOMIC_RELEASE);
+    return slot;
+}
+
+void TelemetryShmExporter::resetSlot(dreka_vehicle_slot_t* slot, const QString& nodeId)
+{
+    ::dreka_shm_write_begin(slot);
+    for (const auto& field : ::doubleFields)
+    {
+        slot->state.*field.member = NAN;
+    }
+    for (const auto& field : ::floatFields)
+    {
+        slot->state.*field.member = NAN;
+    }
+    slot->state.timestamp_us = 0;
+    qstrncpy(slot->state.vehicle_id, nodeId.toUtf8().constData(), DREKA_SHM_ID_SIZE);
+    ::dreka_shm_write_end(slot);
+}
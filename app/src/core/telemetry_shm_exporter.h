@@ -0,0 +1,51 @@
+#ifndef TELEMETRY_SHM_EXPORTER_H
+#define TELEMETRY_SHM_EXPORTER_H
+
+#include "dreka_telemetry_shm.h"
+#include "i_property_tree.h"
+#include "i_vehicles_service.h"
+
+#include <QHash>
+#include <QVector>
+#include <functional>
+
+namespace md::app
+{
+// Writes vehicle states into POSIX shared memory for companion processes, see dreka_telemetry_shm.h
+class TelemetryShmExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    using NodeFilter = std::function<bool(const QString& nodeId)>;
+
+    TelemetryShmExporter(domain::IPropertyTree* pTree, domain::IVehiclesService* vehicles,
+                         QObject* parent = nullptr);
+    ~TelemetryShmExporter() override;
+
+    bool open(const QString& name = DREKA_SHM_NAME);
+    void close();
+    bool isOpen() const;
+
+    // Nodes that get slots, vehicles of the service by default, so playback nodes take none
+    void setNodeFilter(const NodeFilter& filter);
+
+private slots:
+    void onPropertiesChanged(const QString& nodeId, const QVariantMap& properties);
+    void onVehicleRemoved(domain::Vehicle* vehicle);
+
+private:
+    dreka_vehicle_slot_t* slot(const QString& nodeId);
+    void resetSlot(dreka_vehicle_slot_t* slot, const QString& nodeId);
+
+    domain::IPropertyTree* const m_pTree;
+    domain::IVehiclesService* const m_vehicles;
+    NodeFilter m_nodeFilter;
+    QByteArray m_name;
+    dreka_telemetry_shm_t* m_shm = nullptr;
+    QHash<QString, int> m_slots; // -1 for nodes left without a slot
+    QVector<int> m_freeSlots;    // Freed by removed vehicles, reused first
+};
+} // namespace md::app
+
+#endif // TELEMETRY_SHM_EXPORTER_H
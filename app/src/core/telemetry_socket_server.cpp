@@ -0,0 +1,394 @@
+#include "telemetry_socket_server.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+constexpr char serverName[] = "Dreka telemetry";
+
+constexpr char type[] = "type";
+constexpr char subscribe[] = "subscribe";
+constexpr char subscribed[] = "subscribed";
+constexpr char topics[] = "topics";
+constexpr char nodes[] = "nodes";
+constexpr char rate[] = "rate";
+constexpr char properties[] = "properties";
+constexpr char node[] = "node";
+constexpr char vehicles[] = "vehicles";
+constexpr char vehicle[] = "vehicle";
+constexpr char vehicleAdded[] = "vehicleAdded";
+constexpr char vehicleChanged[] = "vehicleChanged";
+constexpr char vehicleRemoved[] = "vehicleRemoved";
+constexpr char missions[] = "missions";
+constexpr char mission[] = "mission";
+constexpr char missionAdded[] = "missionAdded";
+constexpr char missionChanged[] = "missionChanged";
+constexpr char missionRemoved[] = "missionRemoved";
+constexpr char routeItemAdded[] = "routeItemAdded";
+constexpr char routeItemChanged[] = "routeItemChanged";
+constexpr char routeItemRemoved[] = "routeItemRemoved";
+constexpr char items[] = "items";
+constexpr char item[] = "item";
+constexpr char index[] = "index";
+constexpr char id[] = "id";
+
+QJsonObject missionJson(md::domain::Mission* mission)
+{
+    QJsonArray items;
+    for (md::domain::MissionRouteItem* item : mission->route()->items())
+    {
+        items.append(QJsonObject::fromVariantMap(item->toVariantMap()));
+    }
+
+    QJsonObject json = QJsonObject::fromVariantMap(mission->toVariantMap());
+    json.insert(::items, items);
+    return json;
+}
+
+QJsonObject routeItemJson(const char* type, md::domain::Mission* mission, int index,
+                          md::domain::MissionRouteItem* item)
+{
+    QJsonObject json({ { ::type, type },
+                       { ::mission, QJsonValue::fromVariant(mission->id()) },
+                       { ::index, index } });
+    if (item)
+        json.insert(::item, QJsonObject::fromVariantMap(item->toVariantMap()));
+    return json;
+}
+} // namespace
+
+using namespace md::domain;
+using namespace md::app;
+
+TelemetrySocketServer::TelemetrySocketServer(IPropertyTree* pTree, IVehiclesService* vehicles,
+                                             IMissionsService* missions, QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree),
+    m_vehicles(vehicles),
+    m_missions(missions),
+    m_server(::serverName, QWebSocketServer::NonSecureMode)
+{
+    connect(m_pTree, &IPropertyTree::propertiesChanged, this,
+            &TelemetrySocketServer::onPropertiesChanged);
+
+    connect(m_vehicles, &IVehiclesService::vehicleAdded, this, [this](Vehicle* vehicle) {
+        const QJsonObject json = QJsonObject::fromVariantMap(vehicle->toVariantMap());
+        this->broadcast(Vehicles,
+                        this->serialize({ { ::type, ::vehicleAdded }, { ::vehicle, json } }));
+    });
+    connect(m_vehicles, &IVehiclesService::vehicleChanged, this, [this](Vehicle* vehicle) {
+        const QJsonObject json = QJsonObject::fromVariantMap(vehicle->toVariantMap());
+        this->broadcast(Vehicles,
+                        this->serialize({ { ::type, ::vehicleChanged }, { ::vehicle, json } }));
+    });
+    connect(m_vehicles, &IVehiclesService::vehicleRemoved, this, [this](Vehicle* vehicle) {
+        const QJsonValue vehicleId = QJsonValue::fromVariant(vehicle->id());
+        this->broadcast(Vehicles,
+                        this->serialize({ { ::type, ::vehicleRemoved }, { ::id, vehicleId } }));
+    });
+
+    connect(m_missions, &IMissionsService::missionAdded, this,
+            &TelemetrySocketServer::onMissionAdded);
+    connect(m_missions, &IMissionsService::missionRemoved, this,
+            &TelemetrySocketServer::onMissionRemoved);
+    for (Mission* mission : m_missions->missions())
+    {
+        this->onMissionAdded(mission);
+    }
+
+    connect(&m_server, &QWebSocketServer::newConnection, this,
+            &TelemetrySocketServer::onNewConnection);
+
+    m_timer.setInterval(tickInterval);
+    connect(&m_timer, &QTimer::timeout, this, &TelemetrySocketServer::tick);
+}
+
+TelemetrySocketServer::~TelemetrySocketServer()
+{
+    for (QWebSocket* socket : m_clients.keys())
+    {
+        socket->disconnect(this);
+        socket->abort();
+        delete socket;
+    }
+}
+
+bool TelemetrySocketServer::listen(quint16 port)
+{
+    if (!m_server.listen(QHostAddress::LocalHost, port))
+    {
+        qWarning() << "Can't listen for telemetry clients on port" << port
+                   << m_server.errorString();
+        return false;
+    }
+
+    m_timer.start();
+    return true;
+}
+
+int TelemetrySocketServer::clientCount() const
+{
+    return m_clients.count();
+}
+
+qint64 TelemetrySocketServer::pendingBytes() const
+{
+    qint64 bytes = 0;
+    for (const Client& client : m_clients)
+    {
+        bytes += client.pendingBytes;
+    }
+    return bytes;
+}
+
+quint16 TelemetrySocketServer::port() const
+{
+    return m_server.serverPort();
+}
+
+void TelemetrySocketServer::onNewConnection()
+{
+    while (QWebSocket* socket = m_server.nextPendingConnection())
+    {
+        connect(socket, &QWebSocket::textMessageReceived, this,
+                [this, socket](const QString& message) {
+                    this->subscribe(socket, message);
+                });
+        connect(socket, &QWebSocket::bytesWritten, this, [this, socket](qint64 bytes) {
+            auto client = m_clients.find(socket);
+            if (client != m_clients.end())
+                client->pendingBytes = qMax(qint64(0), client->pendingBytes - bytes);
+        });
+        connect(socket, &QWebSocket::disconnected, this, [this, socket]() {
+            m_clients.remove(socket);
+            socket->deleteLater();
+        });
+
+        // Properties follow on the next tick
+        const Client client;
+        m_clients.insert(socket, client);
+        this->sendSnapshot(socket, client.topics);
+    }
+}
+
+void TelemetrySocketServer::onPropertiesChanged(const QString& nodeId,
+                                                const QVariantMap& properties)
+{
+    QHash<QString, Property>& node = m_nodes[nodeId];
+    ++m_version;
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it)
+    {
+        node.insert(it.key(), { it.value(), m_version });
+    }
+    m_nodeVersions.insert(nodeId, m_version);
+}
+
+void TelemetrySocketServer::onMissionAdded(Mission* mission)
+{
+    connect(mission, &Mission::changed, this, [this, mission]() {
+        const QJsonObject json = QJsonObject::fromVariantMap(mission->toVariantMap());
+        this->broadcast(Missions,
+                        this->serialize({ { ::type, ::missionChanged }, { ::mission, json } }));
+    });
+
+    // Routes are streamed item by item, clients got the whole one with the mission
+    connect(mission->route, &MissionRoute::itemAdded, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                this->broadcast(Missions,
+                                this->serialize(::routeItemJson(::routeItemAdded, mission,
+                                                                index, item)));
+            });
+    connect(mission->route, &MissionRoute::itemChanged, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                this->broadcast(Missions,
+                                this->serialize(::routeItemJson(::routeItemChanged, mission,
+                                                                index, item)));
+            });
+    connect(mission->route, &MissionRoute::itemRemoved, this, [this, mission](int index) {
+        this->broadcast(Missions, this->serialize(::routeItemJson(::routeItemRemoved, mission,
+                                                                  index, nullptr)));
+    });
+
+    this->broadcast(Missions, this->serialize({ { ::type, ::missionAdded },
+                                                { ::mission, ::missionJson(mission) } }));
+}
+
+void TelemetrySocketServer::onMissionRemoved(Mission* mission)
+{
+    disconnect(mission, nullptr, this, nullptr);
+    disconnect(mission->route, nullptr, this, nullptr);
+    const QJsonValue missionId = QJsonValue::fromVariant(mission->id());
+    this->broadcast(Missions,
+                    this->serialize({ { ::type, ::missionRemoved }, { ::id, missionId } }));
+}
+
+void TelemetrySocketServer::subscribe(QWebSocket* socket, const QString& message)
+{
+    auto client = m_clients.find(socket);
+    const QJsonObject json = QJsonDocument::fromJson(message.toUtf8()).object();
+    if (client == m_clients.end() || json.value(::type).toString() != ::subscribe)
+        return;
+
+    const int oldTopics = client->topics;
+    if (json.contains(::topics))
+    {
+        client->topics = 0;
+        for (const QJsonValue& topic : json.value(::topics).toArray())
+        {
+            if (topic.toString() == ::properties)
+                client->topics |= Properties;
+            else if (topic.toString() == ::vehicles)
+                client->topics |= Vehicles;
+            else if (topic.toString() == ::missions)
+                client->topics |= Missions;
+        }
+    }
+
+    if (json.contains(::nodes))
+    {
+        client->nodes.clear();
+        for (const QJsonValue& nodeId : json.value(::nodes).toArray())
+        {
+            client->nodes.insert(nodeId.toString());
+        }
+    }
+
+    if (json.contains(::rate))
+        client->interval = 1000 / qBound(1, json.value(::rate).toInt(), maxRate);
+
+    // Newly subscribed nodes start from their current state
+    client->sentVersion = 0;
+    this->sendSnapshot(socket, client->topics & ~oldTopics);
+
+    // Anything after that follows the new subscription
+    this->send(socket, this->serialize({ { ::type, ::subscribed } }));
+}
+
+void TelemetrySocketServer::tick()
+{
+    const quint64 tick = m_tick++;
+    const QList<QWebSocket*> sockets = m_clients.keys();
+    for (QWebSocket* socket : sockets)
+    {
+        auto client = m_clients.find(socket);
+        if (client == m_clients.end() || !(client->topics & Properties))
+            continue;
+
+        // Ticks count the same for everyone, so clients of the same rate send together from the
+        // same change and share deltas. Skipped changes are conflated into the latest states.
+        const int interval = client->pendingBytes > conflateBytes ? conflateInterval
+                                                                  : client->interval;
+        if (tick % qMax(1, interval / tickInterval))
+            continue;
+
+        const quint64 sentVersion = client->sentVersion;
+        const QSet<QString> nodes = client->nodes;
+        client->sentVersion = m_version;
+
+        for (auto it = m_nodeVersions.constBegin(); it != m_nodeVersions.constEnd(); ++it)
+        {
+            if (it.value() <= sentVersion || (!nodes.isEmpty() && !nodes.contains(it.key())))
+                continue;
+
+            if (!this->send(socket, this->nodeMessage(it.key(), sentVersion)))
+                break;
+        }
+    }
+}
+
+void TelemetrySocketServer::broadcast(Topic topic, const Message& message)
+{
+    const QList<QWebSocket*> sockets = m_clients.keys();
+    for (QWebSocket* socket : sockets)
+    {
+        if (m_clients.contains(socket) && m_clients.value(socket).topics & topic)
+            this->send(socket, message);
+    }
+}
+
+void TelemetrySocketServer::sendSnapshot(QWebSocket* socket, int topics)
+{
+    if (topics & Vehicles)
+    {
+        QJsonArray vehicles;
+        for (Vehicle* vehicle : m_vehicles->vehicles())
+        {
+            vehicles.append(QJsonObject::fromVariantMap(vehicle->toVariantMap()));
+        }
+        if (!this->send(socket,
+                        this->serialize({ { ::type, ::vehicles }, { ::vehicles, vehicles } })))
+            return;
+    }
+
+    if (topics & Missions)
+    {
+        QJsonArray missions;
+        for (Mission* mission : m_missions->missions())
+        {
+            missions.append(::missionJson(mission));
+        }
+        this->send(socket, this->serialize({ { ::type, ::missions }, { ::missions, missions } }));
+    }
+}
+
+bool TelemetrySocketServer::send(QWebSocket* socket, const Message& message)
+{
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end())
+        return false;
+
+    // Never let a stalled client hold the core memory
+    if (client->pendingBytes > dropBytes)
+    {
+        qWarning() << "Dropping stalled telemetry client" << socket->peerPort();
+        m_clients.erase(client);
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+        return false;
+    }
+
+    client->pendingBytes += message.size;
+    socket->sendTextMessage(message.text);
+    return true;
+}
+
+TelemetrySocketServer::Message TelemetrySocketServer::serialize(const QJsonObject& json)
+{
+    // Sizes are counted once per message, not once per client
+    const QByteArray utf8 = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    return { QString::fromUtf8(utf8), utf8.size() };
+}
+
+const TelemetrySocketServer::Message& TelemetrySocketServer::nodeMessage(const QString& nodeId,
+                                                                         quint64 since)
+{
+    NodeMessages& cached = m_nodeMessages[nodeId];
+    const quint64 version = m_nodeVersions.value(nodeId);
+    if (cached.version != version)
+    {
+        cached.version = version;
+        cached.since.clear();
+    }
+
+    auto message = cached.since.find(since);
+    if (message == cached.since.end())
+    {
+        QJsonObject properties;
+        const QHash<QString, Property> node = m_nodes.value(nodeId);
+        for (auto it = node.constBegin(); it != node.constEnd(); ++it)
+        {
+            if (it->version > since)
+                properties.insert(it.key(), QJsonValue::fromVariant(it->value));
+        }
+
+        message = cached.since.insert(
+            since, this->serialize({ { ::type, ::properties },
+                                     { ::node, nodeId },
+                                     { ::properties, properties } }));
+    }
+    return *message;
+}
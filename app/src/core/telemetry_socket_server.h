@@ -0,0 +1,109 @@
+#ifndef TELEMETRY_SOCKET_SERVER_H
+#define TELEMETRY_SOCKET_SERVER_H
+
+#include "i_missions_service.h"
+#include "i_property_tree.h"
+#include "i_vehicles_service.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QTimer>
+#include <QWebSocket>
+#include <QWebSocketServer>
+
+namespace md::app
+{
+// Streams telemetry, vehicles and missions as JSON to WebSocket clients of other consoles
+class TelemetrySocketServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int tickInterval = 20;
+    static constexpr int defaultRate = 10; // Hz
+    static constexpr int maxRate = 50;
+    // Clients behind by more than that get the latest states once a second, further behind are
+    // dropped
+    static constexpr qint64 conflateBytes = 256 * 1024;
+    static constexpr qint64 dropBytes = 4 * 1024 * 1024;
+    static constexpr int conflateInterval = 1000;
+
+    TelemetrySocketServer(domain::IPropertyTree* pTree, domain::IVehiclesService* vehicles,
+                          domain::IMissionsService* missions, QObject* parent = nullptr);
+    ~TelemetrySocketServer() override;
+
+    bool listen(quint16 port); // Zero picks a free port
+    quint16 port() const;
+    int clientCount() const;
+    qint64 pendingBytes() const; // Queued for all clients, not yet written to sockets
+
+public slots:
+    // Sends properties to clients due on this tick, clients of the same rate are due together
+    void tick();
+
+private slots:
+    void onNewConnection();
+    void onPropertiesChanged(const QString& nodeId, const QVariantMap& properties);
+    void onMissionAdded(domain::Mission* mission);
+    void onMissionRemoved(domain::Mission* mission);
+
+private:
+    enum Topic
+    {
+        Properties = 0x1,
+        Vehicles = 0x2,
+        Missions = 0x4
+    };
+
+    struct Client
+    {
+        QSet<QString> nodes; // Empty for all nodes
+        int topics = Properties | Vehicles | Missions;
+        int interval = 1000 / defaultRate;
+        quint64 sentVersion = 0; // Property changes up to this one are delivered
+        qint64 pendingBytes = 0; // Queued but not yet written to the socket
+    };
+
+    struct Property
+    {
+        QVariant value;
+        quint64 version = 0; // Change that set the value
+    };
+
+    struct Message
+    {
+        QString text;
+        qint64 size = 0; // UTF-8 bytes, as sent
+    };
+
+    struct NodeMessages
+    {
+        quint64 version = 0;
+        QHash<quint64, Message> since; // Changes after the key are included
+    };
+
+    static Message serialize(const QJsonObject& json);
+
+    void subscribe(QWebSocket* socket, const QString& message);
+    void broadcast(Topic topic, const Message& message);
+    void sendSnapshot(QWebSocket* socket, int topics);
+    bool send(QWebSocket* socket, const Message& message);
+    const Message& nodeMessage(const QString& nodeId, quint64 since);
+
+    domain::IPropertyTree* const m_pTree;
+    domain::IVehiclesService* const m_vehicles;
+    domain::IMissionsService* const m_missions;
+    QWebSocketServer m_server;
+    QHash<QWebSocket*, Client> m_clients;
+    QHash<QString, QHash<QString, Property>> m_nodes;
+    QHash<QString, quint64> m_nodeVersions;
+    // Deltas serialized once for all clients that got the node up to the same change
+    QHash<QString, NodeMessages> m_nodeMessages;
+    quint64 m_version = 0;
+    quint64 m_tick = 0;
+    QTimer m_timer;
+};
+} // namespace md::app
+
+#endif // TELEMETRY_SOCKET_SERVER_H
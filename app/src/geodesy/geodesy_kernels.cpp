@@ -0,0 +1,234 @@
+#include "geodesy_kernels.h"
+
+#include <QtMath>
+
+#include <cmath>
+
+namespace
+{
+constexpr double toRadians = M_PI / 180.0;
+constexpr double toDegrees = 180.0 / M_PI;
+constexpr double wgs84A = 6378137.0;
+constexpr double wgs84F = 1.0 / 298.257223563;
+constexpr double wgs84B = wgs84A * (1.0 - wgs84F);
+constexpr double wgs84E2 = wgs84F * (2.0 - wgs84F);
+
+double normalizedBearing(double radians)
+{
+    return std::fmod(radians * ::toDegrees + 360.0, 360.0);
+}
+
+void toEcef(const double* latitudes, const double* longitudes, const double* altitudes, double* x,
+            double* y, double* z, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const double phi = latitudes[i] * ::toRadians;
+        const double lambda = longitudes[i] * ::toRadians;
+        const double sinPhi = std::sin(phi), cosPhi = std::cos(phi);
+        const double n = ::wgs84A / std::sqrt(1 - ::wgs84E2 * sinPhi * sinPhi);
+
+        x[i] = (n + altitudes[i]) * cosPhi * std::cos(lambda);
+        y[i] = (n + altitudes[i]) * cosPhi * std::sin(lambda);
+        z[i] = (n * (1 - ::wgs84E2) + altitudes[i]) * sinPhi;
+    }
+}
+
+void fromEcef(const double* x, const double* y, const double* z, double* latitudes,
+              double* longitudes, double* altitudes, int count)
+{
+    // Closed form solution by Heikkinen, no iterations
+    constexpr double a2 = ::wgs84A * ::wgs84A;
+    constexpr double b2 = ::wgs84B * ::wgs84B;
+    constexpr double ep2 = (a2 - b2) / b2;
+
+    for (int i = 0; i < count; ++i)
+    {
+        // Outputs may alias inputs
+        const double xi = x[i], yi = y[i], zi = z[i];
+        const double z2 = zi * zi;
+        const double p2 = xi * xi + yi * yi;
+        const double p = std::sqrt(p2);
+
+        const double f = 54 * b2 * z2;
+        const double g = p2 + (1 - ::wgs84E2) * z2 - ::wgs84E2 * (a2 - b2);
+        const double c = ::wgs84E2 * ::wgs84E2 * f * p2 / (g * g * g);
+        const double s = std::cbrt(1 + c + std::sqrt(c * c + 2 * c));
+        const double k = s + 1 + 1 / s;
+        const double pp = f / (3 * k * k * g * g);
+        const double q = std::sqrt(1 + 2 * ::wgs84E2 * ::wgs84E2 * pp);
+        const double r0 = -(pp * ::wgs84E2 * p) / (1 + q) +
+                          std::sqrt(a2 / 2 * (1 + 1 / q) -
+                                    pp * (1 - ::wgs84E2) * z2 / (q * (1 + q)) - pp * p2 / 2);
+        const double t = p - ::wgs84E2 * r0;
+        const double u = std::sqrt(t * t + z2);
+        const double v = std::sqrt(t * t + (1 - ::wgs84E2) * z2);
+        const double z0 = b2 * zi / (::wgs84A * v);
+
+        latitudes[i] = std::atan2(zi + ep2 * z0, p) * ::toDegrees;
+        longitudes[i] = std::atan2(yi, xi) * ::toDegrees;
+        altitudes[i] = u * (1 - b2 / (::wgs84A * v));
+    }
+}
+} // namespace
+
+using namespace md::domain;
+
+int GeodeticArrays::count() const
+{
+    return latitudes.count();
+}
+
+void GeodeticArrays::reserve(int count)
+{
+    latitudes.reserve(count);
+    longitudes.reserve(count);
+    altitudes.reserve(count);
+}
+
+void GeodeticArrays::resize(int count)
+{
+    latitudes.resize(count);
+    longitudes.resize(count);
+    altitudes.resize(count);
+}
+
+void GeodeticArrays::append(const Geodetic& position)
+{
+    latitudes.append(position.latitude());
+    longitudes.append(position.longitude());
+    altitudes.append(position.altitude());
+}
+
+Geodetic GeodeticArrays::at(int index) const
+{
+    return Geodetic(latitudes.at(index), longitudes.at(index), altitudes.at(index));
+}
+
+GeodeticArrays GeodeticArrays::fromPositions(const QVector<Geodetic>& positions)
+{
+    GeodeticArrays arrays;
+    arrays.reserve(positions.count());
+    for (const Geodetic& position : positions)
+    {
+        arrays.append(position);
+    }
+    return arrays;
+}
+
+QVector<Geodetic> GeodeticArrays::toPositions() const
+{
+    QVector<Geodetic> positions;
+    positions.reserve(this->count());
+    for (int i = 0; i < this->count(); ++i)
+    {
+        positions.append(this->at(i));
+    }
+    return positions;
+}
+
+void geodesy::haversine(const double* latitudes1, const double* longitudes1,
+                        const double* latitudes2, const double* longitudes2, double* distances,
+                        int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const double phi1 = latitudes1[i] * ::toRadians;
+        const double phi2 = latitudes2[i] * ::toRadians;
+        const double sinDPhi = std::sin((phi2 - phi1) / 2);
+        const double sinDLambda = std::sin((longitudes2[i] - longitudes1[i]) * ::toRadians / 2);
+        const double a = sinDPhi * sinDPhi +
+                         std::cos(phi1) * std::cos(phi2) * sinDLambda * sinDLambda;
+        distances[i] = 2 * meanRadius * std::asin(std::sqrt(std::fmin(1.0, a)));
+    }
+}
+
+void geodesy::legs(const double* latitudes, const double* longitudes, double* distances,
+                   double* bearings, int count)
+{
+    if (count < 2)
+        return;
+
+    // Every point is shared by two legs, so its trigonometry is computed once
+    QVector<double> sinPhi(count), cosPhi(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const double phi = latitudes[i] * ::toRadians;
+        sinPhi[i] = std::sin(phi);
+        cosPhi[i] = std::cos(phi);
+    }
+
+    for (int i = 0; i < count - 1; ++i)
+    {
+        const double dLambda = (longitudes[i + 1] - longitudes[i]) * ::toRadians;
+        const double sinDPhi = std::sin((latitudes[i + 1] - latitudes[i]) * ::toRadians / 2);
+        const double sinDLambda = std::sin(dLambda / 2);
+        const double a = sinDPhi * sinDPhi + cosPhi[i] * cosPhi[i + 1] * sinDLambda * sinDLambda;
+        distances[i] = 2 * meanRadius * std::asin(std::sqrt(std::fmin(1.0, a)));
+
+        if (bearings)
+        {
+            const double y = std::sin(dLambda) * cosPhi[i + 1];
+            const double x = cosPhi[i] * sinPhi[i + 1] - sinPhi[i] * cosPhi[i + 1] *
+                                                             std::cos(dLambda);
+            bearings[i] = ::normalizedBearing(std::atan2(y, x));
+        }
+    }
+}
+
+void geodesy::toEnu(const Geodetic& origin, const double* latitudes, const double* longitudes,
+                    const double* altitudes, double* east, double* north, double* up, int count)
+{
+    const double originLatitude = origin.latitude();
+    const double originLongitude = origin.longitude();
+    const double originAltitude = origin.altitude();
+    double x0, y0, z0;
+    ::toEcef(&originLatitude, &originLongitude, &originAltitude, &x0, &y0, &z0, 1);
+
+    const double sinPhi = std::sin(originLatitude * ::toRadians);
+    const double cosPhi = std::cos(originLatitude * ::toRadians);
+    const double sinLambda = std::sin(originLongitude * ::toRadians);
+    const double cosLambda = std::cos(originLongitude * ::toRadians);
+
+    // Ecef written straight into the output arrays, then rotated in place
+    ::toEcef(latitudes, longitudes, altitudes, east, north, up, count);
+    for (int i = 0; i < count; ++i)
+    {
+        const double dx = east[i] - x0;
+        const double dy = north[i] - y0;
+        const double dz = up[i] - z0;
+
+        east[i] = -sinLambda * dx + cosLambda * dy;
+        north[i] = -sinPhi * cosLambda * dx - sinPhi * sinLambda * dy + cosPhi * dz;
+        up[i] = cosPhi * cosLambda * dx + cosPhi * sinLambda * dy + sinPhi * dz;
+    }
+}
+
+void geodesy::fromEnu(const Geodetic& origin, const double* east, const double* north,
+                      const double* up, double* latitudes, double* longitudes, double* altitudes,
+                      int count)
+{
+    const double originLatitude = origin.latitude();
+    const double originLongitude = origin.longitude();
+    const double originAltitude = origin.altitude();
+    double x0, y0, z0;
+    ::toEcef(&originLatitude, &originLongitude, &originAltitude, &x0, &y0, &z0, 1);
+
+    const double sinPhi = std::sin(originLatitude * ::toRadians);
+    const double cosPhi = std::cos(originLatitude * ::toRadians);
+    const double sinLambda = std::sin(originLongitude * ::toRadians);
+    const double cosLambda = std::cos(originLongitude * ::toRadians);
+
+    // Ecef written into the output arrays, then converted in place
+    for (int i = 0; i < count; ++i)
+    {
+        const double e = east[i];
+        const double n = north[i];
+        const double u = up[i];
+
+        latitudes[i] = x0 - sinLambda * e - sinPhi * cosLambda * n + cosPhi * cosLambda * u;
+        longitudes[i] = y0 + cosLambda * e - sinPhi * sinLambda * n + cosPhi * sinLambda * u;
+        altitudes[i] = z0 + cosPhi * n + sinPhi * u;
+    }
+    ::fromEcef(latitudes, longitudes, altitudes, latitudes, longitudes, altitudes, count);
+}
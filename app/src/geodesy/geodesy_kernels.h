@@ -0,0 +1,49 @@
+#ifndef GEODESY_KERNELS_H
+#define GEODESY_KERNELS_H
+
+#include <QVector>
+
+#include "geodetic.h"
+
+namespace md::domain
+{
+// Structure-of-arrays positions, degrees and meters
+struct GeodeticArrays
+{
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    QVector<double> altitudes;
+
+    int count() const;
+    void reserve(int count);
+    void resize(int count);
+    void append(const Geodetic& position);
+    Geodetic at(int index) const;
+
+    static GeodeticArrays fromPositions(const QVector<Geodetic>& positions);
+    QVector<Geodetic> toPositions() const;
+};
+
+// Geodesic math over plain arrays, for the callers that handle positions in bulk
+namespace geodesy
+{
+constexpr double meanRadius = 6371008.8;
+
+// Great-circle distances between pairs of points, meters
+void haversine(const double* latitudes1, const double* longitudes1, const double* latitudes2,
+               const double* longitudes2, double* distances, int count);
+
+// Great-circle distances and initial bearings of consecutive legs, count - 1 values. Bearings in
+// degrees [0, 360) are optional
+void legs(const double* latitudes, const double* longitudes, double* distances,
+          double* bearings, int count);
+
+// Local east-north-up frame at the origin over the WGS84 ellipsoid
+void toEnu(const Geodetic& origin, const double* latitudes, const double* longitudes,
+           const double* altitudes, double* east, double* north, double* up, int count);
+void fromEnu(const Geodetic& origin, const double* east, const double* north, const double* up,
+             double* latitudes, double* longitudes, double* altitudes, int count);
+} // namespace geodesy
+} // namespace md::domain
+
+#endif // GEODESY_KERNELS_H
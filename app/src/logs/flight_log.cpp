@@ -0,0 +1,363 @@
+#include "flight_log.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFloat16>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QtEndian>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+constexpr char latitude[] = "latitude";
+constexpr char longitude[] = "longitude";
+constexpr char altitude[] = "altitude";
+constexpr char altitudeAmsl[] = "altitudeAmsl";
+constexpr char altitudeRelative[] = "altitudeRelative";
+constexpr char groundSpeed[] = "gs";
+constexpr char indicatedAirspeed[] = "ias";
+constexpr char climb[] = "climb";
+constexpr char course[] = "course";
+constexpr char heading[] = "heading";
+constexpr char roll[] = "roll";
+constexpr char pitch[] = "pitch";
+
+// MAVLink message ids
+constexpr quint32 attitudeId = 30;
+constexpr quint32 globalPositionIntId = 33;
+constexpr quint32 vfrHudId = 74;
+
+constexpr quint16 unknownHeading = 0xFFFF;
+constexpr int maxPayload = 255;
+
+float readFloat(const uchar* data)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(data);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+float readHalf(const uchar* data)
+{
+    const quint16 bits = qFromLittleEndian<quint16>(data);
+    qfloat16 value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double readDouble(const uchar* data)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(data);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double normalizedDegrees(double radians)
+{
+    const double degrees = qRadiansToDegrees(radians);
+    return degrees < 0 ? degrees + 360 : degrees;
+}
+} // namespace
+
+using namespace md::domain;
+
+FlightLog::FlightLog(const QString& path) : m_file(path)
+{
+}
+
+FlightLog::~FlightLog()
+{
+    this->close();
+}
+
+bool FlightLog::open()
+{
+    this->close();
+
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Can't open log" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_size ? m_file.map(0, m_size) : nullptr;
+    if (!m_data)
+    {
+        qWarning() << "Can't map log" << m_file.fileName() << m_file.errorString();
+        this->close();
+        return false;
+    }
+
+    const QString cachePath = FlightLogIndex::cachePath(m_file.fileName());
+    const qint64 modified = QFileInfo(m_file).lastModified().toMSecsSinceEpoch();
+    if (!m_index.load(cachePath, m_size, modified))
+    {
+        if (!m_index.build(m_data, m_size))
+        {
+            qWarning() << "Unknown log format" << m_file.fileName();
+            this->close();
+            return false;
+        }
+        m_index.save(cachePath, m_size, modified);
+    }
+
+    if (m_index.format() == FlightLogIndex::Tlog)
+    {
+        m_positionType = ::globalPositionIntId;
+        m_attitudeType = ::attitudeId;
+        m_hudType = ::vfrHudId;
+    }
+    else
+    {
+        m_positionType = m_index.dataFlashType("GPS");
+        if (!m_index.series(m_positionType))
+            m_positionType = m_index.dataFlashType("POS");
+        m_attitudeType = m_index.dataFlashType("ATT");
+        m_hudType = 0;
+    }
+    return true;
+}
+
+void FlightLog::close()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar*>(m_data));
+
+    m_data = nullptr;
+    m_size = 0;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool FlightLog::isOpen() const
+{
+    return m_data;
+}
+
+QString FlightLog::path() const
+{
+    return m_file.fileName();
+}
+
+const FlightLogIndex& FlightLog::index() const
+{
+    return m_index;
+}
+
+qint64 FlightLog::duration() const
+{
+    return m_index.duration();
+}
+
+QVariantMap FlightLog::sampleAt(qint64 time) const
+{
+    QVariantMap sample;
+    for (quint32 type : { m_positionType, m_attitudeType, m_hudType })
+    {
+        const Message message = this->messageAt(type, time);
+        if (!message.data)
+            continue;
+
+        if (m_index.format() == FlightLogIndex::Tlog)
+            this->decodeTlog(message, sample);
+        else
+            this->decodeDataFlash(message, sample);
+    }
+    return sample;
+}
+
+QJsonArray FlightLog::track(int maxPoints) const
+{
+    QJsonArray track;
+    const FlightLogIndex::Series* series = m_index.series(m_positionType);
+    if (!series || !m_data || maxPoints < 2)
+        return track;
+
+    const int count = series->offsets.count();
+    const double step = qMax(1.0, double(count - 1) / (maxPoints - 1));
+    for (double position = 0; position < count; position += step)
+    {
+        QVariantMap sample;
+        const Message message = this->message(m_positionType, int(position));
+        if (m_index.format() == FlightLogIndex::Tlog)
+            this->decodeTlog(message, sample);
+        else
+            this->decodeDataFlash(message, sample);
+
+        // Skip points before the position fix
+        const double latitude = sample.value(::latitude).toDouble();
+        const double longitude = sample.value(::longitude).toDouble();
+        if (qFuzzyIsNull(latitude) && qFuzzyIsNull(longitude))
+            continue;
+
+        track.append(QJsonObject({ { ::latitude, latitude },
+                                   { ::longitude, longitude },
+                                   { ::altitude, sample.value(::altitudeAmsl).toDouble() } }));
+    }
+    return track;
+}
+
+FlightLog::Message FlightLog::messageAt(quint32 type, qint64 time) const
+{
+    const FlightLogIndex::Series* series = m_index.series(type);
+    if (!series || series->times.isEmpty())
+        return Message();
+
+    const auto it = std::upper_bound(series->times.cbegin(), series->times.cend(), qint32(time));
+    const int index = qMax(0, int(it - series->times.cbegin()) - 1);
+    return this->message(type, index);
+}
+
+FlightLog::Message FlightLog::message(quint32 type, int index) const
+{
+    const FlightLogIndex::Series* series = m_index.series(type);
+    if (!m_data || !series || index < 0 || index >= series->offsets.count())
+        return Message();
+
+    const uchar* data = m_data + series->offsets.at(index);
+    Message message;
+    message.type = type;
+    if (m_index.format() == FlightLogIndex::Tlog)
+    {
+        message.data = data + (data[0] == 0xFD ? 10 : 6);
+        message.length = data[1];
+    }
+    else
+    {
+        message.data = data;
+        message.length = m_index.dataFlashFormat(type).length;
+    }
+
+    // Index was built for this exact file, but stay inside the mapping anyway
+    if (message.data + message.length > m_data + m_size)
+        return Message();
+    return message;
+}
+
+void FlightLog::decodeTlog(const Message& message, QVariantMap& sample) const
+{
+    // MAVLink 2 trims trailing zero bytes of payloads
+    uchar payload[::maxPayload] = {};
+    std::memcpy(payload, message.data, size_t(message.length));
+
+    switch (message.type)
+    {
+    case ::globalPositionIntId:
+    {
+        const double vx = qFromLittleEndian<qint16>(payload + 20) / 100.0;
+        const double vy = qFromLittleEndian<qint16>(payload + 22) / 100.0;
+        const double vz = qFromLittleEndian<qint16>(payload + 24) / 100.0;
+        const quint16 course = qFromLittleEndian<quint16>(payload + 26);
+
+        sample[::latitude] = qFromLittleEndian<qint32>(payload + 4) / 1e7;
+        sample[::longitude] = qFromLittleEndian<qint32>(payload + 8) / 1e7;
+        sample[::altitudeAmsl] = qFromLittleEndian<qint32>(payload + 12) / 1000.0;
+        sample[::altitudeRelative] = qFromLittleEndian<qint32>(payload + 16) / 1000.0;
+        sample[::groundSpeed] = qSqrt(vx * vx + vy * vy);
+        sample[::climb] = -vz;
+        if (course != ::unknownHeading)
+            sample[::course] = course / 100.0;
+        break;
+    }
+    case ::attitudeId:
+        sample[::roll] = qRadiansToDegrees(::readFloat(payload + 4));
+        sample[::pitch] = qRadiansToDegrees(::readFloat(payload + 8));
+        sample[::heading] = ::normalizedDegrees(::readFloat(payload + 12));
+        break;
+    case ::vfrHudId:
+        sample[::indicatedAirspeed] = ::readFloat(payload);
+        sample[::groundSpeed] = ::readFloat(payload + 4);
+        sample[::climb] = ::readFloat(payload + 12);
+        break;
+    default:
+        break;
+    }
+}
+
+void FlightLog::decodeDataFlash(const Message& message, QVariantMap& sample) const
+{
+    bool ok = false;
+    if (message.type == m_positionType)
+    {
+        sample[::latitude] = this->dataFlashField(message, "Lat");
+        sample[::longitude] = this->dataFlashField(message, "Lng");
+        sample[::altitudeAmsl] = this->dataFlashField(message, "Alt");
+
+        const double speed = this->dataFlashField(message, "Spd", &ok);
+        if (ok)
+            sample[::groundSpeed] = speed;
+        const double course = this->dataFlashField(message, "GCrs", &ok);
+        if (ok)
+            sample[::course] = course;
+        const double verticalSpeed = this->dataFlashField(message, "VZ", &ok);
+        if (ok)
+            sample[::climb] = -verticalSpeed;
+    }
+    else if (message.type == m_attitudeType)
+    {
+        sample[::roll] = this->dataFlashField(message, "Roll");
+        sample[::pitch] = this->dataFlashField(message, "Pitch");
+        sample[::heading] = this->dataFlashField(message, "Yaw");
+    }
+}
+
+double FlightLog::dataFlashField(const Message& message, const QString& label, bool* ok) const
+{
+    char type = 0;
+    const int offset = m_index.dataFlashFormat(message.type).fieldOffset(label, &type);
+    const bool valid = offset >= 0 &&
+                       offset + FlightLogIndex::fieldSize(type) <= message.length;
+    if (ok)
+        *ok = valid;
+    if (!valid)
+        return 0;
+
+    const uchar* field = message.data + offset;
+    switch (type)
+    {
+    case 'b':
+        return qint8(field[0]);
+    case 'B':
+    case 'M':
+        return field[0];
+    case 'h':
+        return qFromLittleEndian<qint16>(field);
+    case 'H':
+        return qFromLittleEndian<quint16>(field);
+    case 'c':
+        return qFromLittleEndian<qint16>(field) / 100.0;
+    case 'C':
+        return qFromLittleEndian<quint16>(field) / 100.0;
+    case 'i':
+        return qFromLittleEndian<qint32>(field);
+    case 'I':
+        return qFromLittleEndian<quint32>(field);
+    case 'e':
+        return qFromLittleEndian<qint32>(field) / 100.0;
+    case 'E':
+        return qFromLittleEndian<quint32>(field) / 100.0;
+    case 'L':
+        return qFromLittleEndian<qint32>(field) / 1e7;
+    case 'g':
+        return ::readHalf(field);
+    case 'f':
+        return ::readFloat(field);
+    case 'd':
+        return ::readDouble(field);
+    case 'q':
+        return double(qFromLittleEndian<qint64>(field));
+    case 'Q':
+        return double(qFromLittleEndian<quint64>(field));
+    default:
+        if (ok)
+            *ok = false;
+        return 0;
+    }
+}
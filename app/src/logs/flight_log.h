@@ -0,0 +1,58 @@
+#ifndef FLIGHT_LOG_H
+#define FLIGHT_LOG_H
+
+#include "flight_log_index.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QVariantMap>
+
+namespace md::domain
+{
+// Recorded .tlog or DataFlash .bin log, mapped into memory and decoded on demand by the index
+class FlightLog
+{
+public:
+    explicit FlightLog(const QString& path);
+    ~FlightLog();
+
+    // Loads the cached index or scans the log and caches it next to the file
+    bool open();
+    void close();
+
+    bool isOpen() const;
+    QString path() const;
+    const FlightLogIndex& index() const;
+    qint64 duration() const; // Milliseconds
+
+    // Latest position and attitude at the time, in telemetry properties
+    QVariantMap sampleAt(qint64 time) const;
+    // Evenly thinned flight path of latitude, longitude and altitude
+    QJsonArray track(int maxPoints) const;
+
+private:
+    struct Message
+    {
+        const uchar* data = nullptr;
+        int length = 0;
+        quint32 type = 0;
+    };
+
+    Message messageAt(quint32 type, qint64 time) const;
+    Message message(quint32 type, int index) const;
+
+    void decodeTlog(const Message& message, QVariantMap& sample) const;
+    void decodeDataFlash(const Message& message, QVariantMap& sample) const;
+    double dataFlashField(const Message& message, const QString& label, bool* ok = nullptr) const;
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    FlightLogIndex m_index;
+    quint32 m_positionType = 0;
+    quint32 m_attitudeType = 0;
+    quint32 m_hudType = 0;
+};
+} // namespace md::domain
+
+#endif // FLIGHT_LOG_H
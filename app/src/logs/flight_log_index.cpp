@@ -0,0 +1,369 @@
+#include "flight_log_index.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace
+{
+constexpr char cacheSuffix[] = ".idx";
+constexpr quint32 cacheMagic = 0x494c5244; // "DRLI"
+
+constexpr uchar tlogMagicV1 = 0xFE;
+constexpr uchar tlogMagicV2 = 0xFD;
+constexpr int tlogTimestampSize = 8;
+constexpr uchar tlogSignedFlag = 0x01;
+constexpr int tlogSignatureSize = 13;
+
+constexpr uchar dataFlashHead1 = 0xA3;
+constexpr uchar dataFlashHead2 = 0x95;
+constexpr int dataFlashHeaderSize = 3;
+constexpr quint32 dataFlashFmtType = 128;
+constexpr int dataFlashFmtLength = 89;
+
+constexpr char timeUs[] = "TimeUS";
+constexpr char timeMs[] = "TimeMS";
+
+// Next position of the byte from the offset or size, memchr is vectorized by the C library
+qint64 find(const uchar* data, qint64 size, qint64 offset, uchar byte)
+{
+    if (offset >= size)
+        return size;
+
+    const void* hit = std::memchr(data + offset, byte, size_t(size - offset));
+    return hit ? static_cast<const uchar*>(hit) - data : size;
+}
+
+QString fixedString(const uchar* data, int length)
+{
+    const char* chars = reinterpret_cast<const char*>(data);
+    return QString::fromLatin1(chars, int(qstrnlen(chars, uint(length))));
+}
+} // namespace
+
+using namespace md::domain;
+
+int FlightLogIndex::DataFlashFormat::fieldOffset(const QString& label, char* type) const
+{
+    int offset = ::dataFlashHeaderSize;
+    for (int i = 0; i < types.size() && i < labels.size(); ++i)
+    {
+        if (labels.at(i) == label)
+        {
+            if (type)
+                *type = types.at(i);
+            return offset;
+        }
+        offset += fieldSize(types.at(i));
+    }
+    return -1;
+}
+
+QString FlightLogIndex::cachePath(const QString& logPath)
+{
+    return logPath + ::cacheSuffix;
+}
+
+bool FlightLogIndex::build(const uchar* data, qint64 size)
+{
+    m_format = Unknown;
+    m_duration = 0;
+    m_count = 0;
+    m_series.clear();
+    m_formats.clear();
+
+    if (size >= ::dataFlashHeaderSize && data[0] == ::dataFlashHead1 && data[1] == ::dataFlashHead2)
+    {
+        m_format = DataFlash;
+        this->buildDataFlash(data, size);
+    }
+    else if (size > ::tlogTimestampSize && (data[::tlogTimestampSize] == ::tlogMagicV1 ||
+                                            data[::tlogTimestampSize] == ::tlogMagicV2))
+    {
+        m_format = Tlog;
+        this->buildTlog(data, size);
+    }
+    return m_count > 0;
+}
+
+bool FlightLogIndex::load(const QString& path, qint64 fileSize, qint64 modified)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic = 0, cacheVersion = 0;
+    qint64 cachedSize = 0, cachedModified = 0;
+    stream >> magic >> cacheVersion >> cachedSize >> cachedModified;
+    if (magic != ::cacheMagic || cacheVersion != version || cachedSize != fileSize ||
+        cachedModified != modified)
+        return false;
+
+    quint8 format = Unknown;
+    int formatCount = 0, seriesCount = 0;
+    stream >> format >> m_duration >> m_count >> formatCount;
+
+    m_formats.clear();
+    for (int i = 0; i < formatCount && stream.status() == QDataStream::Ok; ++i)
+    {
+        quint32 type = 0;
+        DataFlashFormat dataFlashFormat;
+        stream >> type >> dataFlashFormat.name >> dataFlashFormat.types >>
+            dataFlashFormat.labels >> dataFlashFormat.length;
+        m_formats.insert(type, dataFlashFormat);
+    }
+
+    stream >> seriesCount;
+    m_series.clear();
+    for (int i = 0; i < seriesCount && stream.status() == QDataStream::Ok; ++i)
+    {
+        quint32 type = 0;
+        Series series;
+        stream >> type >> series.offsets >> series.times;
+        m_series.insert(type, series);
+    }
+
+    m_format = Format(format);
+    return stream.status() == QDataStream::Ok && m_format != Unknown;
+}
+
+bool FlightLogIndex::save(const QString& path, qint64 fileSize, qint64 modified) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Can't cache log index" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << ::cacheMagic << version << fileSize << modified << quint8(m_format) << m_duration
+           << m_count << m_formats.count();
+
+    for (auto it = m_formats.constBegin(); it != m_formats.constEnd(); ++it)
+    {
+        stream << it.key() << it->name << it->types << it->labels << it->length;
+    }
+
+    stream << m_series.count();
+    for (auto it = m_series.constBegin(); it != m_series.constEnd(); ++it)
+    {
+        stream << it.key() << it->offsets << it->times;
+    }
+    return file.commit();
+}
+
+FlightLogIndex::Format FlightLogIndex::format() const
+{
+    return m_format;
+}
+
+qint64 FlightLogIndex::duration() const
+{
+    return m_duration;
+}
+
+int FlightLogIndex::messageCount() const
+{
+    return m_count;
+}
+
+const FlightLogIndex::Series* FlightLogIndex::series(quint32 type) const
+{
+    auto it = m_series.constFind(type);
+    return it != m_series.constEnd() ? &it.value() : nullptr;
+}
+
+quint32 FlightLogIndex::dataFlashType(const QString& name) const
+{
+    for (auto it = m_formats.constBegin(); it != m_formats.constEnd(); ++it)
+    {
+        if (it->name == name)
+            return it.key();
+    }
+    return 0;
+}
+
+FlightLogIndex::DataFlashFormat FlightLogIndex::dataFlashFormat(quint32 type) const
+{
+    return m_formats.value(type);
+}
+
+void FlightLogIndex::buildTlog(const uchar* data, qint64 size)
+{
+    // Each record is a big-endian microseconds timestamp followed by a MAVLink v1 or v2 frame
+    qint64 nextV1 = ::find(data, size, ::tlogTimestampSize, ::tlogMagicV1);
+    qint64 nextV2 = ::find(data, size, ::tlogTimestampSize, ::tlogMagicV2);
+    qint64 start = -1;
+    qint64 position = ::tlogTimestampSize;
+
+    while (position < size)
+    {
+        if (nextV1 < position)
+            nextV1 = ::find(data, size, position, ::tlogMagicV1);
+        if (nextV2 < position)
+            nextV2 = ::find(data, size, position, ::tlogMagicV2);
+
+        const qint64 frame = qMin(nextV1, nextV2);
+        if (frame >= size)
+            break;
+
+        const uchar* header = data + frame;
+        const bool v2 = header[0] == ::tlogMagicV2;
+        if (frame + (v2 ? 10 : 6) > size)
+            break;
+
+        const int length = header[1];
+        const quint32 messageId = v2 ? header[7] | header[8] << 8 | header[9] << 16 : header[5];
+        const qint64 end = frame + (v2 ? 12 + length : 8 + length) +
+                           (v2 && (header[2] & ::tlogSignedFlag) ? ::tlogSignatureSize : 0);
+
+        // Without CRC extras frames are checked by the next record starting right after
+        const qint64 next = end + ::tlogTimestampSize;
+        const bool valid = end <= size &&
+                           (next >= size || data[next] == ::tlogMagicV1 ||
+                            data[next] == ::tlogMagicV2);
+        if (frame < ::tlogTimestampSize || !valid)
+        {
+            position = frame + 1;
+            continue;
+        }
+
+        const qint64 timestamp = qFromBigEndian<quint64>(header - ::tlogTimestampSize);
+        if (start < 0)
+            start = timestamp;
+
+        this->append(messageId, frame, (timestamp - start) / 1000);
+        position = next;
+    }
+}
+
+void FlightLogIndex::buildDataFlash(const uchar* data, qint64 size)
+{
+    QHash<quint32, QPair<int, bool>> timeFields; // Offset and whether it is in milliseconds
+    qint64 start = -1;
+    qint64 time = 0;
+    qint64 position = 0;
+
+    while (position + ::dataFlashHeaderSize <= size)
+    {
+        const qint64 message = ::find(data, size, position, ::dataFlashHead1);
+        if (message + ::dataFlashHeaderSize > size)
+            break;
+
+        const uchar* header = data + message;
+        if (header[1] != ::dataFlashHead2)
+        {
+            position = message + 1;
+            continue;
+        }
+
+        const quint32 type = header[2];
+        if (type == ::dataFlashFmtType)
+        {
+            if (message + ::dataFlashFmtLength > size)
+                break;
+
+            DataFlashFormat format;
+            format.length = header[4];
+            format.name = ::fixedString(header + 5, 4);
+            format.types = ::fixedString(header + 9, 16).toLatin1();
+            format.labels = ::fixedString(header + 25, 64).split(',');
+            m_formats.insert(header[3], format);
+
+            char timeType = 0;
+            int offset = format.fieldOffset(::timeUs, &timeType);
+            if (offset > 0 && (timeType == 'Q' || timeType == 'q'))
+            {
+                timeFields.insert(header[3], { offset, false });
+            }
+            else if ((offset = format.fieldOffset(::timeMs, &timeType)) > 0 && timeType == 'I')
+            {
+                timeFields.insert(header[3], { offset, true });
+            }
+
+            position = message + ::dataFlashFmtLength;
+            continue;
+        }
+
+        auto format = m_formats.constFind(type);
+        if (format == m_formats.constEnd() || format->length < ::dataFlashHeaderSize)
+        {
+            position = message + 1;
+            continue;
+        }
+        if (message + format->length > size)
+            break;
+
+        // Messages without own timestamps take the latest one
+        auto timeField = timeFields.constFind(type);
+        if (timeField != timeFields.constEnd())
+        {
+            const bool milliseconds = timeField->second;
+            const uchar* field = header + timeField->first;
+            if (timeField->first + (milliseconds ? 4 : 8) <= format->length)
+                time = milliseconds ? qint64(qFromLittleEndian<quint32>(field))
+                                    : qint64(qFromLittleEndian<quint64>(field) / 1000);
+            if (start < 0)
+                start = time;
+        }
+
+        this->append(type, message, start < 0 ? 0 : time - start);
+        position = message + format->length;
+    }
+}
+
+void FlightLogIndex::append(quint32 type, qint64 offset, qint64 time)
+{
+    Series& series = m_series[type];
+    if (!series.times.isEmpty())
+        time = qMax<qint64>(time, series.times.constLast());
+    time = qMax<qint64>(time, 0);
+
+    series.offsets.append(offset);
+    series.times.append(qint32(time));
+
+    m_duration = qMax(m_duration, time);
+    m_count++;
+}
+
+int FlightLogIndex::fieldSize(char type)
+{
+    switch (type)
+    {
+    case 'b':
+    case 'B':
+    case 'M':
+        return 1;
+    case 'h':
+    case 'H':
+    case 'c':
+    case 'C':
+    case 'g':
+        return 2;
+    case 'i':
+    case 'I':
+    case 'f':
+    case 'n':
+    case 'e':
+    case 'E':
+    case 'L':
+        return 4;
+    case 'd':
+    case 'q':
+    case 'Q':
+        return 8;
+    case 'N':
+        return 16;
+    case 'Z':
+    case 'a':
+        return 64;
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef FLIGHT_LOG_INDEX_H
+#define FLIGHT_LOG_INDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace md::domain
+{
+// Offsets and timestamps of every message in a .tlog or DataFlash .bin log, per message type
+class FlightLogIndex
+{
+public:
+    enum Format : quint8
+    {
+        Unknown,
+        Tlog,
+        DataFlash
+    };
+
+    // Field layout of a DataFlash message type, taken from its FMT message
+    struct DataFlashFormat
+    {
+        QString name;
+        QByteArray types;
+        QStringList labels;
+        int length = 0;
+
+        // Offset of the field from the message start or -1
+        int fieldOffset(const QString& label, char* type = nullptr) const;
+    };
+
+    struct Series
+    {
+        QVector<qint64> offsets;
+        QVector<qint32> times; // Milliseconds from the log start, non-decreasing
+    };
+
+    static constexpr quint32 version = 1;
+
+    static QString cachePath(const QString& logPath);
+    // Size of a DataFlash field by its format character
+    static int fieldSize(char type);
+
+    // Builds the index scanning the whole mapped log once
+    bool build(const uchar* data, qint64 size);
+
+    // Cached index is valid only for the same file size and modification time
+    bool load(const QString& path, qint64 fileSize, qint64 modified);
+    bool save(const QString& path, qint64 fileSize, qint64 modified) const;
+
+    Format format() const;
+    qint64 duration() const; // Milliseconds
+    int messageCount() const;
+
+    const Series* series(quint32 type) const;
+    // DataFlash message type by its name, e.g. GPS
+    quint32 dataFlashType(const QString& name) const;
+    DataFlashFormat dataFlashFormat(quint32 type) const;
+
+private:
+    void buildTlog(const uchar* data, qint64 size);
+    void buildDataFlash(const uchar* data, qint64 size);
+    void append(quint32 type, qint64 offset, qint64 time);
+
+    Format m_format = Unknown;
+    qint64 m_duration = 0;
+    int m_count = 0;
+    QHash<quint32, Series> m_series;
+    QHash<quint32, DataFlashFormat> m_formats;
+};
+} // namespace md::domain
+
+#endif // FLIGHT_LOG_INDEX_H
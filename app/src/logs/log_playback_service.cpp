@@ -0,0 +1,213 @@
+#include "log_playback_service.h"
+
+#include <QDebug>
+#include <QtConcurrent>
+
+namespace
+{
+constexpr double minRate = 0.1;
+constexpr double maxRate = 64.0;
+} // namespace
+
+using namespace md::domain;
+
+LogPlaybackService::LogPlaybackService(IPropertyTree* pTree, QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree)
+{
+    connect(&m_watcher, &QFutureWatcher<Loaded>::finished, this, &LogPlaybackService::onLoaded);
+
+    m_timer.setInterval(tickInterval);
+    connect(&m_timer, &QTimer::timeout, this, &LogPlaybackService::onTick);
+}
+
+bool LogPlaybackService::isLoading() const
+{
+    return m_watcher.isRunning();
+}
+
+bool LogPlaybackService::isOpen() const
+{
+    return m_log;
+}
+
+QString LogPlaybackService::path() const
+{
+    return m_path;
+}
+
+QVariant LogPlaybackService::vehicleId() const
+{
+    return m_vehicleId;
+}
+
+QString LogPlaybackService::nodeId() const
+{
+    return m_vehicleId.isNull() ? QString() : nodePrefix + m_vehicleId.toString();
+}
+
+QJsonArray LogPlaybackService::track() const
+{
+    return m_track;
+}
+
+qint64 LogPlaybackService::duration() const
+{
+    return m_log ? m_log->duration() : 0;
+}
+
+qint64 LogPlaybackService::time() const
+{
+    return m_time;
+}
+
+bool LogPlaybackService::isPlaying() const
+{
+    return m_timer.isActive();
+}
+
+double LogPlaybackService::rate() const
+{
+    return m_rate;
+}
+
+void LogPlaybackService::open(const QString& path, const QVariant& vehicleId)
+{
+    this->close();
+
+    m_path = path;
+    m_vehicleId = vehicleId;
+
+    // Scanning a large log takes seconds on the first open, later the cached index is read
+    m_watcher.setFuture(QtConcurrent::run([path]() {
+        Loaded loaded;
+        loaded.log.reset(new FlightLog(path));
+        if (!loaded.log->open())
+            return Loaded();
+
+        loaded.track = loaded.log->track(trackPoints);
+        return loaded;
+    }));
+    emit logChanged();
+}
+
+void LogPlaybackService::close()
+{
+    this->pause();
+    this->clearNode();
+
+    m_log.clear();
+    m_track = QJsonArray();
+    m_path.clear();
+    m_vehicleId.clear();
+    m_time = 0;
+    emit logChanged();
+    emit timeChanged(m_time);
+}
+
+void LogPlaybackService::play()
+{
+    if (!m_log || m_timer.isActive())
+        return;
+
+    if (m_time >= m_log->duration())
+        m_time = 0;
+
+    m_clock.start();
+    m_timer.start();
+    emit playingChanged(true);
+}
+
+void LogPlaybackService::pause()
+{
+    if (!m_timer.isActive())
+        return;
+
+    m_timer.stop();
+    emit playingChanged(false);
+}
+
+void LogPlaybackService::seek(qint64 time)
+{
+    if (!m_log)
+        return;
+
+    m_time = qBound<qint64>(0, time, m_log->duration());
+    this->publish();
+}
+
+void LogPlaybackService::setRate(double rate)
+{
+    rate = qBound(::minRate, rate, ::maxRate);
+    if (qFuzzyCompare(m_rate, rate))
+        return;
+
+    m_rate = rate;
+    emit rateChanged(rate);
+}
+
+void LogPlaybackService::onLoaded()
+{
+    // Closed while loading, listeners still wait for the loading to end
+    if (m_path.isEmpty())
+    {
+        emit logChanged();
+        return;
+    }
+
+    const Loaded loaded = m_watcher.result();
+    if (!loaded.log)
+    {
+        qWarning() << "Can't play log" << m_path;
+        m_path.clear();
+        emit logChanged();
+        return;
+    }
+
+    m_log = loaded.log;
+    m_track = loaded.track;
+    emit logChanged();
+
+    this->seek(0);
+}
+
+void LogPlaybackService::onTick()
+{
+    m_time += qint64(m_clock.restart() * m_rate);
+    if (m_time >= m_log->duration())
+    {
+        m_time = m_log->duration();
+        this->pause();
+    }
+    this->publish();
+}
+
+void LogPlaybackService::publish()
+{
+    const QString nodeId = this->nodeId();
+    if (!nodeId.isEmpty())
+    {
+        const QVariantMap sample = m_log->sampleAt(m_time);
+        for (auto it = sample.constBegin(); it != sample.constEnd(); ++it)
+        {
+            m_published.insert(it.key());
+        }
+        m_pTree->appendProperties(nodeId, sample);
+    }
+
+    emit timeChanged(m_time);
+}
+
+void LogPlaybackService::clearNode()
+{
+    if (m_published.isEmpty())
+        return;
+
+    QVariantMap cleared;
+    for (const QString& key : qAsConst(m_published))
+    {
+        cleared.insert(key, QVariant());
+    }
+    m_published.clear();
+    m_pTree->appendProperties(this->nodeId(), cleared);
+}
@@ -0,0 +1,80 @@
+#ifndef LOG_PLAYBACK_SERVICE_H
+#define LOG_PLAYBACK_SERVICE_H
+
+#include "flight_log.h"
+#include "i_property_tree.h"
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QSet>
+#include <QSharedPointer>
+#include <QTimer>
+
+namespace md::domain
+{
+// Replays a recorded log as a vehicle of its own, the live vehicle node is never touched
+class LogPlaybackService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int tickInterval = 50;
+    static constexpr int trackPoints = 2000;
+    static constexpr char nodePrefix[] = "playback/";
+
+    explicit LogPlaybackService(IPropertyTree* pTree, QObject* parent = nullptr);
+
+    bool isLoading() const;
+    bool isOpen() const;
+    QString path() const;
+    QVariant vehicleId() const;
+    QString nodeId() const; // Property tree node of the replay, empty if closed
+    QJsonArray track() const;
+
+    qint64 duration() const; // Milliseconds
+    qint64 time() const;
+    bool isPlaying() const;
+    double rate() const;
+
+public slots:
+    void open(const QString& path, const QVariant& vehicleId);
+    void close();
+
+    void play();
+    void pause();
+    void seek(qint64 time);
+    void setRate(double rate);
+
+signals:
+    void logChanged();
+    void timeChanged(qint64 time);
+    void playingChanged(bool playing);
+    void rateChanged(double rate);
+
+private:
+    struct Loaded
+    {
+        QSharedPointer<FlightLog> log;
+        QJsonArray track;
+    };
+
+    void onLoaded();
+    void onTick();
+    void publish();
+    void clearNode();
+
+    IPropertyTree* const m_pTree;
+    QFutureWatcher<Loaded> m_watcher;
+    QSharedPointer<FlightLog> m_log;
+    QJsonArray m_track;
+    QString m_path;
+    QVariant m_vehicleId;
+    QSet<QString> m_published; // Properties to clear on close
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_time = 0;
+    double m_rate = 1.0;
+};
+} // namespace md::domain
+
+#endif // LOG_PLAYBACK_SERVICE_H
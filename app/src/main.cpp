@@ -14,9 +14,14 @@
 //     You should have received a copy of the GNU General Public License
 //     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <QCommandLineParser>
+#include <QFutureWatcher>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include <QQmlComponent>
+#include <QQuickWebEngineProfile>
 #include <QVersionNumber>
+#include <QtConcurrent>
 #include <QtWebEngine>
 
 // Data source
@@ -26,17 +31,35 @@
 #include "vehicles_repository_sql.h"
 
 // Domain
+#include "airspace_service.h"
+#include "command_pipeline.h"
 #include "command_service.h"
+#include "elevation_service.h"
+#include "ftp_transfer_service.h"
 #include "gui_layout.h"
 #include "locator.h"
+#include "log_download_service.h"
+#include "log_playback_service.h"
+#include "mission_operation_scheduler.h"
+#include "mission_statistics_service.h"
+#include "mission_sync_service.h"
+#include "mission_validation_service.h"
 #include "missions_service.h"
 #include "property_tree.h"
+#include "telemetry_rate_service.h"
+#include "timer_wheel.h"
+#include "traffic_conflict_service.h"
+#include "traffic_service.h"
 #include "vehicle_missions.h"
 #include "vehicles_features.h"
 #include "vehicles_service.h"
 
 // App
 #include "communication_service.h"
+#include "core_client.h"
+#include "core_server.h"
+#include "telemetry_shm_exporter.h"
+#include "telemetry_socket_server.h"
 #include "module_loader.h"
 #include "theme.h"
 #include "theme_activator.h"
@@ -50,6 +73,7 @@
 #include "map_ruler_controller.h"
 #include "map_viewport_controller.h"
 
+#include "log_playback_controller.h"
 #include "vehicle_dashboard_controller.h"
 #include "vehicle_list_contoller.h"
 #include "vehicle_mission_controller.h"
@@ -62,16 +86,68 @@
 #include "missions_map_controller.h"
 #include "missions_menu_controller.h"
 
+#include "file_prefetcher.h"
+#include "startup_report.h"
+#include "web_pack_scheme_handler.h"
+
 namespace
 {
 constexpr char gitRevision[] = "git_revision";
 constexpr char databaseName[] = "dreka.db";
+constexpr char webPackName[] = "/web.pack";
+constexpr char webIndexPath[] = "web/index.html";
+constexpr char webFilesEnv[] = "DREKA_WEB_FILES"; // Force loading web from plain files
+constexpr char modulesDir[] = "/modules";
+constexpr char terrainPath[] = "./terrain";
+constexpr char airspacePath[] = "./airspaces.json";
+
+constexpr char headlessOption[] = "headless";
+constexpr char attachOption[] = "attach";
+constexpr char coreOption[] = "core";
+constexpr char defaultCoreName[] = "dreka-core";
+constexpr char telemetryPortOption[] = "telemetry-port";
+constexpr char telemetryShmOption[] = "telemetry-shm";
+constexpr char platformEnv[] = "QT_QPA_PLATFORM";
+
+constexpr char phasePrefetch[] = "prefetch";
+constexpr char phaseSchema[] = "schema";
+constexpr char phaseModuleLibraries[] = "module libraries";
+constexpr char phaseWebEngine[] = "web engine";
+constexpr char phaseTheme[] = "theme";
+constexpr char phaseQmlCompile[] = "qml compile";
+constexpr char phaseModules[] = "modules";
+constexpr char phaseDatabase[] = "database";
+constexpr char phaseWindow[] = "window";
+constexpr char phaseMap[] = "map";
 } // namespace
 
 using namespace md;
 
 int main(int argc, char* argv[])
 {
+    // Core runs links and services without GUI, GUIs attach to it and survive its restarts
+    QCommandLineParser parser;
+    parser.addOptions({ { ::headlessOption, "Run the core only, for GUIs to attach" },
+                        { ::attachOption,
+                          "Attach the GUI to a running headless core. Vehicles and missions are "
+                          "read from the database once, mission operations run in the core" },
+                        { ::coreOption, "Name of the core socket", "name", ::defaultCoreName },
+                        { ::telemetryPortOption, "Serve telemetry to WebSocket clients on the port",
+                          "port" },
+                        { ::telemetryShmOption, "Export vehicle states to the shared memory",
+                          "name", DREKA_SHM_NAME } });
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+    {
+        arguments.append(QString::fromLocal8Bit(argv[i]));
+    }
+    parser.parse(arguments);
+    const bool headless = parser.isSet(::headlessOption);
+    const bool attach = !headless && parser.isSet(::attachOption);
+
+    if (headless && !qEnvironmentVariableIsSet(::platformEnv))
+        qputenv(::platformEnv, "offscreen");
+
     qputenv("QTWEBENGINE_CHROMIUM_FLAGS", "--ignore-gpu-blacklist");
 
     QCoreApplication::setOrganizationName("Midgrad");
@@ -82,15 +158,34 @@ int main(int argc, char* argv[])
     QGuiApplication::setAttribute(Qt::AA_UseHighDpiPixmaps, true);
     QGuiApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
 
+    app::WebPackSchemeHandler::registerScheme();
+
     QGuiApplication app(argc, argv);
     app.setProperty(::gitRevision, QString(GIT_REVISION));
     app.setWindowIcon(QIcon(":/icons/dreka.svg"));
 
+    app::StartupReport startupReport;
+    const QString appDir = QGuiApplication::applicationDirPath();
+
+    // Warm up files read later on the main thread and by the web engine
+    startupReport.beginOnWorker(::phasePrefetch);
+    QFutureWatcher<qint64> prefetchWatcher;
+    QObject::connect(&prefetchWatcher, &QFutureWatcher<qint64>::finished, &startupReport, [&]() {
+        startupReport.end(::phasePrefetch);
+    });
+    prefetchWatcher.setFuture(
+        app::FilePrefetcher::prefetch({ ::databaseName, appDir + ::webPackName }));
+
     // Data source initialization
+    startupReport.begin(::phaseSchema);
     data_source::SqliteSchema schema(::databaseName);
     schema.setup();
+    startupReport.end(::phaseSchema);
 
     // Domain services initialization
+    domain::TimerWheel timerWheel;
+    app::Locator::provide<domain::TimerWheel>(&timerWheel);
+
     data_source::VehiclesRepositorySql vehiclesRepository(schema.db());
     domain::VehiclesService vehiclesService(&vehiclesRepository);
     app::Locator::provide<domain::IVehiclesService>(&vehiclesService);
@@ -103,6 +198,18 @@ int main(int argc, char* argv[])
     domain::MissionsService missionsService(&missionsRepository, &missionItemsRepository);
     app::Locator::provide<domain::IMissionsService>(&missionsService);
 
+    domain::MissionStatisticsService missionStatistics(&missionsService);
+    app::Locator::provide<domain::MissionStatisticsService>(&missionStatistics);
+
+    domain::MissionValidationService missionValidation(&missionsService);
+    app::Locator::provide<domain::MissionValidationService>(&missionValidation);
+
+    domain::MissionOperationScheduler missionScheduler(&missionsService);
+    app::Locator::provide<domain::MissionOperationScheduler>(&missionScheduler);
+
+    domain::MissionSyncService missionSync(&missionsService);
+    app::Locator::provide<domain::MissionSyncService>(&missionSync);
+
     domain::VehicleMissions vehicleMissions(&missionsService, &vehiclesService);
     app::Locator::provide<domain::IVehicleMissions>(&vehicleMissions);
 
@@ -112,17 +219,116 @@ int main(int argc, char* argv[])
     domain::CommandsService commandsService;
     app::Locator::provide<domain::ICommandsService>(&commandsService);
 
+    domain::CommandPipeline commandPipeline(&commandsService, &timerWheel);
+    app::Locator::provide<domain::CommandPipeline>(&commandPipeline);
+
+    domain::ElevationService elevationService(::terrainPath);
+    app::Locator::provide<domain::IElevationService>(&elevationService);
+
+    domain::TrafficService trafficService(&timerWheel);
+    app::Locator::provide<domain::TrafficService>(&trafficService);
+
+    domain::AirspaceService airspaceService(&pTree, &trafficService, ::airspacePath);
+    app::Locator::provide<domain::AirspaceService>(&airspaceService);
+
+    domain::TrafficConflictService trafficConflicts(&pTree, &vehiclesService, &trafficService);
+    app::Locator::provide<domain::TrafficConflictService>(&trafficConflicts);
+
+    domain::LogDownloadService logDownloads;
+    app::Locator::provide<domain::LogDownloadService>(&logDownloads);
+
+    domain::FtpTransferService ftpTransfers;
+    app::Locator::provide<domain::FtpTransferService>(&ftpTransfers);
+
+    domain::LogPlaybackService logPlayback(&pTree);
+    app::Locator::provide<domain::LogPlaybackService>(&logPlayback);
+
+    domain::TelemetryRateService telemetryRates(&vehiclesService, &pTree);
+    app::Locator::provide<domain::TelemetryRateService>(&telemetryRates);
+
     presentation::GuiLayout layout;
     app::Locator::provide<presentation::IGuiLayout>(&layout);
 
-    // app layer initializaion
-    // TODO: remove json after sql implementation
-    app::CommunicationService communicationService("./link_config.json");
-    app::Locator::provide<app::CommunicationService>(&communicationService);
+    // app layer initializaion, an attached GUI leaves links to the core
+    QScopedPointer<app::CommunicationService> communicationService;
+    QScopedPointer<app::CoreClient> coreClient;
+    if (attach)
+    {
+        coreClient.reset(
+            new app::CoreClient(&pTree, &commandPipeline, &missionsService, &telemetryRates));
+        coreClient->attach(parser.value(::coreOption));
+    }
+    else
+    {
+        // TODO: remove json after sql implementation
+        // Frames are routed between links in the link layer, the app only sees decoded state
+        communicationService.reset(new app::CommunicationService("./link_config.json"));
+        app::Locator::provide<app::CommunicationService>(communicationService.data());
+    }
+
+    // Other consoles in the room read the same telemetry without their own links
+    QScopedPointer<app::TelemetrySocketServer> telemetryServer;
+    if (parser.isSet(::telemetryPortOption))
+    {
+        telemetryServer.reset(
+            new app::TelemetrySocketServer(&pTree, &vehiclesService, &missionsService));
+        telemetryServer->listen(parser.value(::telemetryPortOption).toUShort());
+    }
+
+    // Companion processes map vehicle states directly, see dreka_telemetry_shm.h
+    QScopedPointer<app::TelemetryShmExporter> telemetryExporter;
+    if (parser.isSet(::telemetryShmOption))
+    {
+        telemetryExporter.reset(new app::TelemetryShmExporter(&pTree, &vehiclesService));
+        telemetryExporter->open(parser.value(::telemetryShmOption));
+    }
+
+    if (headless)
+    {
+        app::CoreServer coreServer(&pTree, &commandPipeline, &telemetryRates, &vehiclesService,
+                                   &missionsService);
+        if (!coreServer.listen(parser.value(::coreOption)))
+            return 1;
+
+        app::ModuleLoader moduleLoader;
+        moduleLoader.discoverModules();
+        moduleLoader.loadModules();
+
+        missionsService.readAll();
+        vehiclesService.readAll();
+
+        QObject::connect(&app, &QGuiApplication::aboutToQuit, &moduleLoader,
+                         &app::ModuleLoader::unloadAllModules);
+        return app.exec();
+    }
+
+    // Module libraries are loaded on a worker while the main thread prepares the presentation,
+    // modules are created on the main thread later
+    QFuture<void> moduleLibraries;
+    if (!attach)
+    {
+        startupReport.beginOnWorker(::phaseModuleLibraries);
+        moduleLibraries = QtConcurrent::run([&startupReport, appDir]() {
+            app::FilePrefetcher::loadLibraries({ appDir + ::modulesDir });
+            startupReport.end(::phaseModuleLibraries);
+        });
+    }
 
     // Presentation initialization
+    startupReport.begin(::phaseWebEngine);
     QtWebEngine::initialize();
 
+    // Serve web and Cesium from the pack, fallback to the plain files
+    QUrl webIndexUrl = QUrl::fromLocalFile(appDir + '/' + ::webIndexPath);
+    app::WebPackSchemeHandler webPack(appDir + ::webPackName);
+    if (webPack.isOpen() && !qEnvironmentVariableIsSet(::webFilesEnv))
+    {
+        QQuickWebEngineProfile::defaultProfile()->installUrlSchemeHandler(
+            app::WebPackSchemeHandler::scheme, &webPack);
+        webIndexUrl = webPack.url(::webIndexPath);
+    }
+    startupReport.end(::phaseWebEngine);
+
     // TODO: unify registrations
     qmlRegisterType<presentation::MapViewportController>("Dreka", 1, 0, "MapViewportController");
     qmlRegisterType<presentation::MapRulerController>("Dreka", 1, 0, "MapRulerController");
@@ -139,6 +345,8 @@ int main(int argc, char* argv[])
                                                          "VehiclesMapController");
     qmlRegisterType<presentation::VehicleMissionController>("Dreka.Vehicles", 1, 0,
                                                             "VehicleMissionController");
+    qmlRegisterType<presentation::LogPlaybackController>("Dreka.Vehicles", 1, 0,
+                                                         "LogPlaybackController");
 
     qmlRegisterType<presentation::MissionsMapController>("Dreka.Missions", 1, 0,
                                                          "MissionsMapController");
@@ -153,6 +361,7 @@ int main(int argc, char* argv[])
     qmlRegisterType<presentation::MissionsMenuController>("Dreka.Missions", 1, 0,
                                                           "MissionsMenuController");
 
+    startupReport.begin(::phaseTheme);
     QQmlApplicationEngine engine;
     industrialThemeActivate(true, &engine);
 
@@ -164,21 +373,63 @@ int main(int argc, char* argv[])
 
     // Industrial Indicators
     Q_INIT_RESOURCE(industrial_indicators_qml);
-
-    // App modules initialization
+    startupReport.end(::phaseTheme);
+
+    // Compile main window on the QML loader thread, while modules and data are loading
+    startupReport.beginOnWorker(::phaseQmlCompile);
+    QQmlComponent mainWindow(&engine, QUrl(QStringLiteral("qrc:/MainWindow.qml")),
+                             QQmlComponent::Asynchronous);
+    auto endQmlCompile = [&](QQmlComponent::Status status) {
+        if (status == QQmlComponent::Ready)
+            startupReport.end(::phaseQmlCompile);
+    };
+    QObject::connect(&mainWindow, &QQmlComponent::statusChanged, &startupReport, endQmlCompile);
+    endQmlCompile(mainWindow.status());
+
+    // App modules initialization, stored data needs the types modules register
+    moduleLibraries.waitForFinished();
+    startupReport.begin(::phaseModules);
     app::ModuleLoader moduleLoader;
-    moduleLoader.discoverModules();
-    moduleLoader.loadModules();
+    if (!attach)
+    {
+        moduleLoader.discoverModules();
+        moduleLoader.loadModules();
+    }
+    startupReport.end(::phaseModules);
 
     // TODO: soft caching, read only on demand
+    startupReport.begin(::phaseDatabase);
     missionsService.readAll();
     vehiclesService.readAll();
+    startupReport.end(::phaseDatabase);
 
     engine.rootContext()->setContextProperty("layout", layout.items());
-    engine.rootContext()->setContextProperty("applicationDirPath",
-                                             QGuiApplication::applicationDirPath());
-
-    engine.load(QUrl(QStringLiteral("qrc:/MainWindow.qml")));
+    engine.rootContext()->setContextProperty("applicationDirPath", appDir);
+    engine.rootContext()->setContextProperty("webIndexUrl", webIndexUrl);
+    engine.rootContext()->setContextProperty("startupReport", &startupReport);
+    engine.rootContext()->setContextProperty("startupMapPhase", QString(::phaseMap));
+
+    // Window is created as soon as both compilation and data loading are done
+    QScopedPointer<QObject> window;
+    auto createWindow = [&]() {
+        if (mainWindow.isLoading() || window)
+            return;
+
+        if (mainWindow.isError())
+        {
+            qWarning() << mainWindow.errors();
+            return;
+        }
+
+        startupReport.begin(::phaseWindow);
+        window.reset(mainWindow.create());
+        startupReport.end(::phaseWindow);
+
+        // Finished by the map, when the web page is loaded
+        startupReport.begin(::phaseMap);
+    };
+    QObject::connect(&mainWindow, &QQmlComponent::statusChanged, &engine, createWindow);
+    createWindow();
 
     QObject::connect(&app, &QGuiApplication::aboutToQuit, &moduleLoader,
                      &app::ModuleLoader::unloadAllModules);
@@ -3,6 +3,8 @@
 #include <QDebug>
 #include <QSettings>
 
+#include "locator.h"
+
 namespace viewport_settings
 {
 constexpr char camera[] = "viewport/camera";
@@ -16,8 +18,11 @@ constexpr float defaultPitch = -15.0;
 
 using namespace md::presentation;
 
-MapViewportController::MapViewportController(QObject* parent) : QObject(parent)
+MapViewportController::MapViewportController(QObject* parent) :
+    QObject(parent),
+    m_rates(md::app::Locator::get<md::domain::TelemetryRateService>())
 {
+    Q_ASSERT(m_rates);
 }
 
 QJsonObject MapViewportController::cursorPosition() const
@@ -87,12 +92,14 @@ void MapViewportController::setCursorPosition(const QJsonObject& cursorPosition)
 void MapViewportController::setCenterPosition(const QJsonObject& centerPosition)
 {
     m_centerPosition = md::domain::Geodetic(centerPosition.toVariantMap());
+    m_rates->setViewport(m_centerPosition, m_cameraPosition);
     emit centerPositionChanged();
 }
 
 void MapViewportController::setCameraPosition(const QJsonObject& cameraPosition)
 {
     m_cameraPosition = md::domain::Geodetic(cameraPosition.toVariantMap());
+    m_rates->setViewport(m_centerPosition, m_cameraPosition);
     emit cameraPositionChanged();
 }
 
@@ -5,6 +5,7 @@
 #include <QObject>
 
 #include "geodetic.h"
+#include "telemetry_rate_service.h"
 
 namespace md::presentation
 {
@@ -59,6 +60,8 @@ signals:
     void lookTo(float heading, float pitch, float duration = 0.0);
 
 private:
+    md::domain::TelemetryRateService* const m_rates;
+
     md::domain::Geodetic m_cursorPosition;
     md::domain::Geodetic m_centerPosition;
     md::domain::Geodetic m_cameraPosition;
@@ -10,10 +10,31 @@ using namespace md::presentation;
 MissionEditController::MissionEditController(QObject* parent) :
     QObject(parent),
     m_missions(md::app::Locator::get<IMissionsService>()),
-    m_vehicles(md::app::Locator::get<IVehiclesService>())
+    m_vehicles(md::app::Locator::get<IVehiclesService>()),
+    m_statistics(md::app::Locator::get<MissionStatisticsService>()),
+    m_validation(md::app::Locator::get<MissionValidationService>()),
+    m_sync(md::app::Locator::get<MissionSyncService>())
 {
     Q_ASSERT(m_missions);
     Q_ASSERT(m_vehicles);
+    Q_ASSERT(m_statistics);
+    Q_ASSERT(m_validation);
+    Q_ASSERT(m_sync);
+
+    connect(m_statistics, &MissionStatisticsService::statisticsChanged, this,
+            [this](Mission* mission) {
+                if (m_mission == mission)
+                    emit statisticsChanged();
+            });
+    connect(m_validation, &MissionValidationService::validationChanged, this,
+            [this](Mission* mission) {
+                if (m_mission == mission)
+                    emit validationChanged();
+            });
+    connect(m_sync, &MissionSyncService::syncChanged, this, [this](Mission* mission) {
+        if (m_mission == mission)
+            emit syncStateChanged();
+    });
 
     connect(m_missions, &IMissionsService::operationStarted, this,
             [this](MissionOperation* operation) {
@@ -63,6 +84,32 @@ bool MissionEditController::isOnline() const
     return m_vehicle && m_vehicle->online();
 }
 
+QVariantMap MissionEditController::statistics() const
+{
+    const MissionRouteStatistics* statistics = m_statistics->statistics(m_mission);
+    return statistics ? statistics->toVariantMap() : QVariantMap();
+}
+
+bool MissionEditController::isValid() const
+{
+    return m_mission && m_validation->isValid(m_mission);
+}
+
+bool MissionEditController::isValidating() const
+{
+    return m_mission && m_validation->isPending(m_mission);
+}
+
+QStringList MissionEditController::validationErrors() const
+{
+    return m_mission ? m_validation->errors(m_mission) : QStringList();
+}
+
+QVariantMap MissionEditController::syncState() const
+{
+    return m_mission ? m_sync->syncState(m_mission) : QVariantMap();
+}
+
 int MissionEditController::operationProgress() const
 {
     if (!m_operation)
@@ -102,6 +149,9 @@ void MissionEditController::selectMission(const QVariant& missionId)
 
     emit missionChanged();
     emit vehicleChanged();
+    emit statisticsChanged();
+    emit validationChanged();
+    emit syncStateChanged();
 }
 
 void MissionEditController::upload()
@@ -109,6 +159,13 @@ void MissionEditController::upload()
     if (!m_mission)
         return;
 
+    if (!m_validation->isValid(m_mission))
+    {
+        qWarning() << "Mission upload rejected, route is invalid or still validating:"
+                   << m_validation->errors(m_mission);
+        return;
+    }
+
     m_missions->startOperation(m_mission, MissionOperation::Upload);
 }
 
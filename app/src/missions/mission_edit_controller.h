@@ -3,6 +3,9 @@
 
 #include "i_missions_service.h"
 #include "i_vehicles_service.h"
+#include "mission_statistics_service.h"
+#include "mission_sync_service.h"
+#include "mission_validation_service.h"
 
 namespace md::presentation
 {
@@ -15,6 +18,11 @@ class MissionEditController : public QObject
     Q_PROPERTY(QString vehicleName READ vehicleName NOTIFY vehicleChanged)
     Q_PROPERTY(bool online READ isOnline NOTIFY vehicleChanged)
 
+    Q_PROPERTY(QVariantMap statistics READ statistics NOTIFY statisticsChanged)
+    Q_PROPERTY(bool valid READ isValid NOTIFY validationChanged)
+    Q_PROPERTY(bool validating READ isValidating NOTIFY validationChanged)
+    Q_PROPERTY(QStringList validationErrors READ validationErrors NOTIFY validationChanged)
+    Q_PROPERTY(QVariantMap syncState READ syncState NOTIFY syncStateChanged)
     Q_PROPERTY(int operationProgress READ operationProgress NOTIFY operationProgressChanged)
 
 public:
@@ -24,6 +32,11 @@ public:
     QVariant mission() const;
     QString vehicleName() const;
     bool isOnline() const;
+    QVariantMap statistics() const;
+    bool isValid() const;
+    bool isValidating() const;
+    QStringList validationErrors() const;
+    QVariantMap syncState() const;
     int operationProgress() const;
 
 public slots:
@@ -36,11 +49,17 @@ public slots:
 signals:
     void missionChanged();
     void vehicleChanged();
+    void statisticsChanged();
+    void validationChanged();
+    void syncStateChanged();
     void operationProgressChanged();
 
 private:
     domain::IMissionsService* const m_missions;
     domain::IVehiclesService* const m_vehicles;
+    domain::MissionStatisticsService* const m_statistics;
+    domain::MissionValidationService* const m_validation;
+    domain::MissionSyncService* const m_sync;
     domain::Mission* m_mission = nullptr;
     domain::Vehicle* m_vehicle = nullptr;
     domain::MissionOperation* m_operation = nullptr;
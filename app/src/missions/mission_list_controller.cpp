@@ -9,9 +9,33 @@ using namespace md::presentation;
 
 MissionListController::MissionListController(QObject* parent) :
     QObject(parent),
-    m_missions(md::app::Locator::get<IMissionsService>())
+    m_missions(md::app::Locator::get<IMissionsService>()),
+    m_scheduler(md::app::Locator::get<MissionOperationScheduler>()),
+    m_validation(md::app::Locator::get<MissionValidationService>())
 {
     Q_ASSERT(m_missions);
+    Q_ASSERT(m_scheduler);
+    Q_ASSERT(m_validation);
+
+    connect(m_scheduler, &MissionOperationScheduler::batchProgressChanged, this,
+            [this](int batchId, double, int, int failed, int) {
+                if (batchId != m_batchId)
+                    return;
+
+                m_batchFailed = failed;
+                emit batchChanged();
+            });
+    connect(m_scheduler, &MissionOperationScheduler::batchFinished, this,
+            [this](int batchId, int succeeded, int failed) {
+                if (batchId != m_batchId)
+                    return;
+
+                qInfo() << "Missions batch finished, succeeded:" << succeeded
+                        << "failed:" << failed;
+                m_batchId = -1;
+                m_batchFailed = failed;
+                emit batchChanged();
+            });
 
     connect(m_missions, &IMissionsService::missionTypesChanged, this,
             &MissionListController::missionTypesChanged);
@@ -46,6 +70,19 @@ QJsonArray MissionListController::missions() const
     return missions;
 }
 
+int MissionListController::batchProgress() const
+{
+    if (!m_scheduler->isActive(m_batchId))
+        return -1;
+
+    return m_scheduler->progress(m_batchId) * 100;
+}
+
+int MissionListController::batchFailed() const
+{
+    return m_batchFailed;
+}
+
 QJsonObject MissionListController::mission(const QVariant& missionId) const
 {
     Mission* mission = m_missions->mission(missionId);
@@ -65,6 +102,52 @@ void MissionListController::rename(const QVariant& missionId, const QString& nam
     m_missions->saveMission(mission);
 }
 
+void MissionListController::uploadMissions(const QVariantList& missionIds)
+{
+    this->startBatch(missionIds, MissionOperation::Upload);
+}
+
+void MissionListController::downloadMissions(const QVariantList& missionIds)
+{
+    this->startBatch(missionIds, MissionOperation::Download);
+}
+
+void MissionListController::clearMissions(const QVariantList& missionIds)
+{
+    this->startBatch(missionIds, MissionOperation::Clear);
+}
+
+void MissionListController::cancelBatch()
+{
+    m_scheduler->cancelBatch(m_batchId);
+}
+
+void MissionListController::startBatch(const QVariantList& missionIds,
+                                       MissionOperation::Type type)
+{
+    if (m_scheduler->isActive(m_batchId))
+        return;
+
+    QList<Mission*> missions;
+    for (const QVariant& missionId : missionIds)
+    {
+        Mission* mission = m_missions->mission(missionId);
+        if (!mission)
+            continue;
+
+        if (type == MissionOperation::Upload && !m_validation->isValid(mission))
+        {
+            qWarning() << "Skipping invalid mission upload:" << mission->id();
+            continue;
+        }
+        missions.append(mission);
+    }
+
+    m_batchFailed = 0;
+    m_batchId = m_scheduler->startBatch(missions, type);
+    emit batchChanged();
+}
+
 void MissionListController::onMissionAdded(Mission* mission)
 {
     connect(mission, &Mission::changed, this, [this, mission]() {
@@ -2,6 +2,8 @@
 #define MISSION_LIST_CONTROLLER_H
 
 #include "i_missions_service.h"
+#include "mission_operation_scheduler.h"
+#include "mission_validation_service.h"
 
 #include <QJsonArray>
 
@@ -13,29 +15,44 @@ class MissionListController : public QObject
 
     Q_PROPERTY(QVariantList missionTypes READ missionTypes NOTIFY missionTypesChanged)
     Q_PROPERTY(QJsonArray missions READ missions NOTIFY missionsChanged)
+    Q_PROPERTY(int batchProgress READ batchProgress NOTIFY batchChanged)
+    Q_PROPERTY(int batchFailed READ batchFailed NOTIFY batchChanged)
 
 public:
     explicit MissionListController(QObject* parent = nullptr);
 
     QVariantList missionTypes() const;
     QJsonArray missions() const;
+    int batchProgress() const;
+    int batchFailed() const;
 
     Q_INVOKABLE QJsonObject mission(const QVariant& missionId) const;
 
 public slots:
     void rename(const QVariant& missionId, const QString& name);
+    void uploadMissions(const QVariantList& missionIds);
+    void downloadMissions(const QVariantList& missionIds);
+    void clearMissions(const QVariantList& missionIds);
+    void cancelBatch();
 
 signals:
     void missionTypesChanged();
     void missionsChanged();
     void missionChanged(QVariant missionId, QVariantMap mission);
+    void batchChanged();
 
 private slots:
     void onMissionAdded(domain::Mission* mission);
     void onMissionRemoved(domain::Mission* mission);
 
 private:
+    void startBatch(const QVariantList& missionIds, domain::MissionOperation::Type type);
+
     domain::IMissionsService* const m_missions;
+    domain::MissionOperationScheduler* const m_scheduler;
+    domain::MissionValidationService* const m_validation;
+    int m_batchId = -1;
+    int m_batchFailed = 0;
 };
 } // namespace md::presentation
 
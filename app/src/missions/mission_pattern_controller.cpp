@@ -1,18 +1,49 @@
 #include "mission_pattern_controller.h"
 
 #include <QDebug>
+#include <QSettings>
+#include <QtConcurrent>
 
+#include "coverage_path_planner.h"
 #include "locator.h"
+#include "mission_route_item_controller.h"
 #include "mission_traits.h"
+#include "terrain_follow.h"
+
+namespace
+{
+// Parameters of the lane patterns, calculated with the coverage planner
+constexpr char spacing[] = "spacing";
+constexpr char heading[] = "heading";
+} // namespace
 
 using namespace md::domain;
 using namespace md::presentation;
 
 MissionPatternController::MissionPatternController(QObject* parent) :
     QObject(parent),
-    m_missionsService(md::app::Locator::get<IMissionsService>())
+    m_missionsService(md::app::Locator::get<IMissionsService>()),
+    m_elevation(md::app::Locator::get<IElevationService>()),
+    m_terrainFollow(QSettings().value(TerrainFollow::enabledSetting, false).toBool())
 {
     Q_ASSERT(m_missionsService);
+    Q_ASSERT(m_elevation);
+
+    connect(&m_coverageWatcher, &QFutureWatcher<QVector<Geodetic>>::finished, this, [this]() {
+        if (!this->isCoverage())
+            return;
+
+        // Area or parameters changed during the calculation, its result is stale
+        if (m_runningGeneration != m_coverageGeneration)
+        {
+            this->startCoverage();
+            return;
+        }
+
+        m_coveragePath = m_coverageWatcher.result();
+        emit pathPositionsChanged();
+        emit readyChanged();
+    });
 }
 
 QVariant MissionPatternController::missionId() const
@@ -51,6 +82,16 @@ QJsonArray MissionPatternController::pathPositions() const
     if (!m_pattern)
         return QJsonArray();
 
+    if (this->isCoverage())
+    {
+        QJsonArray positions;
+        for (const Geodetic& position : m_coveragePath)
+        {
+            positions.append(QJsonObject::fromVariantMap(position.toVariantMap()));
+        }
+        return positions;
+    }
+
     return QJsonArray::fromVariantList(m_pattern->path().toVariantList());
 }
 
@@ -67,9 +108,18 @@ bool MissionPatternController::isReady() const
     if (!m_pattern)
         return false;
 
+    if (this->isCoverage())
+        return !m_coverageWatcher.isRunning() && m_runningGeneration == m_coverageGeneration &&
+               !m_coveragePath.isEmpty();
+
     return m_pattern->isReady();
 }
 
+bool MissionPatternController::terrainFollow() const
+{
+    return m_terrainFollow;
+}
+
 void MissionPatternController::selectMission(const QVariant& missionId)
 {
     if (this->missionId() == missionId)
@@ -90,14 +140,27 @@ void MissionPatternController::createPattern(const QString& patternTypeId)
     if (m_pattern)
         m_pattern->deleteLater();
 
+    m_area.clear();
+    m_areaHoles.clear();
+    m_coveragePath.clear();
+    m_coverageGeneration++;
+
     m_pattern = m_missionsService->createRoutePattern(patternTypeId);
 
     if (m_pattern)
     {
-        connect(m_pattern, &RoutePattern::pathPositionsChanged, this,
-                &MissionPatternController::pathPositionsChanged);
+        connect(m_pattern, &RoutePattern::pathPositionsChanged, this, [this]() {
+            if (this->isCoverage())
+            {
+                this->updateCoverage();
+                return;
+            }
+            emit pathPositionsChanged();
+            emit readyChanged();
+        });
         connect(m_pattern, &RoutePattern::changed, this,
                 &MissionPatternController::parameterValuesChanged);
+        connect(m_pattern, &RoutePattern::changed, this, &MissionPatternController::updateCoverage);
 
         if (m_mission->route()->count())
         {
@@ -110,6 +173,7 @@ void MissionPatternController::createPattern(const QString& patternTypeId)
     emit patternChanged();
     emit parameterValuesChanged();
     emit pathPositionsChanged();
+    emit readyChanged();
 }
 
 void MissionPatternController::setParameter(const QString& parameterId, const QVariant& value)
@@ -130,7 +194,39 @@ void MissionPatternController::setAreaPositions(const QVariantList& positions)
     {
         areaPositions.append(Geodetic(position.toMap()));
     }
+    m_area = areaPositions;
     m_pattern->setArea(areaPositions);
+    this->updateCoverage();
+}
+
+void MissionPatternController::setAreaHoles(const QVariantList& holes)
+{
+    if (!m_pattern)
+        return;
+
+    m_areaHoles.clear();
+    for (const QVariant& hole : holes)
+    {
+        QVector<Geodetic> holePositions;
+        for (const QVariant& position : hole.toList())
+        {
+            holePositions.append(Geodetic(position.toMap()));
+        }
+        m_areaHoles.append(holePositions);
+    }
+    this->updateCoverage();
+}
+
+void MissionPatternController::setTerrainFollow(bool terrainFollow)
+{
+    if (m_terrainFollow == terrainFollow)
+        return;
+
+    m_terrainFollow = terrainFollow;
+    QSettings().setValue(TerrainFollow::enabledSetting, terrainFollow);
+    emit terrainFollowChanged();
+
+    this->updateCoverage();
 }
 
 void MissionPatternController::cancel()
@@ -140,10 +236,15 @@ void MissionPatternController::cancel()
         m_pattern->deleteLater();
         m_pattern = nullptr;
     }
+    m_area.clear();
+    m_areaHoles.clear();
+    m_coveragePath.clear();
+    m_coverageGeneration++;
 
     emit patternChanged();
     emit parameterValuesChanged();
     emit pathPositionsChanged();
+    emit readyChanged();
 }
 
 void MissionPatternController::apply()
@@ -151,11 +252,125 @@ void MissionPatternController::apply()
     if (!m_pattern || !m_mission)
         return;
 
-    for (MissionRouteItem* item : m_pattern->createItems())
+    // Coverage path may still be calculated for the previous area or parameters
+    if (!this->isReady())
+        return;
+
+    const auto items = m_pattern->createItems();
+    if (this->isCoverage())
     {
-        m_mission->route()->addItem(item);
+        // Pattern items are the template for the natively calculated path
+        if (!items.isEmpty())
+        {
+            const MissionItemType* type = items.first()->type();
+            const QVariantMap parameters = items.first()->parametersMap();
+
+            for (const Geodetic& position : qAsConst(m_coveragePath))
+            {
+                auto item = new MissionRouteItem(type, type->shortName, utils::generateId(),
+                                                 parameters, position.toVariantMap());
+                item->setParameters(parameters);
+                m_mission->route()->addItem(item);
+            }
+        }
+        qDeleteAll(items);
+    }
+    else
+    {
+        // Pattern altitude is used as AGL along the whole path, legs get plain waypoints
+        QVector<Geodetic> path;
+        for (MissionRouteItem* item : items)
+        {
+            path.append(item->position());
+        }
+
+        QVector<int> indices;
+        if (m_terrainFollow)
+        {
+            const TerrainFollow terrainFollow(
+                m_elevation, m_pattern->parameters().value(mission::altitude.id).toFloat());
+            path = terrainFollow.apply(path, &indices);
+        }
+        else
+        {
+            for (int i = 0; i < path.count(); ++i)
+            {
+                indices.append(i);
+            }
+        }
+
+        const MissionItemType* waypointType = MissionRouteItemController::waypointType(
+            m_mission->type());
+        for (int i = 0, next = 0; i < path.count(); ++i)
+        {
+            if (next < indices.count() && indices.at(next) == i)
+            {
+                MissionRouteItem* item = items.at(next++);
+                item->position.set(path.at(i));
+                m_mission->route()->addItem(item);
+            }
+            else if (waypointType)
+            {
+                const QVariantMap parameters = waypointType->defaultParameters();
+                auto item = new MissionRouteItem(waypointType, waypointType->shortName,
+                                                 utils::generateId(), parameters,
+                                                 path.at(i).toVariantMap());
+                item->setParameters(parameters);
+                m_mission->route()->addItem(item);
+            }
+        }
     }
     m_missionsService->saveMission(m_mission);
 
     this->cancel();
 }
+
+void MissionPatternController::updateCoverage()
+{
+    if (!this->isCoverage())
+        return;
+
+    // The running calculation is restarted with the latest state when it's over
+    m_coverageGeneration++;
+    if (m_coverageWatcher.isRunning())
+    {
+        emit readyChanged();
+        return;
+    }
+    this->startCoverage();
+}
+
+void MissionPatternController::startCoverage()
+{
+    m_runningGeneration = m_coverageGeneration;
+
+    const QVariantMap values = m_pattern->parameters();
+    CoverageParameters parameters;
+    parameters.spacing = values.value(::spacing).toDouble();
+    parameters.heading = values.value(::heading).toDouble();
+    const double altitude = values.value(mission::altitude.id).toDouble();
+
+    Geodetic entry;
+    if (m_mission && m_mission->route()->count())
+        entry = m_mission->route()->lastItem()->position;
+
+    const QVector<Geodetic> area = m_area;
+    const QVector<QVector<Geodetic>> holes = m_areaHoles;
+    const IElevationService* elevation = m_terrainFollow ? m_elevation : nullptr;
+    m_coverageWatcher.setFuture(
+        QtConcurrent::run([area, holes, parameters, entry, altitude, elevation]() {
+            const QVector<Geodetic> path = CoveragePathPlanner::plan(area, holes, parameters,
+                                                                     entry, altitude);
+            // Pattern altitude is used as AGL along the lanes
+            if (elevation)
+                return TerrainFollow(elevation, altitude).apply(path);
+
+            return path;
+        }));
+    emit readyChanged();
+}
+
+bool MissionPatternController::isCoverage() const
+{
+    return m_pattern && m_pattern->hasParameter(::spacing) && m_pattern->hasParameter(::heading);
+}
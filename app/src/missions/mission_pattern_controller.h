@@ -1,8 +1,10 @@
 #ifndef MISSION_PATTERN_CONTROLLER_H
 #define MISSION_PATTERN_CONTROLLER_H
 
+#include "i_elevation_service.h"
 #include "i_missions_service.h"
 
+#include <QFutureWatcher>
 #include <QJsonArray>
 
 namespace md::presentation
@@ -16,7 +18,9 @@ class MissionPatternController : public QObject
     Q_PROPERTY(QJsonArray parameters READ parameters NOTIFY patternChanged)
     Q_PROPERTY(QJsonObject parameterValues READ parameterValues NOTIFY parameterValuesChanged)
     Q_PROPERTY(QJsonArray pathPositions READ pathPositions NOTIFY pathPositionsChanged)
-    Q_PROPERTY(bool ready READ isReady NOTIFY pathPositionsChanged)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)
+    Q_PROPERTY(bool terrainFollow READ terrainFollow WRITE setTerrainFollow NOTIFY
+                   terrainFollowChanged)
 
 public:
     explicit MissionPatternController(QObject* parent = nullptr);
@@ -27,6 +31,7 @@ public:
     QJsonObject parameterValues() const;
     QJsonArray pathPositions() const;
     bool isReady() const;
+    bool terrainFollow() const;
 
     Q_INVOKABLE QJsonArray areaPositions() const;
 
@@ -35,6 +40,8 @@ public slots:
     void createPattern(const QString& patternTypeId);
     void setParameter(const QString& parameterId, const QVariant& value);
     void setAreaPositions(const QVariantList& positions);
+    void setAreaHoles(const QVariantList& holes);
+    void setTerrainFollow(bool terrainFollow);
     void cancel();
     void apply();
 
@@ -43,12 +50,30 @@ signals:
     void missionChanged();
     void parameterValuesChanged();
     void pathPositionsChanged();
+    void readyChanged();
+    void terrainFollowChanged();
+
+private slots:
+    void updateCoverage();
 
 private:
+    bool isCoverage() const;
+    void startCoverage();
+
     domain::IMissionsService* const m_missionsService;
+    domain::IElevationService* const m_elevation;
 
     domain::Mission* m_mission = nullptr;
     domain::RoutePattern* m_pattern = nullptr;
+
+    // Lane patterns are calculated natively, on a worker thread
+    QVector<domain::Geodetic> m_area;
+    QVector<QVector<domain::Geodetic>> m_areaHoles;
+    QVector<domain::Geodetic> m_coveragePath;
+    QFutureWatcher<QVector<domain::Geodetic>> m_coverageWatcher;
+    quint64 m_coverageGeneration = 0; // Bumped on every change of the area or parameters
+    quint64 m_runningGeneration = 0;
+    bool m_terrainFollow;
 };
 } // namespace md::presentation
 
@@ -9,9 +9,17 @@ using namespace md::presentation;
 
 MissionRouteController::MissionRouteController(QObject* parent) :
     QObject(parent),
-    m_missions(md::app::Locator::get<IMissionsService>())
+    m_missions(md::app::Locator::get<IMissionsService>()),
+    m_statistics(md::app::Locator::get<MissionStatisticsService>())
 {
     Q_ASSERT(m_missions);
+    Q_ASSERT(m_statistics);
+
+    connect(m_statistics, &MissionStatisticsService::statisticsChanged, this,
+            [this](Mission* mission) {
+                if (m_mission == mission)
+                    emit statisticsChanged();
+            });
 }
 
 QVariant MissionRouteController::missionId() const
@@ -37,6 +45,18 @@ int MissionRouteController::count() const
     return m_mission ? m_mission->route()->count() : 0;
 }
 
+QVariantMap MissionRouteController::statistics() const
+{
+    const MissionRouteStatistics* statistics = m_statistics->statistics(m_mission);
+    return statistics ? statistics->toVariantMap() : QVariantMap();
+}
+
+QVariantMap MissionRouteController::itemStatistics(int index) const
+{
+    const MissionRouteStatistics* statistics = m_statistics->statistics(m_mission);
+    return statistics ? statistics->itemToVariantMap(index) : QVariantMap();
+}
+
 void MissionRouteController::selectMission(const QVariant& missionId)
 {
     Mission* mission = m_missions->mission(missionId);
@@ -64,5 +84,6 @@ void MissionRouteController::selectMission(const QVariant& missionId)
 
     emit missionChanged();
     emit routeItemsChanged();
+    emit statisticsChanged();
     emit selectItem(m_mission && m_mission->route()->count() ? 0 : -1);
 }
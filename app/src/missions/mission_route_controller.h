@@ -2,6 +2,7 @@
 #define MISSION_ROUTE_CONTROLLER_H
 
 #include "i_missions_service.h"
+#include "mission_statistics_service.h"
 
 #include <QJsonArray>
 
@@ -14,6 +15,7 @@ class MissionRouteController : public QObject
     Q_PROPERTY(QVariant missionId READ missionId WRITE selectMission NOTIFY missionChanged)
     Q_PROPERTY(QJsonArray routeItems READ routeItems NOTIFY routeItemsChanged)
     Q_PROPERTY(int count READ count NOTIFY routeItemsChanged)
+    Q_PROPERTY(QVariantMap statistics READ statistics NOTIFY statisticsChanged)
 
 public:
     explicit MissionRouteController(QObject* parent = nullptr);
@@ -21,6 +23,9 @@ public:
     QVariant missionId() const;
     QJsonArray routeItems() const;
     int count() const;
+    QVariantMap statistics() const;
+
+    Q_INVOKABLE QVariantMap itemStatistics(int index) const;
 
 public slots:
     void selectMission(const QVariant& missionId);
@@ -28,10 +33,12 @@ public slots:
 signals:
     void missionChanged();
     void routeItemsChanged();
+    void statisticsChanged();
     void selectItem(int index);
 
 private:
     domain::IMissionsService* const m_missions;
+    domain::MissionStatisticsService* const m_statistics;
     domain::Mission* m_mission = nullptr;
 };
 } // namespace md::presentation
@@ -1,17 +1,32 @@
 #include "mission_route_item_controller.h"
 
 #include <QDebug>
+#include <QSettings>
 
 #include "locator.h"
+#include "terrain_follow.h"
 
 using namespace md::domain;
 using namespace md::presentation;
 
 MissionRouteItemController::MissionRouteItemController(QObject* parent) :
     QObject(parent),
-    m_missions(md::app::Locator::get<IMissionsService>())
+    m_missions(md::app::Locator::get<IMissionsService>()),
+    m_elevation(md::app::Locator::get<IElevationService>()),
+    m_terrainFollow(QSettings().value(TerrainFollow::enabledSetting, false).toBool())
 {
     Q_ASSERT(m_missions);
+    Q_ASSERT(m_elevation);
+}
+
+const MissionItemType* MissionRouteItemController::waypointType(const MissionType* missionType)
+{
+    for (auto itemType : missionType->itemTypes)
+    {
+        if (itemType != missionType->homeItemType)
+            return itemType;
+    }
+    return nullptr;
 }
 
 QVariant MissionRouteItemController::missionId() const
@@ -53,6 +68,11 @@ QVariantMap MissionRouteItemController::itemParameters() const
     return m_routeItem->parametersMap();
 }
 
+bool MissionRouteItemController::terrainFollow() const
+{
+    return m_terrainFollow;
+}
+
 QVariantList MissionRouteItemController::itemTypes(int index) const
 {
     if (!m_mission)
@@ -132,6 +152,16 @@ void MissionRouteItemController::setInRouteIndex(int inRouteIndex)
     emit routeItemChanged();
 }
 
+void MissionRouteItemController::setTerrainFollow(bool terrainFollow)
+{
+    if (m_terrainFollow == terrainFollow)
+        return;
+
+    m_terrainFollow = terrainFollow;
+    QSettings().setValue(TerrainFollow::enabledSetting, terrainFollow);
+    emit terrainFollowChanged();
+}
+
 void MissionRouteItemController::remove()
 {
     if (!m_routeItem || !m_mission)
@@ -200,10 +230,33 @@ void MissionRouteItemController::addNewItem(const QString& typeId, const QVarian
     QVariantMap newPosition = position;
     newPosition[geo::altitude] = altitude;
 
-    MissionRouteItem* item = new MissionRouteItem(type, type->shortName, utils::generateId(),
-                                                  parameters, newPosition);
-    item->setParameters(parameters);
-    route->addItem(item);
+    // Keep AGL of the last item along the new leg, adding intermediate items if needed
+    QVector<Geodetic> positions = { Geodetic(newPosition) };
+    if (m_terrainFollow && count)
+    {
+        const Geodetic last = route->item(count - 1)->position();
+        const float agl = TerrainFollow::agl(m_elevation, last);
+        if (!qIsNaN(agl))
+            positions = TerrainFollow(m_elevation, agl).apply({ last, positions.first() }).mid(1);
+    }
+
+    // Intermediate points are plain waypoints, only the last one is of the requested type
+    const MissionItemType* waypointType = this->waypointType(m_mission->type());
+    if (!waypointType)
+        positions = positions.mid(positions.count() - 1);
+
+    for (int i = 0; i < positions.count(); ++i)
+    {
+        const MissionItemType* itemType = i + 1 < positions.count() ? waypointType : type;
+        const QVariantMap itemParameters = itemType == type ? parameters
+                                                            : itemType->defaultParameters();
 
-    m_missions->saveItem(route, item);
+        MissionRouteItem* item = new MissionRouteItem(itemType, itemType->shortName,
+                                                      utils::generateId(), itemParameters,
+                                                      positions.at(i).toVariantMap());
+        item->setParameters(itemParameters);
+        route->addItem(item);
+
+        m_missions->saveItem(route, item);
+    }
 }
@@ -1,6 +1,7 @@
 #ifndef MISSION_ROUTE_ITEM_CONTROLLER_H
 #define MISSION_ROUTE_ITEM_CONTROLLER_H
 
+#include "i_elevation_service.h"
 #include "i_missions_service.h"
 
 namespace md::presentation
@@ -14,21 +15,28 @@ class MissionRouteItemController : public QObject
     Q_PROPERTY(QVariantMap routeItem READ routeItem NOTIFY routeItemChanged)
     Q_PROPERTY(QVariantList typeParameters READ typeParameters NOTIFY routeItemChanged)
     Q_PROPERTY(QVariantMap itemParameters READ itemParameters NOTIFY routeItemChanged)
+    Q_PROPERTY(bool terrainFollow READ terrainFollow WRITE setTerrainFollow NOTIFY
+                   terrainFollowChanged)
 
 public:
     explicit MissionRouteItemController(QObject* parent = nullptr);
 
+    // Plain waypoint of the mission type, the first one offered after home
+    static const domain::MissionItemType* waypointType(const domain::MissionType* missionType);
+
     QVariant missionId() const;
     int inRouteIndex() const;
     QVariantMap routeItem() const;
     QVariantList typeParameters() const;
     QVariantMap itemParameters() const;
+    bool terrainFollow() const;
 
     Q_INVOKABLE QVariantList itemTypes(int index) const;
 
 public slots:
     void selectMission(const QVariant& missionId);
     void setInRouteIndex(int inRouteIndex);
+    void setTerrainFollow(bool terrainFollow);
 
     void remove();
     void rename(const QString& name);
@@ -40,12 +48,15 @@ public slots:
 signals:
     void missionChanged();
     void routeItemChanged();
+    void terrainFollowChanged();
 
 private:
     domain::IMissionsService* const m_missions;
+    domain::IElevationService* const m_elevation;
     domain::Mission* m_mission = nullptr;
     domain::MissionRouteItem* m_routeItem = nullptr;
     int m_inRouteIndex = -1;
+    bool m_terrainFollow;
 };
 } // namespace md::presentation
 
@@ -0,0 +1,353 @@
+#include "mission_operation_scheduler.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+namespace
+{
+md::domain::MissionOperationScheduler::Clock elapsedClock()
+{
+    QSharedPointer<QElapsedTimer> elapsed(new QElapsedTimer);
+    elapsed->start();
+    return [elapsed]() {
+        return elapsed->elapsed();
+    };
+}
+} // namespace
+
+using namespace md::domain;
+
+MissionOperationScheduler::MissionOperationScheduler(IMissionsService* missions, QObject* parent) :
+    MissionOperationScheduler(missions, ::elapsedClock(), parent)
+{
+}
+
+MissionOperationScheduler::MissionOperationScheduler(IMissionsService* missions, Clock clock,
+                                                     QObject* parent) :
+    QObject(parent),
+    m_missions(missions),
+    m_linkResolver([](Mission* mission) {
+        return mission->vehicleId().toString();
+    }),
+    m_clock(std::move(clock))
+{
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, &MissionOperationScheduler::dispatch);
+
+    connect(m_missions, &IMissionsService::operationStarted, this,
+            &MissionOperationScheduler::onOperationStarted);
+    connect(m_missions, &IMissionsService::operationEnded, this,
+            &MissionOperationScheduler::onOperationEnded);
+    connect(m_missions, &IMissionsService::missionRemoved, this,
+            &MissionOperationScheduler::onMissionRemoved);
+}
+
+void MissionOperationScheduler::setLinkResolver(const LinkResolver& resolver)
+{
+    m_linkResolver = resolver;
+}
+
+int MissionOperationScheduler::startBatch(const QList<Mission*>& missions,
+                                          MissionOperation::Type type)
+{
+    const int batchId = ++m_lastBatchId;
+    Batch& batch = m_batches[batchId];
+
+    for (Mission* mission : missions)
+    {
+        if (!mission)
+            continue;
+
+        Job* job = new Job{ batchId, mission, type, m_linkResolver(mission) };
+        batch.jobs.append(job);
+        this->enqueue(job);
+    }
+
+    if (batch.jobs.isEmpty())
+    {
+        m_batches.remove(batchId);
+        emit batchFinished(batchId, 0, 0);
+        return batchId;
+    }
+
+    this->reportProgress(batchId);
+    this->dispatch();
+    return batchId;
+}
+
+void MissionOperationScheduler::cancelBatch(int batchId)
+{
+    if (!m_batches.contains(batchId))
+        return;
+
+    const QList<Job*> jobs = m_batches.value(batchId).jobs;
+
+    // Waiting and starting jobs are taken out first, so ending running ones does not dispatch them.
+    // Ending the last operation deletes the jobs, so only their operations are kept for that
+    QList<Job*> waiting;
+    QList<MissionOperation*> operations;
+    for (Job* job : jobs)
+    {
+        if (m_queues[job->link].removeAll(job))
+        {
+            waiting.append(job);
+        }
+        else if (job->operation)
+        {
+            operations.append(job->operation);
+        }
+        else if (m_active.value(job->mission) == job)
+        {
+            this->deactivate(job);
+            waiting.append(job);
+        }
+    }
+
+    for (Job* job : qAsConst(waiting))
+    {
+        this->finishJob(job, false);
+    }
+
+    for (MissionOperation* operation : qAsConst(operations))
+    {
+        m_missions->endOperation(operation, MissionOperation::Canceled);
+    }
+}
+
+bool MissionOperationScheduler::isActive(int batchId) const
+{
+    return m_batches.contains(batchId);
+}
+
+double MissionOperationScheduler::progress(int batchId) const
+{
+    const Batch batch = m_batches.value(batchId);
+    if (batch.jobs.isEmpty())
+        return 1.0;
+
+    double progress = 0;
+    for (const Job* job : batch.jobs)
+    {
+        progress += job->progress;
+    }
+    return progress / batch.jobs.count();
+}
+
+void MissionOperationScheduler::onOperationStarted(MissionOperation* operation)
+{
+    Mission* mission = operation->mission();
+    m_busy.insert(mission);
+
+    Job* job = m_active.value(mission);
+    if (!job || job->operation)
+        return;
+
+    job->operation = operation;
+    connect(operation, &MissionOperation::changed, this, [this, job, operation]() {
+        job->progress = operation->total > 0 ? operation->progress * 1.0 / operation->total : 0;
+        this->reportProgress(job->batchId);
+    });
+}
+
+void MissionOperationScheduler::onOperationEnded(MissionOperation* operation)
+{
+    Mission* mission = operation->mission();
+    m_busy.remove(mission);
+
+    // A starting job takes the end of an operation that never reported its start
+    Job* job = m_active.value(mission);
+    if (job && (job->operation == operation || !job->operation))
+    {
+        this->deactivate(job);
+
+        const MissionOperation::State state = operation->state();
+        if (state == MissionOperation::Succeeded)
+        {
+            this->finishJob(job, true);
+        }
+        else if (state == MissionOperation::Canceled || job->attempts >= maxAttempts)
+        {
+            this->finishJob(job, false);
+        }
+        else
+        {
+            // Retry behind the others, so a failing vehicle does not hold the link
+            qWarning() << "Mission operation failed, retrying:" << mission->id();
+            job->progress = 0;
+            this->retryLater(job);
+            this->reportProgress(job->batchId);
+        }
+    }
+
+    this->dispatch();
+}
+
+void MissionOperationScheduler::onMissionRemoved(Mission* mission)
+{
+    m_busy.remove(mission);
+
+    // Unfinished jobs are the waiting and the active ones, all of them are taken out first
+    QList<Job*> jobs;
+    for (const Batch& batch : qAsConst(m_batches))
+    {
+        for (Job* job : batch.jobs)
+        {
+            if (job->mission != mission)
+                continue;
+
+            if (m_queues[job->link].removeAll(job))
+            {
+                jobs.append(job);
+            }
+            else if (m_active.value(mission) == job)
+            {
+                this->deactivate(job);
+                jobs.append(job);
+            }
+        }
+    }
+
+    for (Job* job : qAsConst(jobs))
+    {
+        this->finishJob(job, false);
+    }
+
+    if (!jobs.isEmpty())
+        this->dispatch();
+}
+
+void MissionOperationScheduler::enqueue(Job* job)
+{
+    if (!m_links.contains(job->link))
+        m_links.append(job->link);
+
+    m_queues[job->link].enqueue(job);
+}
+
+void MissionOperationScheduler::dispatch()
+{
+    this->expireStarts();
+    if (m_links.isEmpty())
+        return;
+
+    // One job per link and round, so busy links do not starve the others
+    bool started = true;
+    while (started)
+    {
+        started = false;
+        for (int i = 0; i < m_links.count(); ++i)
+        {
+            const QString link = m_links.at((m_nextLink + i) % m_links.count());
+            started |= this->startNext(link);
+        }
+        m_nextLink = (m_nextLink + 1) % m_links.count();
+    }
+}
+
+void MissionOperationScheduler::expireStarts()
+{
+    const qint64 now = m_clock();
+    const QList<Job*> active = m_active.values();
+    for (Job* job : active)
+    {
+        if (job->operation || job->startDeadline > now)
+            continue;
+
+        // Refused operation, e.g. the vehicle is offline
+        this->deactivate(job);
+        if (job->attempts >= maxAttempts)
+            this->finishJob(job, false);
+        else
+            this->retryLater(job);
+    }
+}
+
+bool MissionOperationScheduler::startNext(const QString& link)
+{
+    if (m_running.value(link) >= maxPerLink)
+        return false;
+
+    const qint64 now = m_clock();
+    QQueue<Job*>& queue = m_queues[link];
+    for (int i = 0; i < queue.count(); ++i)
+    {
+        // Missions with an operation already in progress wait for their turn, retries for the delay
+        Job* job = queue.dequeue();
+        if (m_busy.contains(job->mission) || job->retryAt > now)
+        {
+            if (job->retryAt > now)
+                this->scheduleDispatch(job->retryAt - now);
+
+            queue.enqueue(job);
+            continue;
+        }
+
+        job->attempts++;
+        job->startDeadline = now + startTimeout;
+        m_running[link]++;
+        m_active.insert(job->mission, job);
+
+        // The start may be reported later, the job holds its slot until then or the deadline
+        m_missions->startOperation(job->mission, job->type);
+        if (!job->operation && m_active.value(job->mission) == job)
+            this->scheduleDispatch(startTimeout);
+        return true;
+    }
+    return false;
+}
+
+void MissionOperationScheduler::deactivate(Job* job)
+{
+    if (job->operation)
+        disconnect(job->operation, nullptr, this, nullptr);
+
+    m_active.remove(job->mission);
+    m_running[job->link]--;
+    job->operation = nullptr;
+}
+
+void MissionOperationScheduler::retryLater(Job* job)
+{
+    const qint64 delay = qint64(retryDelay) << (job->attempts - 1);
+    job->retryAt = m_clock() + delay;
+    m_queues[job->link].enqueue(job);
+    this->scheduleDispatch(delay);
+}
+
+void MissionOperationScheduler::scheduleDispatch(qint64 delay)
+{
+    if (!m_retryTimer.isActive() || m_retryTimer.remainingTime() > delay)
+        m_retryTimer.start(int(delay));
+}
+
+void MissionOperationScheduler::finishJob(Job* job, bool succeeded)
+{
+    const int batchId = job->batchId;
+    Batch& batch = m_batches[batchId];
+
+    job->progress = 1.0;
+    if (succeeded)
+        batch.succeeded++;
+    else
+        batch.failed++;
+
+    this->reportProgress(batchId);
+
+    if (batch.succeeded + batch.failed < batch.jobs.count())
+        return;
+
+    const int succeededCount = batch.succeeded;
+    const int failedCount = batch.failed;
+    qDeleteAll(batch.jobs);
+    m_batches.remove(batchId);
+
+    emit batchFinished(batchId, succeededCount, failedCount);
+}
+
+void MissionOperationScheduler::reportProgress(int batchId)
+{
+    const Batch batch = m_batches.value(batchId);
+    emit batchProgressChanged(batchId, this->progress(batchId), batch.succeeded, batch.failed,
+                              batch.jobs.count());
+}
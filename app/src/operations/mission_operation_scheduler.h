@@ -0,0 +1,97 @@
+#ifndef MISSION_OPERATION_SCHEDULER_H
+#define MISSION_OPERATION_SCHEDULER_H
+
+#include "i_missions_service.h"
+
+#include <QHash>
+#include <QQueue>
+#include <QSet>
+#include <QTimer>
+#include <functional>
+
+namespace md::domain
+{
+// Runs mission operations for many missions at once, sharing every link between vehicles
+class MissionOperationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int maxPerLink = 2;
+    static constexpr int maxAttempts = 3;
+    static constexpr int retryDelay = 1000; // ms, doubled with every attempt
+    static constexpr int startTimeout = 5000; // Operations not started by then were refused
+
+    using LinkResolver = std::function<QString(Mission*)>;
+    using Clock = std::function<qint64()>; // Monotonic milliseconds
+
+    explicit MissionOperationScheduler(IMissionsService* missions, QObject* parent = nullptr);
+    MissionOperationScheduler(IMissionsService* missions, Clock clock, QObject* parent = nullptr);
+
+    // Missions on the same link key share its concurrency slots, every vehicle is a link by default
+    void setLinkResolver(const LinkResolver& resolver);
+
+    int startBatch(const QList<Mission*>& missions, MissionOperation::Type type);
+    void cancelBatch(int batchId);
+
+    bool isActive(int batchId) const;
+    double progress(int batchId) const;
+
+public slots:
+    // Starts whatever is due, also run by the retry timer
+    void dispatch();
+
+signals:
+    void batchProgressChanged(int batchId, double progress, int succeeded, int failed, int total);
+    void batchFinished(int batchId, int succeeded, int failed);
+
+private:
+    struct Job
+    {
+        int batchId;
+        Mission* mission;
+        MissionOperation::Type type;
+        QString link;
+        int attempts = 0;
+        qint64 retryAt = 0;      // Not started again before that
+        qint64 startDeadline = 0; // Requested, but the operation has not started yet
+        double progress = 0;
+        MissionOperation* operation = nullptr;
+    };
+
+    struct Batch
+    {
+        QList<Job*> jobs;
+        int succeeded = 0;
+        int failed = 0;
+    };
+
+    void onOperationStarted(MissionOperation* operation);
+    void onOperationEnded(MissionOperation* operation);
+    void onMissionRemoved(Mission* mission);
+
+    void enqueue(Job* job);
+    void expireStarts();
+    bool startNext(const QString& link);
+    void deactivate(Job* job);
+    void retryLater(Job* job);
+    void scheduleDispatch(qint64 delay);
+    void finishJob(Job* job, bool succeeded);
+    void reportProgress(int batchId);
+
+    IMissionsService* const m_missions;
+    LinkResolver m_linkResolver;
+    int m_lastBatchId = 0;
+    QHash<int, Batch> m_batches;
+    QStringList m_links;                   // Round-robin order of links
+    int m_nextLink = 0;
+    QHash<QString, QQueue<Job*>> m_queues; // Waiting jobs per link
+    QHash<QString, int> m_running;         // Running jobs per link
+    QHash<Mission*, Job*> m_active;        // Started or starting jobs by mission
+    QSet<Mission*> m_busy;                 // Missions with any operation in progress
+    const Clock m_clock;
+    QTimer m_retryTimer;
+};
+} // namespace md::domain
+
+#endif // MISSION_OPERATION_SCHEDULER_H
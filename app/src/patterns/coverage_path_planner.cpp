@@ -0,0 +1,495 @@
+#include "coverage_path_planner.h"
+
+#include <QtConcurrent>
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+#include "geodesy_kernels.h"
+
+namespace
+{
+constexpr double epsilon = 1e-9;
+constexpr double contactTolerance = 1e-6; // Meters, lane ends against ring edges
+constexpr int minLanesChunk = 16;
+
+QPointF rotated(const QPointF& point, double cosA, double sinA)
+{
+    return QPointF(point.x() * cosA - point.y() * sinA, point.x() * sinA + point.y() * cosA);
+}
+
+QPolygonF rotated(const QPolygonF& polygon, double cosA, double sinA)
+{
+    QPolygonF result;
+    result.reserve(polygon.count());
+    for (const QPointF& point : polygon)
+    {
+        result.append(::rotated(point, cosA, sinA));
+    }
+    return result;
+}
+
+double cross(const QPointF& a, const QPointF& b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+double length(const QPointF& vector)
+{
+    return qSqrt(QPointF::dotProduct(vector, vector));
+}
+
+double distanceToSegment(const QPointF& point, const QPointF& a, const QPointF& b)
+{
+    const QPointF ab = b - a;
+    const double lengthSquared = QPointF::dotProduct(ab, ab);
+    const double t = lengthSquared > 0
+                         ? qBound(0.0, QPointF::dotProduct(point - a, ab) / lengthSquared, 1.0)
+                         : 0.0;
+    return ::length(point - (a + ab * t));
+}
+
+// Parameter along ab of the proper crossing with cd, negative if there is none
+double crossing(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d)
+{
+    const QPointF r = b - a;
+    const QPointF s = d - c;
+    const double denominator = ::cross(r, s);
+    if (qAbs(denominator) < ::epsilon)
+        return -1;
+
+    const QPointF ca = c - a;
+    const double t = ::cross(ca, s) / denominator;
+    const double u = ::cross(ca, r) / denominator;
+    if (t <= ::epsilon || t >= 1 - ::epsilon || u < 0 || u > 1)
+        return -1;
+
+    return t;
+}
+} // namespace
+
+using namespace md::domain;
+
+CoveragePathPlanner::CoveragePathPlanner(const QPolygonF& boundary,
+                                         const QVector<QPolygonF>& holes) :
+    m_boundary(boundary),
+    m_holes(holes)
+{
+}
+
+QPolygonF CoveragePathPlanner::plan(const CoverageParameters& parameters,
+                                    const QPointF& entry) const
+{
+    if (m_boundary.count() < 3 || parameters.spacing <= 0)
+        return QPolygonF();
+
+    // Rotate plane to make lanes horizontal
+    const double angle = qDegreesToRadians(parameters.heading - 90.0);
+    const double cosA = qCos(angle);
+    const double sinA = qSin(angle);
+
+    QVector<QPolygonF> rings;
+    rings.reserve(m_holes.count() + 1);
+    rings.append(::rotated(m_boundary, cosA, sinA));
+    for (const QPolygonF& hole : m_holes)
+    {
+        if (hole.count() >= 3)
+            rings.append(::rotated(hole, cosA, sinA));
+    }
+
+    const QRectF bounds = rings.first().boundingRect();
+    const double spacing = parameters.spacing;
+    // Rotation noise must not add a lane when the height is a whole number of spacings
+    const int count = qMax(1, qCeil(bounds.height() / spacing - ::contactTolerance));
+    const double y0 = bounds.top() + (bounds.height() - (count - 1) * spacing) / 2;
+
+    const QVector<Lane> lanes = this->sliceLanes(rings, y0, spacing, count,
+                                                 parameters.parallelThreshold);
+    const QVector<Cell> cells = this->decompose(lanes);
+
+    QPolygonF path;
+    QPointF position = ::rotated(entry, cosA, sinA);
+    QVector<bool> visited(cells.count(), false);
+
+    for (int step = 0; step < cells.count(); ++step)
+    {
+        // Greedy choice of the nearest cell corner to minimize transits
+        int best = -1;
+        bool bestFromBottom = true;
+        bool bestLeft = true;
+        double bestDistance = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < cells.count(); ++i)
+        {
+            if (visited.at(i))
+                continue;
+
+            const Cell& cell = cells.at(i);
+            const double bottomY = y0 + cell.firstLane * spacing;
+            const double topY = bottomY + (cell.segments.count() - 1) * spacing;
+            const Segment& bottom = cell.segments.first();
+            const Segment& top = cell.segments.last();
+
+            const QPointF corners[] = { { bottom.left, bottomY },
+                                        { bottom.right, bottomY },
+                                        { top.left, topY },
+                                        { top.right, topY } };
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                const double distance = ::length(corners[corner] - position);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = i;
+                    bestFromBottom = corner < 2;
+                    bestLeft = corner % 2 == 0;
+                }
+            }
+        }
+
+        visited[best] = true;
+        const Cell& cell = cells.at(best);
+        const int segmentsCount = cell.segments.count();
+        bool leftToRight = bestLeft;
+
+        for (int i = 0; i < segmentsCount; ++i)
+        {
+            const int index = bestFromBottom ? i : segmentsCount - 1 - i;
+            const Segment& segment = cell.segments.at(index);
+            const double y = y0 + (cell.firstLane + index) * spacing;
+
+            const QPointF left(segment.left - parameters.extension, y);
+            const QPointF right(segment.right + parameters.extension, y);
+            const QPointF& from = leftToRight ? left : right;
+            const QPointF& to = leftToRight ? right : left;
+
+            // Turns pass a reflex vertex between lanes, transits cross notches and holes
+            if (path.isEmpty())
+                path.append(from);
+            else
+                this->connect(path, from, rings);
+
+            path.append(to);
+            leftToRight = !leftToRight;
+        }
+        position = path.last();
+    }
+
+    return ::rotated(path, cosA, -sinA);
+}
+
+QVector<Geodetic> CoveragePathPlanner::plan(const QVector<Geodetic>& area,
+                                            const QVector<QVector<Geodetic>>& holes,
+                                            const CoverageParameters& parameters,
+                                            const Geodetic& entry, double altitude)
+{
+    if (area.count() < 3)
+        return QVector<Geodetic>();
+
+    // Local tangent plane at the area centroid
+    double latitude0 = 0;
+    double longitude0 = 0;
+    for (const Geodetic& position : area)
+    {
+        latitude0 += position.latitude();
+        longitude0 += position.longitude();
+    }
+    const Geodetic origin(latitude0 / area.count(), longitude0 / area.count(), 0);
+
+    auto projectPolygon = [&](const QVector<Geodetic>& positions) {
+        GeodeticArrays arrays = GeodeticArrays::fromPositions(positions);
+        std::fill(arrays.altitudes.begin(), arrays.altitudes.end(), 0);
+
+        QVector<double> east(arrays.count()), north(arrays.count()), up(arrays.count());
+        geodesy::toEnu(origin, arrays.latitudes.constData(), arrays.longitudes.constData(),
+                       arrays.altitudes.constData(), east.data(), north.data(), up.data(),
+                       arrays.count());
+
+        QPolygonF polygon(arrays.count());
+        for (int i = 0; i < polygon.count(); ++i)
+        {
+            polygon[i] = QPointF(east.at(i), north.at(i));
+        }
+        return polygon;
+    };
+
+    QVector<QPolygonF> planarHoles;
+    for (const QVector<Geodetic>& hole : holes)
+    {
+        planarHoles.append(projectPolygon(hole));
+    }
+
+    const CoveragePathPlanner planner(projectPolygon(area), planarHoles);
+    const QPolygonF path = planner.plan(parameters, entry.isValid()
+                                                        ? projectPolygon({ entry }).first()
+                                                        : QPointF());
+
+    QVector<double> east(path.count()), north(path.count()), up(path.count(), 0);
+    for (int i = 0; i < path.count(); ++i)
+    {
+        east[i] = path.at(i).x();
+        north[i] = path.at(i).y();
+    }
+
+    GeodeticArrays result;
+    result.resize(path.count());
+    geodesy::fromEnu(origin, east.constData(), north.constData(), up.constData(),
+                     result.latitudes.data(), result.longitudes.data(), result.altitudes.data(),
+                     path.count());
+    std::fill(result.altitudes.begin(), result.altitudes.end(), altitude);
+
+    return result.toPositions();
+}
+
+QVector<CoveragePathPlanner::Lane> CoveragePathPlanner::sliceLanes(const QVector<QPolygonF>& rings,
+                                                                   double y0, double spacing,
+                                                                   int count,
+                                                                   int parallelThreshold) const
+{
+    // Flat edge arrays for a tight crossing loop
+    QVector<double> x1, y1, x2, y2;
+    for (const QPolygonF& ring : rings)
+    {
+        for (int i = 0; i < ring.count(); ++i)
+        {
+            const QPointF& a = ring.at(i);
+            const QPointF& b = ring.at((i + 1) % ring.count());
+            if (qFuzzyCompare(a.y(), b.y()))
+                continue;
+
+            x1.append(a.x());
+            y1.append(a.y());
+            x2.append(b.x());
+            y2.append(b.y());
+        }
+    }
+
+    QVector<Lane> lanes(count);
+    const int edgesCount = x1.count();
+    const int chunk = qMax(::minLanesChunk, count / QThread::idealThreadCount());
+
+    auto sliceRange = [&](int begin) {
+        const int end = qMin(count, begin + chunk);
+        QVector<double> crossings;
+
+        for (int lane = begin; lane < end; ++lane)
+        {
+            const double y = y0 + lane * spacing;
+            crossings.clear();
+
+            // Half-open rule counts every vertex once, even-odd pairs skip holes
+            for (int e = 0; e < edgesCount; ++e)
+            {
+                if ((y1[e] <= y) != (y2[e] <= y))
+                    crossings.append(x1[e] + (y - y1[e]) * (x2[e] - x1[e]) / (y2[e] - y1[e]));
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            Lane& segments = lanes[lane];
+            for (int i = 0; i + 1 < crossings.count(); i += 2)
+            {
+                if (crossings[i + 1] - crossings[i] > ::epsilon)
+                    segments.append({ crossings[i], crossings[i + 1] });
+            }
+        }
+    };
+
+    QVector<int> chunks;
+    for (int begin = 0; begin < count; begin += chunk)
+    {
+        chunks.append(begin);
+    }
+
+    if (count < parallelThreshold || chunks.count() < 2)
+    {
+        for (int begin : qAsConst(chunks))
+        {
+            sliceRange(begin);
+        }
+    }
+    else
+    {
+        QtConcurrent::blockingMap(chunks, sliceRange);
+    }
+
+    return lanes;
+}
+
+QVector<CoveragePathPlanner::Cell> CoveragePathPlanner::decompose(const QVector<Lane>& lanes) const
+{
+    auto overlaps = [](const Segment& a, const Segment& b) {
+        return a.left < b.right && b.left < a.right;
+    };
+
+    QVector<Cell> cells;
+    QVector<int> previousCells;
+    const Lane* previous = nullptr;
+
+    for (int laneIndex = 0; laneIndex < lanes.count(); ++laneIndex)
+    {
+        const Lane& lane = lanes.at(laneIndex);
+        QVector<int> currentCells(lane.count(), -1);
+
+        // Number of current segments touching every previous one
+        QVector<int> forwardLinks(previous ? previous->count() : 0, 0);
+        for (int i = 0; i < forwardLinks.count(); ++i)
+        {
+            for (const Segment& segment : lane)
+            {
+                if (overlaps(previous->at(i), segment))
+                    forwardLinks[i]++;
+            }
+        }
+
+        for (int j = 0; j < lane.count(); ++j)
+        {
+            int link = -1;
+            int backwardLinks = 0;
+            for (int i = 0; i < forwardLinks.count(); ++i)
+            {
+                if (overlaps(previous->at(i), lane.at(j)))
+                {
+                    link = i;
+                    backwardLinks++;
+                }
+            }
+
+            // Cell continues only while lanes topology stays the same
+            if (backwardLinks == 1 && forwardLinks.at(link) == 1)
+            {
+                const int cellIndex = previousCells.at(link);
+                cells[cellIndex].segments.append(lane.at(j));
+                currentCells[j] = cellIndex;
+            }
+            else
+            {
+                currentCells[j] = cells.count();
+                cells.append({ laneIndex, { lane.at(j) } });
+            }
+        }
+
+        previous = &lane;
+        previousCells = currentCells;
+    }
+
+    return cells;
+}
+
+void CoveragePathPlanner::connect(QPolygonF& path, const QPointF& to,
+                                  const QVector<QPolygonF>& rings) const
+{
+    struct Hit
+    {
+        double t;
+        int edge;
+    };
+
+    QPointF from = path.last();
+    int passes = 0;
+    for (const QPolygonF& ring : rings)
+    {
+        passes += ring.count();
+    }
+
+    // Every pass walks around the nearest ring the transit goes out of free space through
+    for (int pass = 0; pass < passes && ::length(to - from) > ::contactTolerance; ++pass)
+    {
+        int ringIndex = -1;
+        double firstT = 2;
+        double lastT = -1;
+        int firstEdge = -1;
+        int lastEdge = -1;
+
+        for (int r = 0; r < rings.count(); ++r)
+        {
+            const QPolygonF& ring = rings.at(r);
+            const int n = ring.count();
+
+            // Lane ends lie on rings, so touching counts as well as crossing
+            QVector<Hit> hits;
+            for (int e = 0; e < n; ++e)
+            {
+                const QPointF& a = ring.at(e);
+                const QPointF& b = ring.at((e + 1) % n);
+                if (::distanceToSegment(from, a, b) < ::contactTolerance)
+                    hits.append({ 0, e });
+                if (::distanceToSegment(to, a, b) < ::contactTolerance)
+                    hits.append({ 1, e });
+
+                const double t = ::crossing(from, to, a, b);
+                if (t >= 0)
+                    hits.append({ t, e });
+            }
+            std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+                return a.t < b.t;
+            });
+
+            // Outside of the boundary or inside of a hole between two hits
+            int entry = -1;
+            int exit = -1;
+            for (int i = 0; i + 1 < hits.count(); ++i)
+            {
+                const double t = (hits.at(i).t + hits.at(i + 1).t) / 2;
+                if (hits.at(i + 1).t - hits.at(i).t < ::epsilon ||
+                    ring.containsPoint(from + (to - from) * t, Qt::OddEvenFill) == (r == 0))
+                    continue;
+
+                if (entry == -1)
+                    entry = i;
+                exit = i + 1;
+            }
+
+            if (entry == -1 || hits.at(entry).edge == hits.at(exit).edge ||
+                hits.at(entry).t >= firstT)
+                continue;
+
+            ringIndex = r;
+            firstT = hits.at(entry).t;
+            lastT = hits.at(exit).t;
+            firstEdge = hits.at(entry).edge;
+            lastEdge = hits.at(exit).edge;
+        }
+
+        if (ringIndex == -1)
+            break;
+
+        const QPolygonF& ring = rings.at(ringIndex);
+        const int n = ring.count();
+        const QPointF entryPoint = from + (to - from) * firstT;
+        const QPointF exitPoint = from + (to - from) * lastT;
+
+        // Walk along the ring both ways and take the shorter one
+        QPolygonF forward;
+        for (int v = (firstEdge + 1) % n;; v = (v + 1) % n)
+        {
+            forward.append(ring.at(v));
+            if (v == lastEdge)
+                break;
+        }
+        QPolygonF backward;
+        for (int v = firstEdge;; v = (v - 1 + n) % n)
+        {
+            backward.append(ring.at(v));
+            if (v == (lastEdge + 1) % n)
+                break;
+        }
+
+        auto walkLength = [&](const QPolygonF& walk) {
+            double result = ::length(walk.first() - entryPoint) +
+                            ::length(exitPoint - walk.last());
+            for (int i = 1; i < walk.count(); ++i)
+            {
+                result += ::length(walk.at(i) - walk.at(i - 1));
+            }
+            return result;
+        };
+
+        path.append(entryPoint);
+        path += walkLength(forward) < walkLength(backward) ? forward : backward;
+        path.append(exitPoint);
+        from = exitPoint;
+    }
+
+    path.append(to);
+}
@@ -0,0 +1,57 @@
+#ifndef COVERAGE_PATH_PLANNER_H
+#define COVERAGE_PATH_PLANNER_H
+
+#include <QPolygonF>
+#include <QVector>
+
+#include "geodetic.h"
+
+namespace md::domain
+{
+struct CoverageParameters
+{
+    double spacing = 50.0;     // Distance between lanes, meters
+    double heading = 0.0;      // Lanes direction, degrees from north
+    double extension = 0.0;    // Lane overshoot for turns, meters
+    int parallelThreshold = 256; // Lanes count to split work across cores
+};
+
+// Boustrophedon coverage of a concave polygon with holes on a local plane, in meters
+class CoveragePathPlanner
+{
+public:
+    CoveragePathPlanner(const QPolygonF& boundary, const QVector<QPolygonF>& holes = {});
+
+    QPolygonF plan(const CoverageParameters& parameters, const QPointF& entry) const;
+
+    // Plans on the local tangent plane of the area and returns positions at altitude
+    static QVector<Geodetic> plan(const QVector<Geodetic>& area,
+                                  const QVector<QVector<Geodetic>>& holes,
+                                  const CoverageParameters& parameters, const Geodetic& entry,
+                                  double altitude);
+
+private:
+    struct Segment
+    {
+        double left;
+        double right;
+    };
+    using Lane = QVector<Segment>;
+
+    struct Cell
+    {
+        int firstLane;
+        QVector<Segment> segments; // One per consecutive lane
+    };
+
+    QVector<Lane> sliceLanes(const QVector<QPolygonF>& rings, double y0, double spacing,
+                             int count, int parallelThreshold) const;
+    QVector<Cell> decompose(const QVector<Lane>& lanes) const;
+    void connect(QPolygonF& path, const QPointF& to, const QVector<QPolygonF>& rings) const;
+
+    const QPolygonF m_boundary;
+    const QVector<QPolygonF> m_holes;
+};
+} // namespace md::domain
+
+#endif // COVERAGE_PATH_PLANNER_H
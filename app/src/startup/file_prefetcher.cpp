@@ -0,0 +1,76 @@
+#include "file_prefetcher.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QLibrary>
+#include <QtConcurrent>
+
+namespace
+{
+constexpr qint64 chunkSize = 1 << 20;
+}
+
+using namespace md::app;
+
+QFuture<qint64> FilePrefetcher::prefetch(const QStringList& paths)
+{
+    return QtConcurrent::run([paths]() {
+        qint64 total = 0;
+        QByteArray chunk(::chunkSize, Qt::Uninitialized);
+
+        for (const QString& path : FilePrefetcher::collect(paths))
+        {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+
+            qint64 read = 0;
+            while ((read = file.read(chunk.data(), chunk.size())) > 0)
+            {
+                total += read;
+            }
+        }
+        return total;
+    });
+}
+
+int FilePrefetcher::loadLibraries(const QStringList& paths)
+{
+    int count = 0;
+    for (const QString& path : FilePrefetcher::collect(paths))
+    {
+        if (!QLibrary::isLibrary(path))
+            continue;
+
+        // Not unloaded on destruction, the library stays for the plugin loader
+        QLibrary library(path);
+        if (library.load())
+            count++;
+    }
+    return count;
+}
+
+QStringList FilePrefetcher::collect(const QStringList& paths)
+{
+    QStringList files;
+    for (const QString& path : paths)
+    {
+        QFileInfo info(path);
+        if (info.isFile())
+        {
+            files.append(path);
+            continue;
+        }
+
+        if (!info.isDir())
+            continue;
+
+        QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            files.append(it.next());
+        }
+    }
+    return files;
+}
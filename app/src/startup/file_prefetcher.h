@@ -0,0 +1,23 @@
+#ifndef FILE_PREFETCHER_H
+#define FILE_PREFETCHER_H
+
+#include <QFuture>
+#include <QStringList>
+
+namespace md::app
+{
+// Reads files on a worker thread, so following main thread reads hit the page cache
+class FilePrefetcher
+{
+public:
+    static QFuture<qint64> prefetch(const QStringList& paths);
+
+    // Loads shared libraries, so plugin loaders find them resolved, returns the loaded count
+    static int loadLibraries(const QStringList& paths);
+
+    // Collect regular files from directories recursively, files are passed as is
+    static QStringList collect(const QStringList& paths);
+};
+} // namespace md::app
+
+#endif // FILE_PREFETCHER_H
@@ -0,0 +1,90 @@
+#include "startup_report.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QThread>
+
+using namespace md::app;
+
+StartupReport::StartupReport(QObject* parent) : QObject(parent)
+{
+    m_timer.start();
+}
+
+qint64 StartupReport::elapsed() const
+{
+    return m_timer.elapsed();
+}
+
+bool StartupReport::isFinished() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_finished;
+}
+
+void StartupReport::begin(const QString& phase)
+{
+    const bool mainThread = QThread::currentThread() == qApp->thread();
+    this->addPhase(phase, mainThread ? "main" : "worker");
+}
+
+void StartupReport::beginOnWorker(const QString& phase)
+{
+    this->addPhase(phase, "worker");
+}
+
+void StartupReport::addPhase(const QString& phase, const QString& thread)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_finished)
+        return;
+
+    Phase newPhase;
+    newPhase.name = phase;
+    newPhase.thread = thread;
+    newPhase.started = m_timer.elapsed();
+    m_phases.append(newPhase);
+}
+
+void StartupReport::end(const QString& phase)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_finished)
+        return;
+
+    for (Phase& existing : m_phases)
+    {
+        if (existing.name == phase && existing.ended < 0)
+        {
+            existing.ended = m_timer.elapsed();
+            return;
+        }
+    }
+    qWarning() << "Startup phase was not started:" << phase;
+}
+
+void StartupReport::finish()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    const qint64 total = m_timer.elapsed();
+
+    qInfo().noquote() << "Startup report:";
+    for (const Phase& phase : qAsConst(m_phases))
+    {
+        const qint64 ended = phase.ended < 0 ? total : phase.ended;
+        qInfo().noquote() << QString("  %1 %2 ms (at %3 ms, %4)%5")
+                                 .arg(phase.name, -16)
+                                 .arg(ended - phase.started, 6)
+                                 .arg(phase.started, 6)
+                                 .arg(phase.thread)
+                                 .arg(phase.ended < 0 ? ", unfinished" : "");
+    }
+    qInfo().noquote() << QString("  %1 %2 ms").arg("total", -16).arg(total, 6);
+
+    locker.unlock();
+    emit finished(total);
+}
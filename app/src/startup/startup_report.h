@@ -0,0 +1,50 @@
+#ifndef STARTUP_REPORT_H
+#define STARTUP_REPORT_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+
+namespace md::app
+{
+// Times startup phases, which may overlap and run on different threads
+class StartupReport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StartupReport(QObject* parent = nullptr);
+
+    qint64 elapsed() const;
+    bool isFinished() const;
+
+public slots:
+    void begin(const QString& phase);
+    // Phase started from here, but running on another thread
+    void beginOnWorker(const QString& phase);
+    void end(const QString& phase);
+    void finish();
+
+signals:
+    void finished(qint64 elapsed);
+
+private:
+    void addPhase(const QString& phase, const QString& thread);
+
+    struct Phase
+    {
+        QString name;
+        QString thread;
+        qint64 started = -1;
+        qint64 ended = -1;
+    };
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_timer;
+    QVector<Phase> m_phases;
+    bool m_finished = false;
+};
+} // namespace md::app
+
+#endif // STARTUP_REPORT_H
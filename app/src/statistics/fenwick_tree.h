@@ -0,0 +1,94 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <QVector>
+
+namespace md::domain
+{
+// Binary indexed tree over values, O(log n) point updates and prefix sums
+template<typename T>
+class FenwickTree
+{
+public:
+    int count() const
+    {
+        return m_values.count();
+    }
+
+    T value(int index) const
+    {
+        return m_values.at(index);
+    }
+
+    const QVector<T>& values() const
+    {
+        return m_values;
+    }
+
+    // Linear time construction
+    void build(const QVector<T>& values)
+    {
+        m_values = values;
+        m_tree = values;
+        m_tree.prepend(T());
+
+        for (int i = 1; i < m_tree.count(); ++i)
+        {
+            const int parent = i + (i & -i);
+            if (parent < m_tree.count())
+                m_tree[parent] += m_tree.at(i);
+        }
+    }
+
+    // Logarithmic, the new node covers the values before it up to its lowest bit
+    void append(T value)
+    {
+        if (m_tree.isEmpty())
+            m_tree.append(T());
+
+        const int node = m_tree.count();
+        m_values.append(value);
+        m_tree.append(value + this->prefix(node - 1) - this->prefix(node - (node & -node)));
+    }
+
+    // Constant, no node before the last one covers it
+    void removeLast()
+    {
+        m_values.removeLast();
+        m_tree.removeLast();
+    }
+
+    void set(int index, T value)
+    {
+        const T delta = value - m_values.at(index);
+        m_values[index] = value;
+
+        for (int i = index + 1; i < m_tree.count(); i += i & -i)
+        {
+            m_tree[i] += delta;
+        }
+    }
+
+    // Sum of the first count values
+    T prefix(int count) const
+    {
+        T sum = T();
+        for (int i = qMin(count, m_values.count()); i > 0; i -= i & -i)
+        {
+            sum += m_tree.at(i);
+        }
+        return sum;
+    }
+
+    T total() const
+    {
+        return this->prefix(m_values.count());
+    }
+
+private:
+    QVector<T> m_values;
+    QVector<T> m_tree;
+};
+} // namespace md::domain
+
+#endif // FENWICK_TREE_H
@@ -0,0 +1,278 @@
+#include "mission_route_statistics.h"
+
+#include <QtMath>
+
+#include "geodesy_kernels.h"
+
+namespace
+{
+constexpr char distance[] = "distance";
+constexpr char duration[] = "duration";
+constexpr char climb[] = "climb";
+constexpr char descent[] = "descent";
+constexpr char bearing[] = "bearing";
+constexpr char distanceTo[] = "distanceTo";
+constexpr char etaTo[] = "etaTo";
+
+// Appending at the end is logarithmic, a slot in the middle rebuilds the tree
+void insertSlot(md::domain::FenwickTree<double>& tree, int index)
+{
+    if (index == tree.count())
+    {
+        tree.append(0);
+        return;
+    }
+
+    QVector<double> values = tree.values();
+    values.insert(index, 0);
+    tree.build(values);
+}
+
+void removeSlot(md::domain::FenwickTree<double>& tree, int index)
+{
+    if (index == tree.count() - 1)
+    {
+        tree.removeLast();
+        return;
+    }
+
+    QVector<double> values = tree.values();
+    values.removeAt(index);
+    tree.build(values);
+}
+} // namespace
+
+using namespace md::domain;
+
+void MissionRouteStatistics::reset(MissionRoute* route)
+{
+    const int count = route->count();
+    m_latitudes.resize(count);
+    m_longitudes.resize(count);
+    m_altitudes.resize(count);
+    m_speeds.resize(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        this->readItem(i, route->item(i));
+    }
+
+    // All legs in one batch and every tree built once
+    const int legs = this->legCount();
+    QVector<double> distances(legs, 0);
+    QVector<double> durations(legs, 0);
+    QVector<double> climbs(legs, 0);
+    QVector<double> descents(legs, 0);
+    m_bearings.fill(0, legs);
+    if (legs > 0)
+    {
+        geodesy::legs(m_latitudes.constData(), m_longitudes.constData(), distances.data(),
+                      m_bearings.data(), count);
+    }
+
+    for (int i = 0; i < legs; ++i)
+    {
+        // Legs touching items without position are not counted
+        if (qIsNaN(m_latitudes.at(i)) || qIsNaN(m_latitudes.at(i + 1)))
+        {
+            distances[i] = 0;
+            m_bearings[i] = qQNaN();
+            continue;
+        }
+
+        double altitudeDelta = m_altitudes.at(i + 1) - m_altitudes.at(i);
+        if (qIsNaN(altitudeDelta))
+            altitudeDelta = 0;
+
+        durations[i] = distances.at(i) / m_speeds.at(i + 1);
+        climbs[i] = qMax(altitudeDelta, 0.0);
+        descents[i] = qMax(-altitudeDelta, 0.0);
+    }
+
+    m_distances.build(distances);
+    m_durations.build(durations);
+    m_climbs.build(climbs);
+    m_descents.build(descents);
+}
+
+void MissionRouteStatistics::insertItem(int index, MissionRouteItem* item)
+{
+    const int legs = this->legCount();
+
+    m_latitudes.insert(index, 0);
+    m_longitudes.insert(index, 0);
+    m_altitudes.insert(index, 0);
+    m_speeds.insert(index, 0);
+    this->readItem(index, item);
+
+    // The leg crossing the new item splits in two, the rest only shift
+    if (this->legCount() > legs)
+    {
+        const int slot = qMin(index, legs);
+        m_bearings.insert(slot, 0);
+        ::insertSlot(m_distances, slot);
+        ::insertSlot(m_durations, slot);
+        ::insertSlot(m_climbs, slot);
+        ::insertSlot(m_descents, slot);
+    }
+
+    this->updateLeg(index - 1);
+    this->updateLeg(index);
+}
+
+void MissionRouteStatistics::updateItem(int index, MissionRouteItem* item)
+{
+    if (index < 0 || index >= this->count())
+        return;
+
+    this->readItem(index, item);
+    this->updateLeg(index - 1);
+    this->updateLeg(index);
+}
+
+void MissionRouteStatistics::removeItem(int index)
+{
+    if (index < 0 || index >= this->count())
+        return;
+
+    const int legs = this->legCount();
+
+    m_latitudes.removeAt(index);
+    m_longitudes.removeAt(index);
+    m_altitudes.removeAt(index);
+    m_speeds.removeAt(index);
+
+    // Two legs around the removed item merge in one
+    if (legs > 0)
+    {
+        const int slot = qMin(index, legs - 1);
+        m_bearings.removeAt(slot);
+        ::removeSlot(m_distances, slot);
+        ::removeSlot(m_durations, slot);
+        ::removeSlot(m_climbs, slot);
+        ::removeSlot(m_descents, slot);
+    }
+
+    this->updateLeg(index - 1);
+}
+
+int MissionRouteStatistics::count() const
+{
+    return m_latitudes.count();
+}
+
+double MissionRouteStatistics::totalDistance() const
+{
+    return m_distances.total();
+}
+
+double MissionRouteStatistics::totalDuration() const
+{
+    return m_durations.total();
+}
+
+double MissionRouteStatistics::totalClimb() const
+{
+    return m_climbs.total();
+}
+
+double MissionRouteStatistics::totalDescent() const
+{
+    return m_descents.total();
+}
+
+double MissionRouteStatistics::distanceTo(int index) const
+{
+    return m_distances.prefix(index);
+}
+
+double MissionRouteStatistics::etaTo(int index) const
+{
+    return m_durations.prefix(index);
+}
+
+double MissionRouteStatistics::legDistance(int index) const
+{
+    if (index < 0 || index >= this->legCount())
+        return 0;
+
+    return m_distances.value(index);
+}
+
+double MissionRouteStatistics::legBearing(int index) const
+{
+    if (index < 0 || index >= this->legCount())
+        return qQNaN();
+
+    return m_bearings.at(index);
+}
+
+QVariantMap MissionRouteStatistics::toVariantMap() const
+{
+    return { { ::distance, this->totalDistance() },
+             { ::duration, this->totalDuration() },
+             { ::climb, this->totalClimb() },
+             { ::descent, this->totalDescent() } };
+}
+
+QVariantMap MissionRouteStatistics::itemToVariantMap(int index) const
+{
+    if (index < 0 || index >= this->count())
+        return QVariantMap();
+
+    QVariantMap map = { { ::distanceTo, this->distanceTo(index) },
+                        { ::etaTo, this->etaTo(index) } };
+
+    if (index < this->legCount())
+    {
+        map.insert(::distance, m_distances.value(index));
+        map.insert(::duration, m_durations.value(index));
+        map.insert(::climb, m_climbs.value(index));
+        map.insert(::descent, m_descents.value(index));
+        if (!qIsNaN(m_bearings.at(index)))
+            map.insert(::bearing, m_bearings.at(index));
+    }
+    return map;
+}
+
+void MissionRouteStatistics::readItem(int index, MissionRouteItem* item)
+{
+    const Geodetic position = item->position();
+    m_latitudes[index] = position.isValid() ? position.latitude() : qQNaN();
+    m_longitudes[index] = position.isValid() ? position.longitude() : qQNaN();
+    m_altitudes[index] = position.isValid() ? position.altitude() : qQNaN();
+
+    const double speed = item->parametersMap().value(speedParameter).toDouble();
+    m_speeds[index] = speed > 0 ? speed : defaultSpeed;
+}
+
+void MissionRouteStatistics::updateLeg(int index)
+{
+    if (index < 0 || index >= this->legCount())
+        return;
+
+    double distance = 0;
+    double bearing = qQNaN();
+    double altitudeDelta = 0;
+
+    // Legs touching items without position are not counted
+    if (!qIsNaN(m_latitudes.at(index)) && !qIsNaN(m_latitudes.at(index + 1)))
+    {
+        geodesy::legs(m_latitudes.constData() + index, m_longitudes.constData() + index,
+                      &distance, &bearing, 2);
+        altitudeDelta = m_altitudes.at(index + 1) - m_altitudes.at(index);
+        if (qIsNaN(altitudeDelta))
+            altitudeDelta = 0;
+    }
+
+    m_bearings[index] = bearing;
+    m_distances.set(index, distance);
+    m_durations.set(index, distance / m_speeds.at(index + 1));
+    m_climbs.set(index, qMax(altitudeDelta, 0.0));
+    m_descents.set(index, qMax(-altitudeDelta, 0.0));
+}
+
+int MissionRouteStatistics::legCount() const
+{
+    return qMax(this->count() - 1, 0);
+}
@@ -0,0 +1,57 @@
+#ifndef MISSION_ROUTE_STATISTICS_H
+#define MISSION_ROUTE_STATISTICS_H
+
+#include "fenwick_tree.h"
+#include "i_missions_service.h"
+
+namespace md::domain
+{
+// Route metrics patched per item change, legs are kept in prefix sum trees
+class MissionRouteStatistics
+{
+public:
+    static constexpr char speedParameter[] = "speed";
+    static constexpr double defaultSpeed = 15.0;
+
+    void reset(MissionRoute* route);
+    void insertItem(int index, MissionRouteItem* item);
+    void updateItem(int index, MissionRouteItem* item);
+    void removeItem(int index);
+
+    int count() const;
+
+    double totalDistance() const;
+    double totalDuration() const;
+    double totalClimb() const;
+    double totalDescent() const;
+
+    // Along the route from the first item
+    double distanceTo(int index) const;
+    double etaTo(int index) const;
+
+    // Leg from item index to the next one, NaN bearing for unpositioned items
+    double legDistance(int index) const;
+    double legBearing(int index) const;
+
+    QVariantMap toVariantMap() const;
+    QVariantMap itemToVariantMap(int index) const;
+
+private:
+    void readItem(int index, MissionRouteItem* item);
+    void updateLeg(int index);
+    int legCount() const;
+
+    QVector<double> m_latitudes;
+    QVector<double> m_longitudes;
+    QVector<double> m_altitudes;
+    QVector<double> m_speeds;
+
+    QVector<double> m_bearings;
+    FenwickTree<double> m_distances;
+    FenwickTree<double> m_durations;
+    FenwickTree<double> m_climbs;
+    FenwickTree<double> m_descents;
+};
+} // namespace md::domain
+
+#endif // MISSION_ROUTE_STATISTICS_H
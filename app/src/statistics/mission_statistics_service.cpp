@@ -0,0 +1,114 @@
+#include "mission_statistics_service.h"
+
+#include <QDebug>
+
+using namespace md::domain;
+
+MissionStatisticsService::MissionStatisticsService(IMissionsService* missions, QObject* parent) :
+    QObject(parent),
+    m_missions(missions)
+{
+    m_notifyTimer.setSingleShot(true);
+    m_notifyTimer.setInterval(0);
+    connect(&m_notifyTimer, &QTimer::timeout, this, &MissionStatisticsService::notify);
+
+    connect(m_missions, &IMissionsService::missionAdded, this,
+            &MissionStatisticsService::onMissionAdded);
+    connect(m_missions, &IMissionsService::missionRemoved, this,
+            &MissionStatisticsService::onMissionRemoved);
+
+    for (Mission* mission : m_missions->missions())
+    {
+        this->onMissionAdded(mission);
+    }
+}
+
+const MissionRouteStatistics* MissionStatisticsService::statistics(Mission* mission)
+{
+    if (!m_statistics.contains(mission))
+        return nullptr;
+
+    this->rebuildIfStale(mission);
+    return &m_statistics[mission];
+}
+
+void MissionStatisticsService::onMissionAdded(Mission* mission)
+{
+    m_statistics[mission].reset(mission->route());
+
+    connect(mission->route, &MissionRoute::itemAdded, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                this->onItemAdded(mission, index, item);
+            });
+    connect(mission->route, &MissionRoute::itemChanged, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                this->onItemChanged(mission, index, item);
+            });
+    connect(mission->route, &MissionRoute::itemRemoved, this, [this, mission](int index) {
+        this->onItemRemoved(mission, index);
+    });
+}
+
+void MissionStatisticsService::onMissionRemoved(Mission* mission)
+{
+    disconnect(mission->route, nullptr, this, nullptr);
+    m_statistics.remove(mission);
+    m_stale.remove(mission);
+    m_changed.remove(mission);
+}
+
+void MissionStatisticsService::onItemAdded(Mission* mission, int index, MissionRouteItem* item)
+{
+    // Only appends are cheap to patch, anything else waits for a single rebuild
+    MissionRouteStatistics& statistics = m_statistics[mission];
+    if (index != statistics.count())
+        m_stale.insert(mission);
+    else if (!m_stale.contains(mission))
+        statistics.insertItem(index, item);
+
+    this->markChanged(mission);
+}
+
+void MissionStatisticsService::onItemChanged(Mission* mission, int index, MissionRouteItem* item)
+{
+    if (!m_stale.contains(mission))
+        m_statistics[mission].updateItem(index, item);
+
+    this->markChanged(mission);
+}
+
+void MissionStatisticsService::onItemRemoved(Mission* mission, int index)
+{
+    MissionRouteStatistics& statistics = m_statistics[mission];
+    if (index != statistics.count() - 1)
+        m_stale.insert(mission);
+    else if (!m_stale.contains(mission))
+        statistics.removeItem(index);
+
+    this->markChanged(mission);
+}
+
+void MissionStatisticsService::notify()
+{
+    const QSet<Mission*> changed = m_changed;
+    m_changed.clear();
+
+    for (Mission* mission : changed)
+    {
+        this->rebuildIfStale(mission);
+        emit statisticsChanged(mission);
+    }
+}
+
+void MissionStatisticsService::markChanged(Mission* mission)
+{
+    m_changed.insert(mission);
+    if (!m_notifyTimer.isActive())
+        m_notifyTimer.start();
+}
+
+void MissionStatisticsService::rebuildIfStale(Mission* mission)
+{
+    if (m_stale.remove(mission))
+        m_statistics[mission].reset(mission->route());
+}
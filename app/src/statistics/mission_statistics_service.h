@@ -0,0 +1,48 @@
+#ifndef MISSION_STATISTICS_SERVICE_H
+#define MISSION_STATISTICS_SERVICE_H
+
+#include "i_missions_service.h"
+#include "mission_route_statistics.h"
+
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+namespace md::domain
+{
+// Keeps route statistics of every mission up to date with route edits. Appends and item changes
+// are patched in place, edits in the middle of a route rebuild it once, changes are notified once
+// per event loop pass, so loading a route costs as much as a single rebuild
+class MissionStatisticsService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MissionStatisticsService(IMissionsService* missions, QObject* parent = nullptr);
+
+    const MissionRouteStatistics* statistics(Mission* mission);
+
+signals:
+    void statisticsChanged(Mission* mission);
+
+private slots:
+    void onMissionAdded(Mission* mission);
+    void onMissionRemoved(Mission* mission);
+    void onItemAdded(Mission* mission, int index, MissionRouteItem* item);
+    void onItemChanged(Mission* mission, int index, MissionRouteItem* item);
+    void onItemRemoved(Mission* mission, int index);
+    void notify();
+
+private:
+    void markChanged(Mission* mission);
+    void rebuildIfStale(Mission* mission);
+
+    IMissionsService* const m_missions;
+    QHash<Mission*, MissionRouteStatistics> m_statistics;
+    QSet<Mission*> m_stale;   // Rebuilt from the route on the next read
+    QSet<Mission*> m_changed; // Notified on the next pass
+    QTimer m_notifyTimer;
+};
+} // namespace md::domain
+
+#endif // MISSION_STATISTICS_SERVICE_H
@@ -0,0 +1,166 @@
+#include "mission_sync_service.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+
+namespace
+{
+// Local only or onboard status keys, not part of the synced item
+constexpr char id[] = "id";
+constexpr char current[] = "current";
+constexpr char reached[] = "reached";
+
+constexpr char known[] = "known";
+constexpr char synced[] = "synced";
+constexpr char inserted[] = "inserted";
+constexpr char removed[] = "removed";
+constexpr char replaced[] = "replaced";
+constexpr char transferFrom[] = "transferFrom";
+constexpr char transferCount[] = "transferCount";
+constexpr char partial[] = "partial";
+} // namespace
+
+using namespace md::domain;
+
+MissionSyncService::MissionSyncService(IMissionsService* missions, QObject* parent) :
+    QObject(parent),
+    m_missions(missions)
+{
+    connect(m_missions, &IMissionsService::missionAdded, this,
+            &MissionSyncService::onMissionAdded);
+    connect(m_missions, &IMissionsService::missionRemoved, this,
+            &MissionSyncService::onMissionRemoved);
+    connect(m_missions, &IMissionsService::operationEnded, this,
+            &MissionSyncService::onOperationEnded);
+
+    for (Mission* mission : m_missions->missions())
+    {
+        this->onMissionAdded(mission);
+    }
+}
+
+quint64 MissionSyncService::itemHash(MissionRouteItem* item)
+{
+    QVariantMap map = item->toVariantMap();
+    map.remove(::id);
+    map.remove(::current);
+    map.remove(::reached);
+
+    const QByteArray hash = QCryptographicHash::hash(
+        QJsonDocument(QJsonObject::fromVariantMap(map)).toJson(QJsonDocument::Compact),
+        QCryptographicHash::Md5);
+    return qFromLittleEndian<quint64>(hash.constData());
+}
+
+bool MissionSyncService::isKnown(Mission* mission) const
+{
+    return m_onboard.contains(mission);
+}
+
+QVector<RouteEdit> MissionSyncService::editScript(Mission* mission) const
+{
+    QVector<RouteEdit> script;
+    if (!this->isKnown(mission))
+        return script;
+
+    const QVector<quint64> onboard = m_onboard.value(mission);
+    const QVector<quint64> local = m_local.value(mission);
+    if (!diffRoutes(onboard, local, script))
+        script = rewriteRoute(onboard.count(), local.count());
+
+    return script;
+}
+
+QVariantMap MissionSyncService::syncState(Mission* mission) const
+{
+    if (!this->isKnown(mission))
+        return { { ::known, false } };
+
+    const QVector<RouteEdit> script = this->editScript(mission);
+    const int localCount = m_local.value(mission).count();
+
+    int inserted = 0, removed = 0, replaced = 0;
+    for (const RouteEdit& edit : script)
+    {
+        inserted += edit.type == RouteEdit::Insert;
+        removed += edit.type == RouteEdit::Remove;
+        replaced += edit.type == RouteEdit::Replace;
+    }
+    const RouteTransfer transfer = routeTransfer(script, localCount);
+
+    return { { ::known, true },
+             { ::synced, script.isEmpty() },
+             { ::inserted, inserted },
+             { ::removed, removed },
+             { ::replaced, replaced },
+             { ::transferFrom, transfer.from },
+             { ::transferCount, transfer.count },
+             { ::partial, transfer.partial } };
+}
+
+void MissionSyncService::onMissionAdded(Mission* mission)
+{
+    QVector<quint64>& hashes = m_local[mission];
+    MissionRoute* route = mission->route();
+    hashes.resize(route->count());
+    for (int i = 0; i < route->count(); ++i)
+    {
+        hashes[i] = MissionSyncService::itemHash(route->item(i));
+    }
+
+    // Only the edited item is rehashed
+    connect(mission->route, &MissionRoute::itemAdded, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                m_local[mission].insert(index, MissionSyncService::itemHash(item));
+                emit syncChanged(mission);
+            });
+    connect(mission->route, &MissionRoute::itemChanged, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                QVector<quint64>& hashes = m_local[mission];
+                if (index < 0 || index >= hashes.count())
+                    return;
+
+                hashes[index] = MissionSyncService::itemHash(item);
+                emit syncChanged(mission);
+            });
+    connect(mission->route, &MissionRoute::itemRemoved, this, [this, mission](int index) {
+        QVector<quint64>& hashes = m_local[mission];
+        if (index < 0 || index >= hashes.count())
+            return;
+
+        hashes.removeAt(index);
+        emit syncChanged(mission);
+    });
+}
+
+void MissionSyncService::onMissionRemoved(Mission* mission)
+{
+    disconnect(mission->route, nullptr, this, nullptr);
+    m_local.remove(mission);
+    m_onboard.remove(mission);
+}
+
+void MissionSyncService::onOperationEnded(MissionOperation* operation)
+{
+    if (operation->state() != MissionOperation::Succeeded)
+        return;
+
+    Mission* mission = operation->mission();
+    switch (operation->type())
+    {
+    case MissionOperation::Upload:
+    case MissionOperation::Download:
+        m_onboard.insert(mission, m_local.value(mission));
+        break;
+    case MissionOperation::Clear:
+        m_onboard.insert(mission, QVector<quint64>());
+        break;
+    default:
+        return;
+    }
+
+    emit syncChanged(mission);
+}
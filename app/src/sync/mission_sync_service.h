@@ -0,0 +1,41 @@
+#ifndef MISSION_SYNC_SERVICE_H
+#define MISSION_SYNC_SERVICE_H
+
+#include "i_missions_service.h"
+#include "route_diff.h"
+
+#include <QHash>
+
+namespace md::domain
+{
+// Tracks item hashes of the last synced onboard routes against local edits
+class MissionSyncService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MissionSyncService(IMissionsService* missions, QObject* parent = nullptr);
+
+    static quint64 itemHash(MissionRouteItem* item);
+
+    // Onboard route state is known after a successful upload, download or clear
+    bool isKnown(Mission* mission) const;
+    QVector<RouteEdit> editScript(Mission* mission) const;
+    QVariantMap syncState(Mission* mission) const;
+
+signals:
+    void syncChanged(Mission* mission);
+
+private slots:
+    void onMissionAdded(Mission* mission);
+    void onMissionRemoved(Mission* mission);
+    void onOperationEnded(MissionOperation* operation);
+
+private:
+    IMissionsService* const m_missions;
+    QHash<Mission*, QVector<quint64>> m_local;
+    QHash<Mission*, QVector<quint64>> m_onboard;
+};
+} // namespace md::domain
+
+#endif // MISSION_SYNC_SERVICE_H
@@ -0,0 +1,156 @@
+#include "route_diff.h"
+
+#include <algorithm>
+
+using namespace md::domain;
+
+bool md::domain::diffRoutes(const QVector<quint64>& onboard, const QVector<quint64>& local,
+                            QVector<RouteEdit>& script, int maxEdits)
+{
+    script.clear();
+
+    // Common prefix and suffix are unchanged, the search runs only between them
+    int prefix = 0;
+    while (prefix < onboard.count() && prefix < local.count() &&
+           onboard.at(prefix) == local.at(prefix))
+    {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < onboard.count() - prefix && suffix < local.count() - prefix &&
+           onboard.at(onboard.count() - 1 - suffix) == local.at(local.count() - 1 - suffix))
+    {
+        suffix++;
+    }
+
+    const quint64* a = onboard.constData() + prefix;
+    const quint64* b = local.constData() + prefix;
+    const int n = onboard.count() - prefix - suffix;
+    const int m = local.count() - prefix - suffix;
+    const int max = qMin(n + m, maxEdits);
+    if (n + m > 0 && max == 0)
+        return false;
+
+    // Furthest reaching x per diagonal k, offset by max; saved for every edit count
+    QVector<int> v(2 * max + 2, 0);
+    QVector<QVector<int>> trace;
+    int edits = -1;
+    for (int d = 0; d <= max && edits < 0; ++d)
+    {
+        trace.append(v);
+        for (int k = -d; k <= d; k += 2)
+        {
+            int x = (k == -d || (k != d && v.at(max + k - 1) < v.at(max + k + 1)))
+                        ? v.at(max + k + 1)
+                        : v.at(max + k - 1) + 1;
+            int y = x - k;
+            while (x < n && y < m && a[x] == b[y])
+            {
+                x++;
+                y++;
+            }
+            v[max + k] = x;
+
+            if (x >= n && y >= m)
+            {
+                edits = d;
+                break;
+            }
+        }
+    }
+
+    if (edits < 0)
+        return false;
+
+    // Walk the trace back from the end, collecting edits in reverse
+    QVector<RouteEdit> reversed;
+    int x = n;
+    int y = m;
+    for (int d = edits; d > 0; --d)
+    {
+        const QVector<int>& previous = trace.at(d);
+        const int k = x - y;
+        const int previousK = (k == -d || (k != d && previous.at(max + k - 1) <
+                                                         previous.at(max + k + 1)))
+                                  ? k + 1
+                                  : k - 1;
+        const int previousX = previous.at(max + previousK);
+        const int previousY = previousX - previousK;
+
+        while (x > previousX && y > previousY)
+        {
+            x--;
+            y--;
+        }
+
+        if (x == previousX)
+            reversed.append({ RouteEdit::Insert, prefix + previousX, prefix + previousY });
+        else
+            reversed.append({ RouteEdit::Remove, prefix + previousX, prefix + previousY });
+
+        x = previousX;
+        y = previousY;
+    }
+
+    // Removal and insertion at the same place make a replacement
+    for (int i = reversed.count() - 1; i >= 0; --i)
+    {
+        const RouteEdit& edit = reversed.at(i);
+        if (i > 0)
+        {
+            const RouteEdit& next = reversed.at(i - 1);
+            const bool removeInsert = edit.type == RouteEdit::Remove &&
+                                      next.type == RouteEdit::Insert &&
+                                      next.onboardIndex == edit.onboardIndex + 1 &&
+                                      next.localIndex == edit.localIndex;
+            const bool insertRemove = edit.type == RouteEdit::Insert &&
+                                      next.type == RouteEdit::Remove &&
+                                      next.onboardIndex == edit.onboardIndex &&
+                                      next.localIndex == edit.localIndex + 1;
+            if (removeInsert || insertRemove)
+            {
+                script.append({ RouteEdit::Replace, edit.onboardIndex, edit.localIndex });
+                --i;
+                continue;
+            }
+        }
+        script.append(edit);
+    }
+    return true;
+}
+
+QVector<RouteEdit> md::domain::rewriteRoute(int onboardCount, int localCount)
+{
+    QVector<RouteEdit> script;
+    for (int i = 0; i < qMax(onboardCount, localCount); ++i)
+    {
+        if (i >= localCount)
+            script.append({ RouteEdit::Remove, i, localCount });
+        else if (i >= onboardCount)
+            script.append({ RouteEdit::Insert, onboardCount, i });
+        else
+            script.append({ RouteEdit::Replace, i, i });
+    }
+    return script;
+}
+
+RouteTransfer md::domain::routeTransfer(const QVector<RouteEdit>& script, int localCount)
+{
+    RouteTransfer transfer;
+    transfer.from = localCount;
+    transfer.partial = true;
+    if (script.isEmpty())
+        return transfer;
+
+    int first = localCount, last = -1;
+    for (const RouteEdit& edit : script)
+    {
+        transfer.partial &= edit.type == RouteEdit::Replace;
+        first = qMin(first, edit.localIndex);
+        last = qMax(last, edit.localIndex);
+    }
+
+    transfer.from = qMin(first, localCount);
+    transfer.count = transfer.partial ? last - first + 1 : localCount - transfer.from;
+    return transfer;
+}
@@ -0,0 +1,43 @@
+#ifndef ROUTE_DIFF_H
+#define ROUTE_DIFF_H
+
+#include <QVector>
+
+namespace md::domain
+{
+struct RouteEdit
+{
+    enum Type
+    {
+        Insert,
+        Remove,
+        Replace
+    };
+
+    Type type;
+    int onboardIndex; // Item of the onboard route, or where the local one goes to
+    int localIndex;   // Item of the local route, or where the onboard one was
+};
+
+// Local items a transfer writes to carry out an edit script
+struct RouteTransfer
+{
+    int from = 0;
+    int count = 0;
+    bool partial = false; // Item count is kept, the range is written in place
+};
+
+// Minimal edit script from the onboard to the local route over item hashes (Myers),
+// false if it takes more than maxEdits
+bool diffRoutes(const QVector<quint64>& onboard, const QVector<quint64>& local,
+                QVector<RouteEdit>& script, int maxEdits = 256);
+
+// Script replacing every item, for routes too different to diff
+QVector<RouteEdit> rewriteRoute(int onboardCount, int localCount);
+
+// Partial writes replace a contiguous range and keep the item count,
+// otherwise everything from the first change is sent
+RouteTransfer routeTransfer(const QVector<RouteEdit>& script, int localCount);
+} // namespace md::domain
+
+#endif // ROUTE_DIFF_H
@@ -0,0 +1,226 @@
+#include "telemetry_rate_service.h"
+
+#include <QDebug>
+#include <QtMath>
+
+#include "geodesy_kernels.h"
+
+namespace
+{
+constexpr char latitude[] = "latitude";
+constexpr char longitude[] = "longitude";
+
+// MAVLink message ids
+constexpr int sysStatus = 1;
+constexpr int gpsRawInt = 24;
+constexpr int attitude = 30;
+constexpr int globalPositionInt = 33;
+constexpr int missionCurrent = 42;
+constexpr int navControllerOutput = 62;
+constexpr int vfrHud = 74;
+
+constexpr double minViewRadius = 500;
+// Vehicles leave the view a bit further than they enter it, so rates don't flap on the edge
+constexpr double visibilityHysteresis = 1.2;
+} // namespace
+
+using namespace md::domain;
+
+TelemetryRateService::TelemetryRateService(IVehiclesService* vehicles, IPropertyTree* pTree,
+                                           QObject* parent) :
+    QObject(parent),
+    m_vehicles(vehicles),
+    m_pTree(pTree)
+{
+    connect(m_vehicles, &IVehiclesService::vehicleRemoved, this, [this](Vehicle* vehicle) {
+        m_tiers.remove(vehicle->id().toString());
+        m_intervals.remove(vehicle->id().toString());
+    });
+
+    m_timer.setInterval(evaluateInterval);
+    connect(&m_timer, &QTimer::timeout, this, &TelemetryRateService::evaluate);
+    m_timer.start();
+}
+
+TelemetryRateService::Tier TelemetryRateService::tier(const QVariant& vehicleId) const
+{
+    return m_tiers.value(vehicleId.toString(), Background);
+}
+
+QVariantMap TelemetryRateService::vehicleIntervals(const QVariant& vehicleId) const
+{
+    return m_intervals.value(vehicleId.toString());
+}
+
+int TelemetryRateService::budgetFactor() const
+{
+    return m_budgetFactor;
+}
+
+QVariant TelemetryRateService::selectedVehicle() const
+{
+    return m_selectedVehicleId;
+}
+
+bool TelemetryRateService::isTracking() const
+{
+    return m_tracking;
+}
+
+Geodetic TelemetryRateService::viewCenter() const
+{
+    return m_viewCenter;
+}
+
+Geodetic TelemetryRateService::viewCamera() const
+{
+    return m_viewCamera;
+}
+
+QMap<int, int> TelemetryRateService::intervals(Tier tier, int budgetFactor)
+{
+    // Rates in Hz per tier: tracked, selected, visible, background
+    static const QMap<int, QVector<double>> rates = {
+        { ::attitude, { 25, 10, 2, 0.5 } },
+        { ::globalPositionInt, { 10, 5, 2, 1 } },
+        { ::vfrHud, { 10, 4, 1, 0.5 } },
+        { ::navControllerOutput, { 4, 2, 0.5, 0.2 } },
+        { ::sysStatus, { 2, 2, 1, 0.5 } },
+        { ::gpsRawInt, { 2, 2, 1, 0.2 } },
+        { ::missionCurrent, { 1, 1, 0.5, 0.2 } },
+    };
+
+    // The focused vehicle is the last to slow down on a busy link
+    const int factor = tier <= Selected ? qMax(1, budgetFactor / 4) : budgetFactor;
+
+    QMap<int, int> intervals;
+    for (auto it = rates.constBegin(); it != rates.constEnd(); ++it)
+    {
+        intervals.insert(it.key(), qRound(1e6 / it->at(tier) * factor));
+    }
+    return intervals;
+}
+
+void TelemetryRateService::setSelectedVehicle(const QVariant& vehicleId)
+{
+    if (m_selectedVehicleId == vehicleId)
+        return;
+
+    m_selectedVehicleId = vehicleId;
+    this->updateTiers();
+    emit viewChanged();
+}
+
+void TelemetryRateService::setTracking(bool tracking)
+{
+    if (m_tracking == tracking)
+        return;
+
+    m_tracking = tracking;
+    this->updateTiers();
+    emit viewChanged();
+}
+
+void TelemetryRateService::setViewport(const Geodetic& center, const Geodetic& camera)
+{
+    if (!center.isValid() || !camera.isValid())
+        return;
+
+    // Slant range to the center roughly spans half of the default 60 degree field of view
+    double distance = 0;
+    const double latitudes[] = { center.latitude(), camera.latitude() };
+    const double longitudes[] = { center.longitude(), camera.longitude() };
+    geodesy::haversine(latitudes, longitudes, latitudes + 1, longitudes + 1, &distance, 1);
+
+    const double height = camera.altitude() - center.altitude();
+    m_viewCenter = center;
+    m_viewCamera = camera;
+    m_viewRadius = qMax(::minViewRadius, qSqrt(distance * distance + height * height));
+    emit viewChanged();
+}
+
+void TelemetryRateService::setLinkUtilization(double utilization)
+{
+    m_utilization = utilization;
+    m_reportAge = 0;
+}
+
+void TelemetryRateService::evaluate()
+{
+    this->updateBudget();
+    this->updateTiers();
+}
+
+void TelemetryRateService::updateTiers(const QVariantList& vehicleIds)
+{
+    for (const QVariant& vehicleId : vehicleIds)
+    {
+        const QString key = vehicleId.toString();
+
+        Tier tier = Background;
+        if (vehicleId == m_selectedVehicleId)
+            tier = m_tracking ? Tracked : Selected;
+        else if (this->isVisible(vehicleId, m_tiers.value(key, Background) == Visible))
+            tier = Visible;
+
+        QVariantMap intervals;
+        const QMap<int, int> tierIntervals = TelemetryRateService::intervals(tier, m_budgetFactor);
+        for (auto it = tierIntervals.constBegin(); it != tierIntervals.constEnd(); ++it)
+        {
+            intervals.insert(QString::number(it.key()), it.value());
+        }
+
+        m_tiers.insert(key, tier);
+        if (m_intervals.value(key) == intervals)
+            continue;
+
+        m_intervals.insert(key, intervals);
+        emit intervalsChanged(vehicleId, intervals);
+    }
+}
+
+void TelemetryRateService::updateBudget()
+{
+    // Every report moves the budget once, a silent link module no longer holds it down
+    if (m_reportAge == 0)
+    {
+        if (m_utilization > highUtilization)
+            m_budgetFactor = qMin(m_budgetFactor * 2, maxBudgetFactor);
+        else if (m_utilization < lowUtilization)
+            m_budgetFactor = qMax(m_budgetFactor / 2, 1);
+    }
+    else if (m_reportAge >= staleEvaluations)
+    {
+        m_budgetFactor = qMax(m_budgetFactor / 2, 1);
+    }
+    m_reportAge = qMin(m_reportAge + 1, staleEvaluations);
+}
+
+void TelemetryRateService::updateTiers()
+{
+    QVariantList vehicleIds;
+    for (Vehicle* vehicle : m_vehicles->vehicles())
+    {
+        vehicleIds.append(vehicle->id());
+    }
+    this->updateTiers(vehicleIds);
+}
+
+bool TelemetryRateService::isVisible(const QVariant& vehicleId, bool wasVisible) const
+{
+    // Without a viewport yet every vehicle counts as shown
+    if (!m_viewCenter.isValid())
+        return true;
+
+    const QVariantMap properties = m_pTree->properties(vehicleId.toString());
+    if (!properties.contains(::latitude) || !properties.contains(::longitude))
+        return false;
+
+    double distance = 0;
+    const double latitudes[] = { m_viewCenter.latitude(), properties.value(::latitude).toDouble() };
+    const double longitudes[] = { m_viewCenter.longitude(),
+                                  properties.value(::longitude).toDouble() };
+    geodesy::haversine(latitudes, longitudes, latitudes + 1, longitudes + 1, &distance, 1);
+
+    return distance < m_viewRadius * (wasVisible ? ::visibilityHysteresis : 1.0);
+}
@@ -0,0 +1,92 @@
+#ifndef TELEMETRY_RATE_SERVICE_H
+#define TELEMETRY_RATE_SERVICE_H
+
+#include "geodetic.h"
+#include "i_property_tree.h"
+#include "i_vehicles_service.h"
+
+#include <QTimer>
+
+namespace md::domain
+{
+// Chooses telemetry message intervals per vehicle from what the UI shows and what the link
+// carries. The link module takes the service from the Locator, applies intervalsChanged with
+// SET_MESSAGE_INTERVAL and reports its utilisation, the core has no link statistics of its own.
+// Tiers and intervals stay here, they are not vehicle telemetry.
+class TelemetryRateService : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Tier
+    {
+        Tracked,
+        Selected,
+        Visible,
+        Background
+    };
+
+    static constexpr int evaluateInterval = 1000;
+    static constexpr int maxBudgetFactor = 16;
+    // Link utilisation bounds for slowing down and speeding up the streams
+    static constexpr double highUtilization = 0.8;
+    static constexpr double lowUtilization = 0.5;
+    // Evaluations without a utilisation report before the budget relaxes on its own
+    static constexpr int staleEvaluations = 5;
+
+    TelemetryRateService(IVehiclesService* vehicles, IPropertyTree* pTree,
+                         QObject* parent = nullptr);
+
+    Tier tier(const QVariant& vehicleId) const;
+    QVariantMap vehicleIntervals(const QVariant& vehicleId) const; // For links joining late
+    int budgetFactor() const;
+
+    // What the UI shows, a GUI attached to a headless core hands it over
+    QVariant selectedVehicle() const;
+    bool isTracking() const;
+    Geodetic viewCenter() const;
+    Geodetic viewCamera() const;
+
+    // Message interval in microseconds by MAVLink message id
+    static QMap<int, int> intervals(Tier tier, int budgetFactor);
+
+public slots:
+    void setSelectedVehicle(const QVariant& vehicleId);
+    void setTracking(bool tracking);
+    void setViewport(const Geodetic& center, const Geodetic& camera);
+    // Fraction of the link capacity in use, reported by the communication layer
+    void setLinkUtilization(double utilization);
+
+    // Adjusts the budget once per utilisation report and updates every vehicle,
+    // called by the service's own timer
+    void evaluate();
+    // Tiers and intervals of the vehicles for the current view and budget
+    void updateTiers(const QVariantList& vehicleIds);
+
+signals:
+    void intervalsChanged(QVariant vehicleId, QVariantMap intervals);
+    void viewChanged();
+
+private:
+    void updateBudget();
+    void updateTiers();
+    bool isVisible(const QVariant& vehicleId, bool wasVisible) const;
+
+    IVehiclesService* const m_vehicles;
+    IPropertyTree* const m_pTree;
+    QTimer m_timer;
+
+    QVariant m_selectedVehicleId;
+    bool m_tracking = false;
+    Geodetic m_viewCenter;
+    Geodetic m_viewCamera;
+    double m_viewRadius = 0;
+    double m_utilization = 0;
+    int m_reportAge = staleEvaluations; // Evaluations since the last utilisation report
+    int m_budgetFactor = 1;
+    QHash<QString, Tier> m_tiers;
+    QHash<QString, QVariantMap> m_intervals;
+};
+} // namespace md::domain
+
+#endif // TELEMETRY_RATE_SERVICE_H
@@ -0,0 +1,116 @@
+#include "elevation_service.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QtMath>
+
+#include "hgt_tile.h"
+
+namespace
+{
+constexpr int batchSize = 512;
+
+int tileKey(int latitude, int longitude)
+{
+    return (latitude + 90) * 360 + (longitude + 180);
+}
+} // namespace
+
+using namespace md::domain;
+
+ElevationService::ElevationService(const QString& tilesPath, QObject* parent) :
+    IElevationService(parent)
+{
+    QDir dir(tilesPath);
+    for (const QString& fileName : dir.entryList({ "*.hgt", "*.HGT" }, QDir::Files))
+    {
+        int latitude, longitude;
+        if (HgtTile::parseName(fileName, &latitude, &longitude))
+            m_tilePaths.insert(::tileKey(latitude, longitude), dir.filePath(fileName));
+    }
+
+    if (m_tilePaths.isEmpty())
+        qInfo() << "No elevation tiles found in" << dir.absolutePath();
+}
+
+ElevationService::~ElevationService()
+{
+}
+
+float ElevationService::height(double latitude, double longitude) const
+{
+    float result;
+    this->heights(&latitude, &longitude, &result, 1);
+    return result;
+}
+
+void ElevationService::heights(const double* latitudes, const double* longitudes, float* heights,
+                               int count) const
+{
+    int tileLatitudes[::batchSize];
+    int tileLongitudes[::batchSize];
+    double latitudeFractions[::batchSize];
+    double longitudeFractions[::batchSize];
+
+    QSharedPointer<HgtTile> tile;
+    int key = -1;
+
+    for (int begin = 0; begin < count; begin += ::batchSize)
+    {
+        const int size = qMin(::batchSize, count - begin);
+        const double* latitude = latitudes + begin;
+        const double* longitude = longitudes + begin;
+
+        // Tile coordinates, branchless and vectorizable
+        for (int i = 0; i < size; ++i)
+        {
+            const double latitudeFloor = std::floor(latitude[i]);
+            const double longitudeFloor = std::floor(longitude[i]);
+            tileLatitudes[i] = int(latitudeFloor);
+            tileLongitudes[i] = int(longitudeFloor);
+            latitudeFractions[i] = latitude[i] - latitudeFloor;
+            longitudeFractions[i] = longitude[i] - longitudeFloor;
+        }
+
+        // Gather samples, neighbour points mostly share the tile
+        for (int i = 0; i < size; ++i)
+        {
+            const int pointKey = ::tileKey(tileLatitudes[i], tileLongitudes[i]);
+            if (pointKey != key)
+            {
+                key = pointKey;
+                tile = this->tile(tileLatitudes[i], tileLongitudes[i]);
+            }
+
+            heights[begin + i] = tile ? tile->interpolate(latitudeFractions[i],
+                                                          longitudeFractions[i])
+                                      : qQNaN();
+        }
+    }
+}
+
+QSharedPointer<HgtTile> ElevationService::tile(int latitude, int longitude) const
+{
+    const int key = ::tileKey(latitude, longitude);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_tiles.constFind(key);
+    if (it != m_tiles.constEnd())
+        return it.value();
+
+    QSharedPointer<HgtTile> tile;
+    const QString path = m_tilePaths.value(key);
+    if (!path.isEmpty())
+    {
+        tile.reset(new HgtTile(path, latitude, longitude));
+        if (!tile->isValid())
+        {
+            qWarning() << "Invalid elevation tile" << path;
+            tile.clear();
+        }
+    }
+
+    // Missing tiles are cached too, to skip lookups over the sea
+    m_tiles.insert(key, tile);
+    return tile;
+}
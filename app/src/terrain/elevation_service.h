@@ -0,0 +1,36 @@
+#ifndef ELEVATION_SERVICE_H
+#define ELEVATION_SERVICE_H
+
+#include "i_elevation_service.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+
+namespace md::domain
+{
+class HgtTile;
+
+// Serves heights from a directory of SRTM HGT tiles, mapped on first use
+class ElevationService : public IElevationService
+{
+    Q_OBJECT
+
+public:
+    explicit ElevationService(const QString& tilesPath, QObject* parent = nullptr);
+    ~ElevationService() override;
+
+    float height(double latitude, double longitude) const override;
+    void heights(const double* latitudes, const double* longitudes, float* heights,
+                 int count) const override;
+
+private:
+    QSharedPointer<HgtTile> tile(int latitude, int longitude) const;
+
+    QHash<int, QString> m_tilePaths;
+    mutable QHash<int, QSharedPointer<HgtTile>> m_tiles;
+    mutable QMutex m_mutex;
+};
+} // namespace md::domain
+
+#endif // ELEVATION_SERVICE_H
@@ -0,0 +1,107 @@
+#include "hgt_tile.h"
+
+#include <QRegularExpression>
+#include <QtEndian>
+#include <QtMath>
+
+namespace
+{
+constexpr int srtm1Size = 3601;
+constexpr int srtm3Size = 1201;
+} // namespace
+
+using namespace md::domain;
+
+HgtTile::HgtTile(const QString& path, int latitude, int longitude) :
+    m_file(path),
+    m_latitude(latitude),
+    m_longitude(longitude)
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize == qint64(::srtm1Size) * ::srtm1Size * 2)
+        m_size = ::srtm1Size;
+    else if (fileSize == qint64(::srtm3Size) * ::srtm3Size * 2)
+        m_size = ::srtm3Size;
+    else
+        return;
+
+    m_data = m_file.map(0, fileSize);
+    if (!m_data)
+        m_size = 0;
+}
+
+HgtTile::~HgtTile()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar*>(m_data));
+}
+
+bool HgtTile::isValid() const
+{
+    return m_data && m_size;
+}
+
+int HgtTile::latitude() const
+{
+    return m_latitude;
+}
+
+int HgtTile::longitude() const
+{
+    return m_longitude;
+}
+
+int HgtTile::size() const
+{
+    return m_size;
+}
+
+qint16 HgtTile::sample(int row, int column) const
+{
+    return qFromBigEndian<qint16>(m_data + (qint64(row) * m_size + column) * 2);
+}
+
+float HgtTile::interpolate(double latitudeFraction, double longitudeFraction) const
+{
+    const int last = m_size - 1;
+    const double y = (1.0 - qBound(0.0, latitudeFraction, 1.0)) * last;
+    const double x = qBound(0.0, longitudeFraction, 1.0) * last;
+
+    const int row = qMin(int(y), last - 1);
+    const int column = qMin(int(x), last - 1);
+    const float dy = y - row;
+    const float dx = x - column;
+
+    const qint16 s00 = this->sample(row, column);
+    const qint16 s01 = this->sample(row, column + 1);
+    const qint16 s10 = this->sample(row + 1, column);
+    const qint16 s11 = this->sample(row + 1, column + 1);
+
+    // Voids fallback to the nearest sample
+    if (s00 == voidSample || s01 == voidSample || s10 == voidSample || s11 == voidSample)
+    {
+        const qint16 nearest = this->sample(row + qRound(dy), column + qRound(dx));
+        return nearest == voidSample ? qQNaN() : float(nearest);
+    }
+
+    const float top = s00 + (s01 - s00) * dx;
+    const float bottom = s10 + (s11 - s10) * dx;
+    return top + (bottom - top) * dy;
+}
+
+bool HgtTile::parseName(const QString& fileName, int* latitude, int* longitude)
+{
+    static const QRegularExpression pattern("^([NS])(\\d{2})([EW])(\\d{3})\\.hgt$",
+                                            QRegularExpression::CaseInsensitiveOption);
+
+    const QRegularExpressionMatch match = pattern.match(fileName);
+    if (!match.hasMatch())
+        return false;
+
+    *latitude = match.captured(2).toInt() * (match.captured(1).toUpper() == "S" ? -1 : 1);
+    *longitude = match.captured(4).toInt() * (match.captured(3).toUpper() == "W" ? -1 : 1);
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef HGT_TILE_H
+#define HGT_TILE_H
+
+#include <QFile>
+
+namespace md::domain
+{
+// Memory-mapped SRTM HGT tile: one degree square of big-endian 16-bit samples, rows from north
+class HgtTile
+{
+public:
+    static constexpr qint16 voidSample = -32768;
+
+    HgtTile(const QString& path, int latitude, int longitude);
+    ~HgtTile();
+
+    bool isValid() const;
+    int latitude() const;
+    int longitude() const;
+    int size() const;
+
+    qint16 sample(int row, int column) const;
+
+    // Bilinear interpolation, fractions are counted from south-west corner in tile units
+    float interpolate(double latitudeFraction, double longitudeFraction) const;
+
+    // Parses tile corner from names like N55E037.hgt
+    static bool parseName(const QString& fileName, int* latitude, int* longitude);
+
+private:
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    const int m_latitude;
+    const int m_longitude;
+    int m_size = 0;
+};
+} // namespace md::domain
+
+#endif // HGT_TILE_H
@@ -0,0 +1,26 @@
+#ifndef I_ELEVATION_SERVICE_H
+#define I_ELEVATION_SERVICE_H
+
+#include <QObject>
+
+namespace md::domain
+{
+class IElevationService : public QObject
+{
+    Q_OBJECT
+
+public:
+    IElevationService(QObject* parent = nullptr) : QObject(parent)
+    {
+    }
+
+    // Terrain height above mean sea level in meters, NaN where there is no data
+    virtual float height(double latitude, double longitude) const = 0;
+
+    // Batch query over structure-of-arrays coordinates, thread safe
+    virtual void heights(const double* latitudes, const double* longitudes, float* heights,
+                         int count) const = 0;
+};
+} // namespace md::domain
+
+#endif // I_ELEVATION_SERVICE_H
@@ -0,0 +1,124 @@
+#include "terrain_follow.h"
+
+#include <QtMath>
+
+#include "geodesy_kernels.h"
+
+using namespace md::domain;
+
+TerrainFollow::TerrainFollow(const IElevationService* elevation, float agl, double sampleStep,
+                             float tolerance) :
+    m_elevation(elevation),
+    m_agl(agl),
+    m_sampleStep(sampleStep),
+    m_tolerance(tolerance)
+{
+}
+
+bool TerrainFollow::apply(Geodetic& position) const
+{
+    const float ground = m_elevation->height(position.latitude(), position.longitude());
+    if (qIsNaN(ground))
+        return false;
+
+    position = Geodetic(position.latitude(), position.longitude(), ground + m_agl);
+    return true;
+}
+
+QVector<Geodetic> TerrainFollow::apply(const QVector<Geodetic>& path, QVector<int>* indices) const
+{
+    if (path.isEmpty())
+        return path;
+
+    const GeodeticArrays waypointArrays = GeodeticArrays::fromPositions(path);
+    QVector<double> legLengths(path.count());
+    geodesy::legs(waypointArrays.latitudes.constData(), waypointArrays.longitudes.constData(),
+                  legLengths.data(), nullptr, path.count());
+
+    // Sample all legs in one batch query
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    QVector<int> waypoints;
+    for (int i = 0; i < path.count(); ++i)
+    {
+        waypoints.append(latitudes.count());
+        latitudes.append(path.at(i).latitude());
+        longitudes.append(path.at(i).longitude());
+
+        if (i + 1 == path.count())
+            break;
+
+        const Geodetic& from = path.at(i);
+        const Geodetic& to = path.at(i + 1);
+        const int samples = qCeil(legLengths.at(i) / m_sampleStep);
+        for (int sample = 1; sample < samples; ++sample)
+        {
+            const double t = double(sample) / samples;
+            latitudes.append(from.latitude() + (to.latitude() - from.latitude()) * t);
+            longitudes.append(from.longitude() + (to.longitude() - from.longitude()) * t);
+        }
+    }
+
+    QVector<float> altitudes(latitudes.count());
+    m_elevation->heights(latitudes.constData(), longitudes.constData(), altitudes.data(),
+                         latitudes.count());
+
+    // Keep original altitude where there is no terrain data
+    for (int i = 0, waypoint = 0; i < altitudes.count(); ++i)
+    {
+        if (waypoint + 1 < waypoints.count() && i >= waypoints.at(waypoint + 1))
+            waypoint++;
+
+        altitudes[i] = qIsNaN(altitudes.at(i)) ? path.at(waypoint).altitude()
+                                               : altitudes.at(i) + m_agl;
+    }
+
+    QVector<Geodetic> result;
+    result.reserve(path.count());
+    for (int i = 0; i < waypoints.count(); ++i)
+    {
+        const int index = waypoints.at(i);
+        if (indices)
+            indices->append(result.count());
+        result.append(Geodetic(latitudes.at(index), longitudes.at(index), altitudes.at(index)));
+
+        if (i + 1 < waypoints.count())
+            this->simplify(latitudes, longitudes, altitudes, index, waypoints.at(i + 1), result);
+    }
+    return result;
+}
+
+float TerrainFollow::agl(const IElevationService* elevation, const Geodetic& position)
+{
+    return position.altitude() - elevation->height(position.latitude(), position.longitude());
+}
+
+void TerrainFollow::simplify(const QVector<double>& latitudes, const QVector<double>& longitudes,
+                             const QVector<float>& altitudes, int first, int last,
+                             QVector<Geodetic>& result) const
+{
+    // Douglas-Peucker over the altitude profile, appends points between first and last
+    if (last - first < 2)
+        return;
+
+    int worst = -1;
+    float worstDeviation = m_tolerance;
+    for (int i = first + 1; i < last; ++i)
+    {
+        const float t = float(i - first) / (last - first);
+        const float linear = altitudes.at(first) + (altitudes.at(last) - altitudes.at(first)) * t;
+        const float deviation = qAbs(altitudes.at(i) - linear);
+        if (deviation > worstDeviation)
+        {
+            worstDeviation = deviation;
+            worst = i;
+        }
+    }
+
+    if (worst == -1)
+        return;
+
+    this->simplify(latitudes, longitudes, altitudes, first, worst, result);
+    result.append(Geodetic(latitudes.at(worst), longitudes.at(worst), altitudes.at(worst)));
+    this->simplify(latitudes, longitudes, altitudes, worst, last, result);
+}
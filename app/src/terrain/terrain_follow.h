@@ -0,0 +1,40 @@
+#ifndef TERRAIN_FOLLOW_H
+#define TERRAIN_FOLLOW_H
+
+#include "geodetic.h"
+#include "i_elevation_service.h"
+
+namespace md::domain
+{
+// Keeps constant height above ground along the path legs
+class TerrainFollow
+{
+public:
+    static constexpr char enabledSetting[] = "missions/terrainFollow";
+
+    TerrainFollow(const IElevationService* elevation, float agl, double sampleStep = 30.0,
+                  float tolerance = 5.0);
+
+    // Moves positions to the given AGL, returns false if there is no terrain data
+    bool apply(Geodetic& position) const;
+
+    // Samples every leg and inserts the points needed to stay within tolerance from AGL,
+    // indices get where every path position is in the result
+    QVector<Geodetic> apply(const QVector<Geodetic>& path, QVector<int>* indices = nullptr) const;
+
+    // Height above ground of the position, NaN if there is no terrain data
+    static float agl(const IElevationService* elevation, const Geodetic& position);
+
+private:
+    void simplify(const QVector<double>& latitudes, const QVector<double>& longitudes,
+                  const QVector<float>& altitudes, int first, int last,
+                  QVector<Geodetic>& result) const;
+
+    const IElevationService* const m_elevation;
+    const float m_agl;
+    const double m_sampleStep;
+    const float m_tolerance;
+};
+} // namespace md::domain
+
+#endif // TERRAIN_FOLLOW_H
@@ -0,0 +1,191 @@
+#include "timer_wheel.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+namespace
+{
+md::domain::TimerWheel::Clock elapsedClock()
+{
+    QSharedPointer<QElapsedTimer> elapsed(new QElapsedTimer);
+    elapsed->start();
+    return [elapsed]() {
+        return elapsed->elapsed();
+    };
+}
+} // namespace
+
+using namespace md::domain;
+
+TimerWheel::TimerWheel(QObject* parent) : TimerWheel(::elapsedClock(), parent)
+{
+}
+
+TimerWheel::TimerWheel(Clock clock, QObject* parent) : QObject(parent), m_clock(std::move(clock))
+{
+    m_timer.setInterval(tickInterval);
+    connect(&m_timer, &QTimer::timeout, this, &TimerWheel::process);
+}
+
+TimerWheel::~TimerWheel()
+{
+    qDeleteAll(m_entries);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int msec, const Callback& callback)
+{
+    // The wheel is idle while empty, so it may jump to the current time without cascading
+    if (m_entries.isEmpty())
+    {
+        m_tick = this->currentTick();
+        m_timer.start();
+    }
+
+    Entry* entry = new Entry{ ++m_lastId, this->expiryTick(msec), callback };
+    m_entries.insert(entry->id, entry);
+    this->insert(entry);
+    return entry->id;
+}
+
+bool TimerWheel::restart(TimerId timerId, int msec)
+{
+    Entry* entry = m_entries.value(timerId);
+    if (!entry)
+        return false;
+
+    this->unlink(entry);
+    entry->expiry = this->expiryTick(msec);
+    this->insert(entry);
+    return true;
+}
+
+bool TimerWheel::cancel(TimerId timerId)
+{
+    Entry* entry = m_entries.take(timerId);
+    if (!entry)
+        return false;
+
+    this->unlink(entry);
+    delete entry;
+
+    if (m_entries.isEmpty())
+        m_timer.stop();
+    return true;
+}
+
+bool TimerWheel::isActive(TimerId timerId) const
+{
+    return m_entries.contains(timerId);
+}
+
+int TimerWheel::count() const
+{
+    return m_entries.count();
+}
+
+quint64 TimerWheel::currentTick() const
+{
+    return quint64(m_clock()) / tickInterval;
+}
+
+quint64 TimerWheel::expiryTick(int msec) const
+{
+    // Never fire early, even if the wheel lags behind the clock
+    const quint64 due = quint64(m_clock()) + quint64(qMax(msec, 0));
+    const quint64 expiry = (due + tickInterval - 1) / tickInterval;
+    return qMax(expiry, m_tick + 1);
+}
+
+void TimerWheel::insert(Entry* entry)
+{
+    const quint64 delta = entry->expiry - m_tick;
+
+    int level = 0;
+    while (level < levelCount - 1 && delta >= (quint64(1) << (slotBits * (level + 1))))
+    {
+        level++;
+    }
+
+    // Timeouts beyond the top level wait in its furthest slot and cascade down from there
+    const quint64 maxDelta = (quint64(1) << (slotBits * levelCount)) - 1;
+    const quint64 expiry = m_tick + qMin(delta, maxDelta);
+    const int index = int((expiry >> (slotBits * level)) & (slotCount - 1));
+
+    Entry** slot = &m_slots[level][index];
+    entry->slot = slot;
+    entry->prev = nullptr;
+    entry->next = *slot;
+    if (*slot)
+        (*slot)->prev = entry;
+    *slot = entry;
+}
+
+void TimerWheel::unlink(Entry* entry)
+{
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else if (entry->slot)
+        *entry->slot = entry->next;
+
+    if (entry->next)
+        entry->next->prev = entry->prev;
+
+    entry->prev = nullptr;
+    entry->next = nullptr;
+    entry->slot = nullptr;
+}
+
+void TimerWheel::cascade(int level)
+{
+    const int index = int((m_tick >> (slotBits * level)) & (slotCount - 1));
+
+    Entry* entry = m_slots[level][index];
+    m_slots[level][index] = nullptr;
+    while (entry)
+    {
+        Entry* next = entry->next;
+        entry->slot = nullptr;
+        this->insert(entry);
+        entry = next;
+    }
+}
+
+void TimerWheel::advance()
+{
+    m_tick++;
+
+    // Entering a new lap of a level pulls the matching slot of the level above down
+    for (int level = 1; level < levelCount; ++level)
+    {
+        if (m_tick & ((quint64(1) << (slotBits * level)) - 1))
+            break;
+
+        this->cascade(level);
+    }
+
+    // Fired one by one, so callbacks may cancel other timers of the same tick
+    Entry** slot = &m_slots[0][m_tick & (slotCount - 1)];
+    while (*slot)
+    {
+        Entry* entry = *slot;
+        this->unlink(entry);
+        m_entries.remove(entry->id);
+
+        entry->callback();
+        delete entry;
+    }
+}
+
+void TimerWheel::process()
+{
+    // Catch up with ticks missed while the event loop was busy
+    const quint64 target = this->currentTick();
+    while (m_tick < target && !m_entries.isEmpty())
+    {
+        this->advance();
+    }
+
+    if (m_entries.isEmpty())
+        m_timer.stop();
+}
@@ -0,0 +1,71 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <QHash>
+#include <QTimer>
+
+#include <functional>
+
+namespace md::domain
+{
+// Hierarchical timing wheel for many one-shot timeouts with O(1) schedule and cancel,
+// driven by a single timer of the event loop it lives in. Vehicle online timeouts are kept by
+// kjarni's vehicle layer, not in this tree, it can take the wheel from the Locator.
+class TimerWheel : public QObject
+{
+    Q_OBJECT
+
+public:
+    using TimerId = quint64;
+    using Callback = std::function<void()>;
+    using Clock = std::function<qint64()>; // Monotonic milliseconds
+
+    static constexpr int tickInterval = 20;
+    static constexpr int slotBits = 6;
+    static constexpr int slotCount = 1 << slotBits;
+    static constexpr int levelCount = 4; // Up to 64^4 ticks, about four days
+
+    explicit TimerWheel(QObject* parent = nullptr);
+    explicit TimerWheel(Clock clock, QObject* parent = nullptr);
+    ~TimerWheel() override;
+
+    // Callbacks run on the wheel's thread, they may schedule and cancel timers
+    TimerId schedule(int msec, const Callback& callback);
+    // Reschedules with the same callback, returns false if the timer has fired or was canceled
+    bool restart(TimerId timerId, int msec);
+    bool cancel(TimerId timerId);
+
+    bool isActive(TimerId timerId) const;
+    int count() const;
+
+    // Fires timers due by the clock, called by the wheel's own timer
+    void process();
+
+private:
+    struct Entry
+    {
+        TimerId id;
+        quint64 expiry; // In ticks
+        Callback callback;
+        Entry* prev = nullptr;
+        Entry* next = nullptr;
+        Entry** slot = nullptr;
+    };
+
+    quint64 currentTick() const;
+    quint64 expiryTick(int msec) const;
+    void insert(Entry* entry);
+    void unlink(Entry* entry);
+    void cascade(int level);
+    void advance();
+
+    Entry* m_slots[levelCount][slotCount] = {};
+    QHash<TimerId, Entry*> m_entries;
+    TimerId m_lastId = 0;
+    quint64 m_tick = 0;
+    const Clock m_clock;
+    QTimer m_timer;
+};
+} // namespace md::domain
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,188 @@
+#include "conflict_detector.h"
+
+#include <QPair>
+#include <QtMath>
+
+#include <algorithm>
+
+#include "geodesy_kernels.h"
+
+namespace
+{
+constexpr char code[] = "code";
+constexpr char callsign[] = "callsign";
+constexpr char range[] = "range";
+constexpr char timeToCpa[] = "timeToCpa";
+constexpr char horizontalDistance[] = "horizontalDistance";
+constexpr char verticalDistance[] = "verticalDistance";
+
+constexpr double metersPerDegree = md::domain::geodesy::meanRadius * M_PI / 180.0;
+constexpr double searchMargin = 1.2; // Covers distortion of the flat cell grid
+constexpr double minCosLatitude = 0.01; // Keeps the grid finite near the poles
+constexpr int cellsPerReach = 8;     // Finer cells follow the search circle closer
+
+// Order preserving for signed cells, so a column of cells is a contiguous key range
+quint64 cellKey(qint64 x, qint64 y)
+{
+    return (quint64(quint32(x) ^ 0x80000000u) << 32) | (quint32(y) ^ 0x80000000u);
+}
+} // namespace
+
+using namespace md::domain;
+
+QVariantMap Conflict::toVariantMap() const
+{
+    return { { ::code, code },
+             { ::callsign, callsign },
+             { ::range, range },
+             { ::timeToCpa, timeToCpa },
+             { ::horizontalDistance, horizontalDistance },
+             { ::verticalDistance, verticalDistance } };
+}
+
+ConflictDetector::ConflictDetector(const ConflictParameters& parameters, QObject* parent) :
+    QObject(parent),
+    m_parameters(parameters)
+{
+}
+
+QVector<QVector<Conflict>> ConflictDetector::detect(const QVector<OwnState>& own,
+                                                    const QVector<TrafficState>& traffic,
+                                                    const ConflictParameters& parameters)
+{
+    QVector<QVector<Conflict>> result(own.count());
+    if (own.isEmpty() || traffic.isEmpty())
+        return result;
+
+    // Flat grid scaled at the mean own latitude, vehicles away from it stretch their search
+    double latitude0 = 0;
+    for (const OwnState& vehicle : own)
+    {
+        latitude0 += vehicle.latitude;
+    }
+    const double cos0 = qMax(qCos(qDegreesToRadians(latitude0 / own.count())), ::minCosLatitude);
+    const double xScale = ::metersPerDegree * cos0;
+    const double cellSize = qMax(parameters.horizon * parameters.maxTrafficSpeed / ::cellsPerReach,
+                                 parameters.horizontalSeparation);
+
+    QVector<QPair<quint64, int>> cells(traffic.count());
+    for (int i = 0; i < traffic.count(); ++i)
+    {
+        const qint64 x = qFloor(traffic.at(i).longitude * xScale / cellSize);
+        const qint64 y = qFloor(traffic.at(i).latitude * ::metersPerDegree / cellSize);
+        cells[i] = { ::cellKey(x, y), i };
+    }
+    std::sort(cells.begin(), cells.end());
+
+    QVector<int> candidates;
+    QVector<double> latitudes, longitudes, altitudes, east, north, up;
+    for (int o = 0; o < own.count(); ++o)
+    {
+        const OwnState& vehicle = own.at(o);
+        const double radius = (parameters.horizon * (vehicle.groundSpeed +
+                                                     parameters.maxTrafficSpeed) +
+                               parameters.horizontalSeparation) *
+                              ::searchMargin;
+        // Grid east-west distances are the real ones times that at the vehicle latitude
+        const double stretch =
+            cos0 / qMax(qCos(qDegreesToRadians(vehicle.latitude)), ::minCosLatitude);
+        const int reach = qCeil(radius * stretch / cellSize);
+        const qint64 x0 = qFloor(vehicle.longitude * xScale / cellSize);
+        const qint64 y0 = qFloor(vehicle.latitude * ::metersPerDegree / cellSize);
+
+        // Every column is cut to the rows its part of the search circle can reach
+        candidates.clear();
+        for (qint64 x = x0 - reach; x <= x0 + reach; ++x)
+        {
+            const double dx = qMax(qAbs(x - x0) - 1, qint64(0)) * cellSize / stretch;
+            if (dx > radius)
+                continue;
+
+            const qint64 rows = qCeil(qSqrt(radius * radius - dx * dx) / cellSize);
+            const quint64 lastKey = ::cellKey(x, y0 + rows);
+            auto it = std::lower_bound(cells.cbegin(), cells.cend(),
+                                       qMakePair(::cellKey(x, y0 - rows), 0));
+            for (; it != cells.cend() && it->first <= lastKey; ++it)
+            {
+                candidates.append(it->second);
+            }
+        }
+        if (candidates.isEmpty())
+            continue;
+
+        // Candidates to the vehicle local frame in one batch
+        const int count = candidates.count();
+        latitudes.resize(count);
+        longitudes.resize(count);
+        altitudes.resize(count);
+        east.resize(count);
+        north.resize(count);
+        up.resize(count);
+        for (int i = 0; i < count; ++i)
+        {
+            const TrafficState& target = traffic.at(candidates.at(i));
+            latitudes[i] = target.latitude;
+            longitudes[i] = target.longitude;
+            altitudes[i] = target.altitude;
+        }
+        geodesy::toEnu(Geodetic(vehicle.latitude, vehicle.longitude, vehicle.altitude),
+                       latitudes.constData(), longitudes.constData(), altitudes.constData(),
+                       east.data(), north.data(), up.data(), count);
+
+        const double course = qDegreesToRadians(vehicle.course);
+        const double ownEast = vehicle.groundSpeed * qSin(course);
+        const double ownNorth = vehicle.groundSpeed * qCos(course);
+
+        QVector<Conflict>& conflicts = result[o];
+        for (int i = 0; i < count; ++i)
+        {
+            const TrafficState& target = traffic.at(candidates.at(i));
+            const double heading = qDegreesToRadians(target.heading);
+            const double vEast = target.groundSpeed * qSin(heading) - ownEast;
+            const double vNorth = target.groundSpeed * qCos(heading) - ownNorth;
+            const double vUp = target.verticalSpeed - vehicle.verticalSpeed;
+
+            const double closing = vEast * vEast + vNorth * vNorth;
+            const double t = closing > 0 ? -(east.at(i) * vEast + north.at(i) * vNorth) / closing
+                                         : 0;
+            const double tcpa = qBound(0.0, t, parameters.horizon);
+
+            const double dEast = east.at(i) + vEast * tcpa;
+            const double dNorth = north.at(i) + vNorth * tcpa;
+            const double horizontal = qSqrt(dEast * dEast + dNorth * dNorth);
+            const double vertical = qAbs(up.at(i) + vUp * tcpa);
+            if (horizontal >= parameters.horizontalSeparation ||
+                vertical >= parameters.verticalSeparation)
+                continue;
+
+            const double range = qSqrt(east.at(i) * east.at(i) + north.at(i) * north.at(i) +
+                                       up.at(i) * up.at(i));
+            conflicts.append({ target.code, target.callsign, range, tcpa, horizontal, vertical });
+        }
+
+        std::sort(conflicts.begin(), conflicts.end(), [](const Conflict& a, const Conflict& b) {
+            return a.timeToCpa < b.timeToCpa;
+        });
+    }
+
+    return result;
+}
+
+void ConflictDetector::process(const QVector<OwnState>& own, const QVector<TrafficState>& traffic)
+{
+    const QVector<QVector<Conflict>> conflicts = ConflictDetector::detect(own, traffic,
+                                                                          m_parameters);
+
+    QVariantMap result;
+    for (int i = 0; i < own.count(); ++i)
+    {
+        QVariantList list;
+        for (const Conflict& conflict : conflicts.at(i))
+        {
+            list.append(conflict.toVariantMap());
+        }
+        result.insert(own.at(i).id, list);
+    }
+
+    emit conflictsDetected(result);
+}
@@ -0,0 +1,65 @@
+#ifndef CONFLICT_DETECTOR_H
+#define CONFLICT_DETECTOR_H
+
+#include "traffic_service.h"
+
+#include <QVariant>
+
+namespace md::domain
+{
+struct OwnState
+{
+    QString id;
+    double latitude = 0;
+    double longitude = 0;
+    double altitude = 0;
+    double groundSpeed = 0;
+    double course = 0;
+    double verticalSpeed = 0;
+};
+
+struct Conflict
+{
+    QVariantMap toVariantMap() const;
+
+    QString code;
+    QString callsign;
+    double range;              // Current distance, m
+    double timeToCpa;          // s
+    double horizontalDistance; // At closest point of approach, m
+    double verticalDistance;   // At closest point of approach, m
+};
+
+struct ConflictParameters
+{
+    double horizon = 120;
+    double horizontalSeparation = 1000;
+    double verticalSeparation = 150;
+    double maxTrafficSpeed = 300; // Bounds the search radius around own vehicles
+};
+
+// Closest point of approach for own vehicle and traffic pairs, runs on a worker thread
+class ConflictDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConflictDetector(const ConflictParameters& parameters, QObject* parent = nullptr);
+
+    // Conflicts of every own vehicle sorted by time to CPA, traffic is bucketed in a spatial hash
+    static QVector<QVector<Conflict>> detect(const QVector<OwnState>& own,
+                                             const QVector<TrafficState>& traffic,
+                                             const ConflictParameters& parameters);
+
+    void process(const QVector<OwnState>& own, const QVector<TrafficState>& traffic);
+
+signals:
+    // Own vehicle ids to conflict lists
+    void conflictsDetected(const QVariantMap& conflicts);
+
+private:
+    const ConflictParameters m_parameters;
+};
+} // namespace md::domain
+
+#endif // CONFLICT_DETECTOR_H
@@ -0,0 +1,124 @@
+#include "traffic_conflict_service.h"
+
+#include <QDebug>
+
+namespace
+{
+constexpr char latitude[] = "latitude";
+constexpr char longitude[] = "longitude";
+constexpr char altitudeAmsl[] = "altitudeAmsl";
+constexpr char groundSpeed[] = "gs";
+constexpr char course[] = "course";
+constexpr char climb[] = "climb";
+
+constexpr char trafficConflicts[] = "trafficConflicts";
+constexpr char trafficAlert[] = "trafficAlert";
+} // namespace
+
+using namespace md::domain;
+
+TrafficConflictService::TrafficConflictService(IPropertyTree* pTree, IVehiclesService* vehicles,
+                                               TrafficService* traffic, QObject* parent) :
+    QObject(parent),
+    m_pTree(pTree),
+    m_vehicles(vehicles),
+    m_traffic(traffic),
+    m_detector(new ConflictDetector(ConflictParameters()))
+{
+    m_detector->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_detector, &QObject::deleteLater);
+    connect(m_detector, &ConflictDetector::conflictsDetected, this,
+            &TrafficConflictService::onConflictsDetected);
+    m_thread.setObjectName("TrafficConflicts");
+    m_thread.start();
+
+    connect(m_pTree, &IPropertyTree::propertiesChanged, this,
+            &TrafficConflictService::onPropertiesChanged);
+    connect(m_vehicles, &IVehiclesService::vehicleRemoved, this,
+            &TrafficConflictService::onVehicleRemoved);
+    connect(m_traffic, &TrafficService::trafficUpdated, this, [this]() {
+        m_dirty = true;
+    });
+    connect(m_traffic, &TrafficService::trafficRemoved, this, [this]() {
+        m_dirty = true;
+    });
+
+    m_timer.setInterval(interval);
+    connect(&m_timer, &QTimer::timeout, this, &TrafficConflictService::detect);
+    m_timer.start();
+}
+
+TrafficConflictService::~TrafficConflictService()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void TrafficConflictService::onPropertiesChanged(const QString& nodeId,
+                                                 const QVariantMap& properties)
+{
+    if (!properties.contains(::latitude) && !properties.contains(::longitude))
+        return;
+
+    const QVariantMap telemetry = m_pTree->properties(nodeId);
+    if (!telemetry.contains(::latitude) || !telemetry.contains(::longitude))
+        return;
+
+    OwnState& state = m_own[nodeId];
+    state.id = nodeId;
+    state.latitude = telemetry.value(::latitude).toDouble();
+    state.longitude = telemetry.value(::longitude).toDouble();
+    state.altitude = telemetry.value(::altitudeAmsl).toDouble();
+    state.groundSpeed = telemetry.value(::groundSpeed).toDouble();
+    state.course = telemetry.value(::course).toDouble();
+    state.verticalSpeed = telemetry.value(::climb).toDouble();
+    m_dirty = true;
+}
+
+void TrafficConflictService::onVehicleRemoved(Vehicle* vehicle)
+{
+    const QString vehicleId = vehicle->id().toString();
+    m_own.remove(vehicleId);
+    if (m_alerted.remove(vehicleId))
+        emit conflictsChanged(vehicleId, QVariantList());
+}
+
+void TrafficConflictService::onConflictsDetected(const QVariantMap& conflicts)
+{
+    m_busy = false;
+
+    for (auto it = conflicts.constBegin(); it != conflicts.constEnd(); ++it)
+    {
+        // Vehicle removed while the pass was running
+        if (!m_own.contains(it.key()))
+            continue;
+
+        const QVariantList list = it.value().toList();
+
+        // Clear alert once, keep quiet while there is nothing to report
+        if (list.isEmpty() && !m_alerted.remove(it.key()))
+            continue;
+
+        if (!list.isEmpty())
+            m_alerted.insert(it.key());
+
+        m_pTree->appendProperties(it.key(), { { ::trafficConflicts, list },
+                                              { ::trafficAlert, !list.isEmpty() } });
+        emit conflictsChanged(it.key(), list);
+    }
+}
+
+void TrafficConflictService::detect()
+{
+    // Skip while the previous pass is running, the next tick takes the latest states
+    if (m_busy || !m_dirty || m_own.isEmpty())
+        return;
+
+    m_busy = true;
+    m_dirty = false;
+
+    QMetaObject::invokeMethod(m_detector, [detector = m_detector, own = m_own.values().toVector(),
+                                           traffic = m_traffic->traffic()]() {
+        detector->process(own, traffic);
+    });
+}
@@ -0,0 +1,48 @@
+#ifndef TRAFFIC_CONFLICT_SERVICE_H
+#define TRAFFIC_CONFLICT_SERVICE_H
+
+#include "conflict_detector.h"
+#include "i_property_tree.h"
+#include "i_vehicles_service.h"
+
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+
+namespace md::domain
+{
+// Detects conflicts between own vehicles and ADS-B traffic, alerts go to vehicle nodes
+class TrafficConflictService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int interval = 500;
+
+    TrafficConflictService(IPropertyTree* pTree, IVehiclesService* vehicles,
+                           TrafficService* traffic, QObject* parent = nullptr);
+    ~TrafficConflictService() override;
+
+signals:
+    void conflictsChanged(const QString& vehicleId, const QVariantList& conflicts);
+
+private:
+    void onPropertiesChanged(const QString& nodeId, const QVariantMap& properties);
+    void onVehicleRemoved(Vehicle* vehicle);
+    void onConflictsDetected(const QVariantMap& conflicts);
+    void detect();
+
+    IPropertyTree* const m_pTree;
+    IVehiclesService* const m_vehicles;
+    TrafficService* const m_traffic;
+    QThread m_thread;
+    ConflictDetector* const m_detector;
+    QTimer m_timer;
+    QHash<QString, OwnState> m_own;
+    QSet<QString> m_alerted;
+    bool m_dirty = false;
+    bool m_busy = false;
+};
+} // namespace md::domain
+
+#endif // TRAFFIC_CONFLICT_SERVICE_H
@@ -0,0 +1,140 @@
+#include "traffic_service.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QVariantMap>
+
+#include "geodesy_kernels.h"
+
+namespace
+{
+constexpr char code[] = "code";
+constexpr char callsign[] = "callsign";
+constexpr char position[] = "position";
+constexpr char latitude[] = "latitude";
+constexpr char longitude[] = "longitude";
+constexpr char altitude[] = "altitude";
+constexpr char heading[] = "heading";
+constexpr char groundSpeed[] = "groundSpeed";
+constexpr char verticalSpeed[] = "verticalSpeed";
+constexpr char timestamp[] = "timestamp";
+} // namespace
+
+using namespace md::domain;
+
+TrafficState TrafficState::fromVariantMap(const QVariantMap& map)
+{
+    const QVariantMap position = map.value(::position).toMap();
+
+    TrafficState state;
+    state.code = map.value(::code).toString();
+    state.callsign = map.value(::callsign).toString();
+    state.latitude = position.value(::latitude).toDouble();
+    state.longitude = position.value(::longitude).toDouble();
+    state.altitude = position.value(::altitude).toDouble();
+    state.heading = map.value(::heading).toDouble();
+    return state;
+}
+
+TrafficService::TrafficService(TimerWheel* timers, QObject* parent) :
+    QObject(parent),
+    m_timers(timers)
+{
+    qRegisterMetaType<QVector<TrafficState>>("QVector<TrafficState>");
+}
+
+TrafficService::~TrafficService()
+{
+    for (TimerWheel::TimerId timerId : qAsConst(m_staleTimers))
+    {
+        m_timers->cancel(timerId);
+    }
+}
+
+QVector<TrafficState> TrafficService::traffic() const
+{
+    return m_traffic.values().toVector();
+}
+
+void TrafficService::updateTraffic(const QVariantList& states)
+{
+    const qint64 received = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<TrafficState> updated;
+    updated.reserve(states.count());
+    for (const QVariant& value : states)
+    {
+        const QVariantMap map = value.toMap();
+        TrafficState state = TrafficState::fromVariantMap(map);
+        if (state.code.isEmpty())
+            continue;
+
+        // Feeds resend unchanged positions, speeds are measured between position fixes
+        state.timestamp = map.value(::timestamp, received).toLongLong();
+
+        auto previous = m_traffic.constFind(state.code);
+        if (previous != m_traffic.constEnd())
+        {
+            const bool moved = state.latitude != previous->latitude ||
+                               state.longitude != previous->longitude ||
+                               state.altitude != previous->altitude;
+            const double seconds = (state.timestamp - previous->timestamp) / 1000.0;
+            if (moved && seconds > 0)
+            {
+                double distance = 0;
+                geodesy::haversine(&previous->latitude, &previous->longitude, &state.latitude,
+                                   &state.longitude, &distance, 1);
+                state.groundSpeed = distance / seconds;
+                state.verticalSpeed = (state.altitude - previous->altitude) / seconds;
+            }
+            else if (!moved && state.timestamp - previous->timestamp > stillTimeout)
+            {
+                state.groundSpeed = 0;
+                state.verticalSpeed = 0;
+            }
+            else
+            {
+                state.groundSpeed = previous->groundSpeed;
+                state.verticalSpeed = previous->verticalSpeed;
+                if (!moved)
+                    state.timestamp = previous->timestamp;
+            }
+        }
+        state.groundSpeed = map.value(::groundSpeed, state.groundSpeed).toDouble();
+        state.verticalSpeed = map.value(::verticalSpeed, state.verticalSpeed).toDouble();
+
+        m_traffic.insert(state.code, state);
+        updated.append(state);
+
+        // Every target has its own stale timeout, cheap to restart on the wheel
+        const TimerWheel::TimerId timerId = m_staleTimers.value(state.code);
+        if (!m_timers->restart(timerId, staleTimeout))
+        {
+            const QString code = state.code;
+            m_staleTimers.insert(code, m_timers->schedule(staleTimeout, [this, code]() {
+                this->onStale(code);
+            }));
+        }
+    }
+
+    if (!updated.isEmpty())
+        emit trafficUpdated(updated);
+}
+
+void TrafficService::onStale(const QString& code)
+{
+    m_staleTimers.remove(code);
+    m_traffic.remove(code);
+
+    // Targets expiring together are reported at once
+    m_stale.append(code);
+    if (m_stale.count() == 1)
+        QMetaObject::invokeMethod(this, &TrafficService::flushStale, Qt::QueuedConnection);
+}
+
+void TrafficService::flushStale()
+{
+    const QStringList removed = m_stale;
+    m_stale.clear();
+    emit trafficRemoved(removed);
+}
@@ -0,0 +1,63 @@
+#ifndef TRAFFIC_SERVICE_H
+#define TRAFFIC_SERVICE_H
+
+#include "timer_wheel.h"
+
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+namespace md::domain
+{
+struct TrafficState
+{
+    static TrafficState fromVariantMap(const QVariantMap& map);
+
+    QString code;
+    QString callsign;
+    double latitude = 0;
+    double longitude = 0;
+    double altitude = 0;
+    double heading = 0;
+    double groundSpeed = 0;   // m/s, estimated from the previous state if not reported
+    double verticalSpeed = 0; // m/s, same as above
+    qint64 timestamp = 0; // Of the last position fix, ms since epoch
+};
+
+// Latest states of ADS-B traffic. The ADS-B module takes the service from the Locator and calls
+// updateTraffic with its feed, so the checks run in the headless core too.
+class TrafficService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int staleTimeout = 60000;
+    static constexpr int stillTimeout = 10000; // Unchanged position for that long is standing
+
+    explicit TrafficService(TimerWheel* timers, QObject* parent = nullptr);
+    ~TrafficService() override;
+
+    QVector<TrafficState> traffic() const;
+
+public slots:
+    // States in the ADS-B feed format: code, callsign, position, heading, optional timestamp
+    void updateTraffic(const QVariantList& states);
+
+signals:
+    void trafficUpdated(const QVector<TrafficState>& states);
+    void trafficRemoved(const QStringList& codes);
+
+private:
+    void onStale(const QString& code);
+    void flushStale();
+
+    TimerWheel* const m_timers;
+    QHash<QString, TrafficState> m_traffic;
+    QHash<QString, TimerWheel::TimerId> m_staleTimers;
+    QStringList m_stale;
+};
+} // namespace md::domain
+
+Q_DECLARE_METATYPE(md::domain::TrafficState)
+
+#endif // TRAFFIC_SERVICE_H
@@ -0,0 +1,352 @@
+#include "ftp_client.h"
+
+#include <QtEndian>
+
+using namespace md::domain;
+
+FtpClient::Transfer::Transfer(int id, const QString& remotePath, const QString& localPath) :
+    id(id),
+    remotePath(remotePath),
+    sink(localPath)
+{
+}
+
+FtpClient::FtpClient(QObject* parent) : QObject(parent)
+{
+}
+
+FtpClient::~FtpClient()
+{
+    qDeleteAll(m_transfers);
+}
+
+void FtpClient::download(int transferId, const QString& remotePath, const QString& localPath)
+{
+    if (m_transfers.contains(transferId))
+        return;
+
+    Transfer* transfer = new Transfer(transferId, remotePath, localPath);
+    transfer->timer = new QTimer(this);
+    transfer->timer->setSingleShot(true);
+    transfer->timer->setInterval(timeout);
+    connect(transfer->timer, &QTimer::timeout, this, [this, transfer]() {
+        this->onTimeout(transfer);
+    });
+
+    m_transfers.insert(transfer->id, transfer);
+    m_queue.enqueue(transfer);
+    this->dispatch();
+}
+
+void FtpClient::cancel(int transferId)
+{
+    Transfer* transfer = m_transfers.value(transferId);
+    if (!transfer)
+        return;
+
+    this->finish(transfer, false, tr("Canceled"));
+}
+
+bool FtpClient::isActive(int transferId) const
+{
+    return m_transfers.contains(transferId);
+}
+
+qint64 FtpClient::received(int transferId) const
+{
+    Transfer* transfer = m_transfers.value(transferId);
+    return transfer ? transfer->sink.received().covered() : 0;
+}
+
+qint64 FtpClient::total(int transferId) const
+{
+    Transfer* transfer = m_transfers.value(transferId);
+    return transfer ? transfer->sink.size() : 0;
+}
+
+void FtpClient::receivePayload(const QByteArray& raw)
+{
+    const FtpPayload payload = FtpPayload::decode(raw);
+    if (payload.opcode != FtpPayload::Ack && payload.opcode != FtpPayload::Nak)
+        return;
+
+    // Replies carry the request seq plus one, the session is unknown until the file is open
+    if (payload.requestOpcode == FtpPayload::OpenFileRO)
+    {
+        Transfer* transfer = m_opening.take(quint16(payload.seq - 1));
+        if (transfer && transfer->state == Opening)
+            this->onOpened(transfer, payload);
+        return;
+    }
+
+    Transfer* transfer = m_sessions.value(payload.session);
+    if (!transfer)
+        return;
+
+    switch (payload.requestOpcode)
+    {
+    case FtpPayload::TerminateSession:
+        if (transfer->state == Closing)
+            this->finish(transfer, true);
+        break;
+    case FtpPayload::BurstReadFile:
+    case FtpPayload::ReadFile:
+        if (payload.opcode == FtpPayload::Ack)
+        {
+            this->onData(transfer, payload);
+        }
+        else if (payload.error() == FtpPayload::EndOfFile && transfer->state == Bursting)
+        {
+            this->repair(transfer);
+        }
+        else if (transfer->state == Bursting || payload.seq == quint16(transfer->request.seq + 1))
+        {
+            this->finish(transfer, false, errorText(payload.error()));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void FtpClient::resetSessions()
+{
+    FtpPayload payload;
+    payload.seq = ++m_seq;
+    payload.opcode = FtpPayload::ResetSessions;
+    emit sendPayload(payload.encode());
+
+    // Sessions are dropped on the remote side, so there is nothing to terminate
+    m_sessions.clear();
+
+    QList<Transfer*> running;
+    for (Transfer* transfer : qAsConst(m_transfers))
+    {
+        if (transfer->state != Queued)
+            running.append(transfer);
+    }
+
+    for (Transfer* transfer : qAsConst(running))
+    {
+        this->finish(transfer, false, tr("Sessions reset"));
+    }
+}
+
+void FtpClient::start(Transfer* transfer)
+{
+    m_running++;
+    transfer->state = Opening;
+
+    const QByteArray path = transfer->remotePath.toUtf8();
+    this->send(transfer, FtpPayload::OpenFileRO, 0, quint8(path.size()), path);
+    m_opening.insert(transfer->request.seq, transfer);
+}
+
+void FtpClient::send(Transfer* transfer, FtpPayload::Opcode opcode, quint32 offset, quint8 size,
+                     const QByteArray& data)
+{
+    FtpPayload& request = transfer->request;
+    request.seq = ++m_seq;
+    request.session = transfer->session;
+    request.opcode = opcode;
+    request.size = size;
+    request.offset = offset;
+    request.data = data;
+
+    emit sendPayload(request.encode());
+    transfer->timer->start();
+}
+
+void FtpClient::resend(Transfer* transfer)
+{
+    const FtpPayload request = transfer->request;
+    if (transfer->state == Opening)
+        m_opening.remove(request.seq);
+
+    this->send(transfer, FtpPayload::Opcode(request.opcode), request.offset, request.size,
+               request.data);
+
+    if (transfer->state == Opening)
+        m_opening.insert(transfer->request.seq, transfer);
+}
+
+void FtpClient::onTimeout(Transfer* transfer)
+{
+    if (transfer->state == Closing)
+    {
+        // File is complete, a lost terminate reply only leaves the session to expire remotely
+        this->finish(transfer, true);
+        return;
+    }
+
+    if (++transfer->retries > maxRetries)
+    {
+        this->finish(transfer, false, tr("Timeout"));
+        return;
+    }
+
+    // Burst stalled or its tail got lost, continue from the first missing chunk
+    if (transfer->state == Bursting)
+        this->repair(transfer);
+    else
+        this->resend(transfer);
+}
+
+void FtpClient::onOpened(Transfer* transfer, const FtpPayload& payload)
+{
+    if (payload.opcode == FtpPayload::Nak)
+    {
+        this->finish(transfer, false, errorText(payload.error()));
+        return;
+    }
+
+    transfer->session = payload.session;
+    m_sessions.insert(transfer->session, transfer);
+
+    const qint64 size = payload.data.size() >= 4 ? qFromLittleEndian<quint32>(
+                                                       payload.data.constData())
+                                                 : 0;
+    if (!transfer->sink.open(size))
+    {
+        this->finish(transfer, false, tr("Can't open %1").arg(transfer->sink.path()));
+        return;
+    }
+
+    transfer->retries = 0;
+    emit progressChanged(transfer->id, transfer->sink.received().covered(), size);
+    this->requestNext(transfer, 0);
+}
+
+void FtpClient::onData(Transfer* transfer, const FtpPayload& payload)
+{
+    const qint64 added = transfer->sink.write(payload.offset, payload.data.constData(),
+                                              payload.data.size());
+    if (added)
+    {
+        transfer->retries = 0;
+        emit progressChanged(transfer->id, transfer->sink.received().covered(),
+                             transfer->sink.size());
+    }
+
+    if (transfer->state == Bursting)
+    {
+        transfer->timer->start();
+        if (payload.burstComplete)
+            this->requestNext(transfer, payload.offset + payload.data.size());
+    }
+    // Late replies to earlier repair requests only fill the file
+    else if (transfer->state == Repairing && payload.seq == quint16(transfer->request.seq + 1))
+    {
+        this->repair(transfer);
+    }
+}
+
+void FtpClient::requestNext(Transfer* transfer, quint32 after)
+{
+    const MappedFileSink& sink = transfer->sink;
+    if (sink.isComplete())
+    {
+        this->terminate(transfer);
+        return;
+    }
+
+    if (after < sink.size() && !sink.received().contains(after, after + 1))
+    {
+        transfer->state = Bursting;
+        this->send(transfer, FtpPayload::BurstReadFile, after, FtpPayload::maxDataSize);
+        return;
+    }
+
+    this->repair(transfer);
+}
+
+void FtpClient::repair(Transfer* transfer)
+{
+    const QVector<RangeSet::Range> gaps = transfer->sink.received().gaps(transfer->sink.size());
+    if (gaps.isEmpty())
+    {
+        this->terminate(transfer);
+        return;
+    }
+
+    const RangeSet::Range gap = gaps.first();
+    const qint64 length = gap.second - gap.first;
+    if (length > burstRepairThreshold)
+    {
+        transfer->state = Bursting;
+        this->send(transfer, FtpPayload::BurstReadFile, quint32(gap.first),
+                   FtpPayload::maxDataSize);
+        return;
+    }
+
+    transfer->state = Repairing;
+    this->send(transfer, FtpPayload::ReadFile, quint32(gap.first),
+               quint8(qMin<qint64>(length, FtpPayload::maxDataSize)));
+}
+
+void FtpClient::terminate(Transfer* transfer)
+{
+    transfer->state = Closing;
+    transfer->retries = 0;
+    this->send(transfer, FtpPayload::TerminateSession, 0, 0);
+}
+
+void FtpClient::finish(Transfer* transfer, bool succeeded, const QString& error)
+{
+    transfer->timer->stop();
+    transfer->timer->deleteLater();
+
+    if (transfer->state == Queued)
+        m_queue.removeAll(transfer);
+    else
+        m_running--;
+
+    if (transfer->state == Opening)
+        m_opening.remove(transfer->request.seq);
+
+    // Free the remote session of an aborted transfer, no reply is awaited
+    if (m_sessions.remove(transfer->session) && transfer->state != Closing)
+    {
+        FtpPayload payload;
+        payload.seq = ++m_seq;
+        payload.session = transfer->session;
+        payload.opcode = FtpPayload::TerminateSession;
+        emit sendPayload(payload.encode());
+    }
+
+    transfer->sink.close();
+    m_transfers.remove(transfer->id);
+
+    const int transferId = transfer->id;
+    delete transfer;
+
+    emit finished(transferId, succeeded, error);
+    this->dispatch();
+}
+
+void FtpClient::dispatch()
+{
+    while (m_running < maxSessions && !m_queue.isEmpty())
+    {
+        this->start(m_queue.dequeue());
+    }
+}
+
+QString FtpClient::errorText(FtpPayload::Error error)
+{
+    switch (error)
+    {
+    case FtpPayload::FileNotFound:
+        return tr("File not found");
+    case FtpPayload::FileProtected:
+        return tr("File protected");
+    case FtpPayload::NoSessionsAvailable:
+        return tr("No sessions available");
+    case FtpPayload::InvalidSession:
+        return tr("Invalid session");
+    case FtpPayload::EndOfFile:
+        return tr("Unexpected end of file");
+    default:
+        return tr("Transfer failed, error %1").arg(error);
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef FTP_CLIENT_H
+#define FTP_CLIENT_H
+
+#include "ftp_payload.h"
+#include "mapped_file_sink.h"
+
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+
+namespace md::domain
+{
+// MAVLink FTP downloads with burst reads, several sessions at once and repair of lost chunks.
+// Payloads are sent and received by the link module in FILE_TRANSFER_PROTOCOL messages.
+class FtpClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int maxSessions = 3;
+    static constexpr int maxRetries = 5;
+    static constexpr int timeout = 1000;
+    // Gaps longer than this are refilled with a burst rather than single reads
+    static constexpr int burstRepairThreshold = FtpPayload::maxDataSize * 8;
+
+    enum State
+    {
+        Queued,
+        Opening,
+        Bursting,
+        Repairing,
+        Closing
+    };
+
+    explicit FtpClient(QObject* parent = nullptr);
+    ~FtpClient() override;
+
+    // Transfer ids are given by the caller, so they stay unique across clients of many vehicles
+    void download(int transferId, const QString& remotePath, const QString& localPath);
+    void cancel(int transferId);
+
+    bool isActive(int transferId) const;
+    qint64 received(int transferId) const;
+    qint64 total(int transferId) const;
+
+public slots:
+    void receivePayload(const QByteArray& raw);
+    void resetSessions();
+
+signals:
+    void sendPayload(QByteArray raw);
+
+    void progressChanged(int transferId, qint64 received, qint64 total);
+    void finished(int transferId, bool succeeded, QString error);
+
+private:
+    struct Transfer
+    {
+        Transfer(int id, const QString& remotePath, const QString& localPath);
+
+        const int id;
+        const QString remotePath;
+        MappedFileSink sink;
+        State state = Queued;
+        quint8 session = 0;
+        FtpPayload request;
+        int retries = 0;
+        QTimer* timer = nullptr;
+    };
+
+    void start(Transfer* transfer);
+    void send(Transfer* transfer, FtpPayload::Opcode opcode, quint32 offset, quint8 size,
+              const QByteArray& data = QByteArray());
+    void resend(Transfer* transfer);
+    void onTimeout(Transfer* transfer);
+
+    void onOpened(Transfer* transfer, const FtpPayload& payload);
+    void onData(Transfer* transfer, const FtpPayload& payload);
+    void requestNext(Transfer* transfer, quint32 after);
+    void repair(Transfer* transfer);
+    void terminate(Transfer* transfer);
+    void finish(Transfer* transfer, bool succeeded, const QString& error = QString());
+    void dispatch();
+
+    static QString errorText(FtpPayload::Error error);
+
+    quint16 m_seq = 0;
+    QHash<int, Transfer*> m_transfers;
+    QQueue<Transfer*> m_queue;
+    QHash<quint16, Transfer*> m_opening;  // Transfers waiting for a session by request seq
+    QHash<quint8, Transfer*> m_sessions; // Transfers by opened session
+    int m_running = 0;
+};
+} // namespace md::domain
+
+#endif // FTP_CLIENT_H
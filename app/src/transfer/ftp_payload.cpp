@@ -0,0 +1,48 @@
+#include "ftp_payload.h"
+
+#include <QtEndian>
+#include <cstring>
+
+using namespace md::domain;
+
+QByteArray FtpPayload::encode() const
+{
+    const int length = qMin(data.size(), int(maxDataSize));
+
+    QByteArray raw(headerSize + length, '\0');
+    uchar* bytes = reinterpret_cast<uchar*>(raw.data());
+    qToLittleEndian<quint16>(seq, bytes);
+    bytes[2] = session;
+    bytes[3] = opcode;
+    bytes[4] = data.isEmpty() ? size : quint8(length);
+    bytes[5] = requestOpcode;
+    bytes[6] = burstComplete;
+    qToLittleEndian<quint32>(offset, bytes + 8);
+    memcpy(bytes + headerSize, data.constData(), size_t(length));
+    return raw;
+}
+
+FtpPayload FtpPayload::decode(const QByteArray& raw)
+{
+    FtpPayload payload;
+    if (raw.size() < headerSize)
+        return payload;
+
+    const uchar* bytes = reinterpret_cast<const uchar*>(raw.constData());
+    payload.seq = qFromLittleEndian<quint16>(bytes);
+    payload.session = bytes[2];
+    payload.opcode = bytes[3];
+    payload.size = bytes[4];
+    payload.requestOpcode = bytes[5];
+    payload.burstComplete = bytes[6];
+    payload.offset = qFromLittleEndian<quint32>(bytes + 8);
+
+    const int length = qMin(int(payload.size), raw.size() - headerSize);
+    payload.data = QByteArray::fromRawData(raw.constData() + headerSize, length);
+    return payload;
+}
+
+FtpPayload::Error FtpPayload::error() const
+{
+    return opcode == Nak && !data.isEmpty() ? Error(quint8(data.at(0))) : NoError;
+}
@@ -0,0 +1,68 @@
+#ifndef FTP_PAYLOAD_H
+#define FTP_PAYLOAD_H
+
+#include <QByteArray>
+
+namespace md::domain
+{
+// Payload of the MAVLink FILE_TRANSFER_PROTOCOL message, see MAVLink FTP spec
+struct FtpPayload
+{
+    enum Opcode : quint8
+    {
+        None = 0,
+        TerminateSession = 1,
+        ResetSessions = 2,
+        ListDirectory = 3,
+        OpenFileRO = 4,
+        ReadFile = 5,
+        CreateFile = 6,
+        WriteFile = 7,
+        RemoveFile = 8,
+        CreateDirectory = 9,
+        RemoveDirectory = 10,
+        OpenFileWO = 11,
+        TruncateFile = 12,
+        Rename = 13,
+        CalcFileCRC32 = 14,
+        BurstReadFile = 15,
+        Ack = 128,
+        Nak = 129
+    };
+
+    enum Error : quint8
+    {
+        NoError = 0,
+        Fail = 1,
+        FailErrno = 2,
+        InvalidDataSize = 3,
+        InvalidSession = 4,
+        NoSessionsAvailable = 5,
+        EndOfFile = 6,
+        UnknownCommand = 7,
+        FileExists = 8,
+        FileProtected = 9,
+        FileNotFound = 10
+    };
+
+    static constexpr int headerSize = 12;
+    static constexpr int maxDataSize = 239;
+
+    QByteArray encode() const;
+    // Data refers to the raw buffer without copying, it must outlive the payload
+    static FtpPayload decode(const QByteArray& raw);
+
+    Error error() const;
+
+    quint16 seq = 0;
+    quint8 session = 0;
+    quint8 opcode = None;
+    quint8 size = 0;
+    quint8 requestOpcode = None;
+    quint8 burstComplete = 0;
+    quint32 offset = 0;
+    QByteArray data;
+};
+} // namespace md::domain
+
+#endif // FTP_PAYLOAD_H
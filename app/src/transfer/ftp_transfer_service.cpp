@@ -0,0 +1,90 @@
+#include "ftp_transfer_service.h"
+
+using namespace md::domain;
+
+FtpTransferService::FtpTransferService(QObject* parent) :
+    QObject(parent),
+    m_worker(new QObject())
+{
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.setObjectName("FtpTransfer");
+    m_thread.start();
+}
+
+FtpTransferService::~FtpTransferService()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool FtpTransferService::isActive(int transferId) const
+{
+    return m_progress.contains(transferId);
+}
+
+FtpTransferService::Progress FtpTransferService::progress(int transferId) const
+{
+    return m_progress.value(transferId);
+}
+
+int FtpTransferService::download(const QVariant& vehicleId, const QString& remotePath,
+                                 const QString& localPath)
+{
+    const int transferId = ++m_lastTransferId;
+    m_progress.insert(transferId, Progress());
+
+    QMetaObject::invokeMethod(m_worker, [=]() {
+        this->client(vehicleId)->download(transferId, remotePath, localPath);
+    });
+    return transferId;
+}
+
+void FtpTransferService::cancel(int transferId)
+{
+    QMetaObject::invokeMethod(m_worker, [this, transferId]() {
+        for (FtpClient* client : qAsConst(m_clients))
+        {
+            client->cancel(transferId);
+        }
+    });
+}
+
+void FtpTransferService::receivePayload(const QVariant& vehicleId, const QByteArray& raw)
+{
+    QMetaObject::invokeMethod(m_worker, [this, vehicleId, raw]() {
+        FtpClient* client = m_clients.value(vehicleId.toString());
+        if (client)
+            client->receivePayload(raw);
+    });
+}
+
+void FtpTransferService::onProgressChanged(int transferId, qint64 received, qint64 total)
+{
+    if (!m_progress.contains(transferId))
+        return;
+
+    m_progress[transferId] = { received, total };
+    emit progressChanged(transferId);
+}
+
+void FtpTransferService::onFinished(int transferId, bool succeeded, const QString& error)
+{
+    m_progress.remove(transferId);
+    emit finished(transferId, succeeded, error);
+}
+
+FtpClient* FtpTransferService::client(const QVariant& vehicleId)
+{
+    FtpClient*& client = m_clients[vehicleId.toString()];
+    if (client)
+        return client;
+
+    client = new FtpClient(m_worker);
+    connect(client, &FtpClient::sendPayload, client, [this, vehicleId](const QByteArray& raw) {
+        emit sendPayload(vehicleId, raw);
+    });
+    connect(client, &FtpClient::progressChanged, this, &FtpTransferService::onProgressChanged);
+    connect(client, &FtpClient::finished, this, &FtpTransferService::onFinished);
+    return client;
+}
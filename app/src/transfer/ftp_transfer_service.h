@@ -0,0 +1,59 @@
+#ifndef FTP_TRANSFER_SERVICE_H
+#define FTP_TRANSFER_SERVICE_H
+
+#include "ftp_client.h"
+
+#include <QThread>
+#include <QVariant>
+
+namespace md::domain
+{
+// Runs MAVLink FTP downloads of every vehicle on a worker thread, one client per vehicle
+class FtpTransferService : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Progress
+    {
+        qint64 received = 0;
+        qint64 total = 0;
+    };
+
+    explicit FtpTransferService(QObject* parent = nullptr);
+    ~FtpTransferService() override;
+
+    bool isActive(int transferId) const;
+    Progress progress(int transferId) const;
+
+public slots:
+    int download(const QVariant& vehicleId, const QString& remotePath, const QString& localPath);
+    void cancel(int transferId);
+
+    // Thread safe, link modules call it directly, so payloads never pass through the GUI thread
+    void receivePayload(const QVariant& vehicleId, const QByteArray& raw);
+
+signals:
+    // Emitted on the worker thread, payloads go to FILE_TRANSFER_PROTOCOL of the vehicle
+    void sendPayload(QVariant vehicleId, QByteArray raw);
+
+    void progressChanged(int transferId);
+    void finished(int transferId, bool succeeded, QString error);
+
+private slots:
+    void onProgressChanged(int transferId, qint64 received, qint64 total);
+    void onFinished(int transferId, bool succeeded, const QString& error);
+
+private:
+    // Worker thread only
+    FtpClient* client(const QVariant& vehicleId);
+
+    QThread m_thread;
+    QObject* const m_worker; // Owns the clients on the worker thread
+    QHash<QString, FtpClient*> m_clients;
+    int m_lastTransferId = 0;
+    QHash<int, Progress> m_progress;
+};
+} // namespace md::domain
+
+#endif // FTP_TRANSFER_SERVICE_H
@@ -0,0 +1,72 @@
+#include "log_download_service.h"
+
+using namespace md::domain;
+
+LogDownloadService::LogDownloadService(QObject* parent) :
+    QObject(parent),
+    m_downloader(new LogDownloader())
+{
+    m_downloader->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_downloader, &QObject::deleteLater);
+    connect(m_downloader, &LogDownloader::progressChanged, this,
+            &LogDownloadService::onProgressChanged);
+    connect(m_downloader, &LogDownloader::finished, this, &LogDownloadService::onFinished);
+    m_thread.setObjectName("LogDownload");
+    m_thread.start();
+}
+
+LogDownloadService::~LogDownloadService()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+LogDownloader* LogDownloadService::downloader() const
+{
+    return m_downloader;
+}
+
+bool LogDownloadService::isActive(int downloadId) const
+{
+    return m_progress.contains(downloadId);
+}
+
+LogDownloadService::Progress LogDownloadService::progress(int downloadId) const
+{
+    return m_progress.value(downloadId);
+}
+
+int LogDownloadService::download(const QVariant& vehicleId, int logId, qint64 size,
+                                 const QString& path)
+{
+    const int downloadId = ++m_lastDownloadId;
+    m_progress[downloadId].total = size;
+
+    QMetaObject::invokeMethod(m_downloader, [=]() {
+        m_downloader->start(downloadId, vehicleId, logId, size, path);
+    });
+    return downloadId;
+}
+
+void LogDownloadService::cancel(int downloadId)
+{
+    QMetaObject::invokeMethod(m_downloader, [this, downloadId]() {
+        m_downloader->cancel(downloadId);
+    });
+}
+
+void LogDownloadService::onProgressChanged(int downloadId, qint64 received, qint64 total,
+                                           double throughput, double eta, bool stalled)
+{
+    if (!m_progress.contains(downloadId))
+        return;
+
+    m_progress[downloadId] = { received, total, throughput, eta, stalled };
+    emit progressChanged(downloadId);
+}
+
+void LogDownloadService::onFinished(int downloadId, bool succeeded, const QString& error)
+{
+    m_progress.remove(downloadId);
+    emit finished(downloadId, succeeded, error);
+}
@@ -0,0 +1,55 @@
+#ifndef LOG_DOWNLOAD_SERVICE_H
+#define LOG_DOWNLOAD_SERVICE_H
+
+#include "log_downloader.h"
+
+#include <QThread>
+
+namespace md::domain
+{
+// Runs onboard log downloads on a worker thread and keeps their latest progress
+class LogDownloadService : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Progress
+    {
+        qint64 received = 0;
+        qint64 total = 0;
+        double throughput = 0;
+        double eta = -1;
+        bool stalled = false;
+    };
+
+    explicit LogDownloadService(QObject* parent = nullptr);
+    ~LogDownloadService() override;
+
+    // Link modules connect here directly, so log data never passes through the GUI thread
+    LogDownloader* downloader() const;
+
+    bool isActive(int downloadId) const;
+    Progress progress(int downloadId) const;
+
+public slots:
+    int download(const QVariant& vehicleId, int logId, qint64 size, const QString& path);
+    void cancel(int downloadId);
+
+signals:
+    void progressChanged(int downloadId);
+    void finished(int downloadId, bool succeeded, QString error);
+
+private slots:
+    void onProgressChanged(int downloadId, qint64 received, qint64 total, double throughput,
+                           double eta, bool stalled);
+    void onFinished(int downloadId, bool succeeded, const QString& error);
+
+private:
+    QThread m_thread;
+    LogDownloader* const m_downloader;
+    int m_lastDownloadId = 0;
+    QHash<int, Progress> m_progress;
+};
+} // namespace md::domain
+
+#endif // LOG_DOWNLOAD_SERVICE_H
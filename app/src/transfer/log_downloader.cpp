@@ -0,0 +1,316 @@
+#include "log_downloader.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSharedPointer>
+
+#include <iterator>
+
+namespace
+{
+constexpr char logId[] = "logId";
+constexpr char size[] = "size";
+constexpr char ranges[] = "ranges";
+constexpr char rangesSuffix[] = ".ranges";
+
+// Weight of the latest tick in the smoothed throughput
+constexpr double throughputSmoothing = 0.2;
+constexpr int maxBackoff = 8;
+
+md::domain::LogDownloader::Clock elapsedClock()
+{
+    QSharedPointer<QElapsedTimer> elapsed(new QElapsedTimer);
+    elapsed->start();
+    return [elapsed]() {
+        return elapsed->elapsed();
+    };
+}
+} // namespace
+
+using namespace md::domain;
+
+LogDownloader::Download::Download(int id, const QVariant& vehicleId, int logId,
+                                  const QString& path) :
+    id(id),
+    vehicleId(vehicleId),
+    logId(logId),
+    sink(path)
+{
+}
+
+LogDownloader::LogDownloader(QObject* parent) : LogDownloader(::elapsedClock(), parent)
+{
+}
+
+LogDownloader::LogDownloader(Clock clock, QObject* parent) :
+    QObject(parent),
+    m_clock(std::move(clock)),
+    m_ticker(new QTimer(this))
+{
+    m_ticker->setInterval(tickInterval);
+    connect(m_ticker, &QTimer::timeout, this, &LogDownloader::process);
+}
+
+LogDownloader::~LogDownloader()
+{
+    for (Download* download : qAsConst(m_downloads))
+    {
+        this->saveRanges(download);
+    }
+    qDeleteAll(m_downloads);
+}
+
+QString LogDownloader::rangesPath(const QString& path)
+{
+    return path + ::rangesSuffix;
+}
+
+void LogDownloader::start(int downloadId, const QVariant& vehicleId, int logId, qint64 size,
+                          const QString& path)
+{
+    if (m_downloads.contains(downloadId))
+        return;
+
+    Download* download = new Download(downloadId, vehicleId, logId, path);
+    if (!download->sink.open(size))
+    {
+        delete download;
+        emit finished(downloadId, false, tr("Can't open %1").arg(path));
+        return;
+    }
+
+    m_downloads.insert(downloadId, download);
+    this->loadRanges(download);
+
+    download->lastData = m_clock();
+    download->lastSave = download->lastData;
+    download->lastCovered = download->sink.received().covered();
+
+    if (download->sink.isComplete())
+    {
+        this->finish(download, true);
+        return;
+    }
+
+    this->fill(download);
+    if (!m_ticker->isActive())
+        m_ticker->start();
+}
+
+void LogDownloader::cancel(int downloadId)
+{
+    Download* download = m_downloads.value(downloadId);
+    if (!download)
+        return;
+
+    this->finish(download, false, tr("Canceled"));
+}
+
+void LogDownloader::receiveData(const QVariant& vehicleId, int logId, quint32 offset,
+                                const QByteArray& data)
+{
+    if (data.isEmpty())
+        return;
+
+    Download* download = nullptr;
+    for (Download* candidate : qAsConst(m_downloads))
+    {
+        if (candidate->logId == logId && candidate->vehicleId == vehicleId)
+        {
+            download = candidate;
+            break;
+        }
+    }
+    if (!download)
+        return;
+
+    download->lastData = m_clock();
+    if (download->sink.write(offset, data.constData(), data.size()))
+        download->dirty = true;
+
+    if (download->sink.isComplete())
+    {
+        this->finish(download, true);
+        return;
+    }
+
+    // Top up the window as soon as the request holding this chunk is filled
+    auto it = download->outstanding.upperBound(offset);
+    if (it == download->outstanding.begin())
+        return;
+
+    it = std::prev(it);
+    if (offset < it->end && download->sink.received().contains(it.key(), it->end))
+    {
+        download->outstanding.erase(it);
+        this->fill(download);
+    }
+}
+
+void LogDownloader::process()
+{
+    const qint64 now = m_clock();
+    const double interval = tickInterval / 1000.0;
+
+    for (Download* download : m_downloads.values())
+    {
+        const RangeSet& received = download->sink.received();
+        for (auto it = download->outstanding.begin(); it != download->outstanding.end();)
+        {
+            if (received.contains(it.key(), it->end))
+            {
+                it = download->outstanding.erase(it);
+                continue;
+            }
+
+            if (it->deadline < now)
+                this->retry(download, it.key(), it.value());
+            ++it;
+        }
+        this->fill(download);
+
+        const qint64 covered = received.covered();
+        const double rate = (covered - download->lastCovered) / interval;
+        download->throughput += ::throughputSmoothing * (rate - download->throughput);
+        download->lastCovered = covered;
+
+        const qint64 remaining = download->sink.size() - covered;
+        const bool stalled = now - download->lastData > stallTimeout;
+        const double eta = download->throughput > 1 ? remaining / download->throughput : -1;
+        emit progressChanged(download->id, covered, download->sink.size(), download->throughput,
+                             eta, stalled);
+
+        if (download->dirty && now - download->lastSave >= saveInterval)
+            this->saveRanges(download);
+    }
+}
+
+void LogDownloader::fill(Download* download)
+{
+    QMap<qint64, Request>& outstanding = download->outstanding;
+    const QVector<RangeSet::Range> gaps = download->sink.received().gaps(download->sink.size());
+
+    for (const RangeSet::Range& gap : gaps)
+    {
+        qint64 cursor = gap.first;
+        while (cursor < gap.second)
+        {
+            if (outstanding.count() >= maxOutstanding)
+                return;
+
+            // Skip the part already requested
+            auto next = outstanding.upperBound(cursor);
+            if (next != outstanding.begin() && std::prev(next)->end > cursor)
+            {
+                cursor = std::prev(next)->end;
+                continue;
+            }
+
+            qint64 end = qMin(gap.second, cursor + requestSize);
+            if (next != outstanding.end())
+                end = qMin(end, next.key());
+
+            this->request(download, cursor, end);
+            cursor = end;
+        }
+    }
+}
+
+void LogDownloader::request(Download* download, qint64 begin, qint64 end)
+{
+    download->outstanding.insert(begin, { end, m_clock() + requestTimeout });
+    emit requestData(download->vehicleId, download->logId, quint32(begin), quint32(end - begin));
+}
+
+void LogDownloader::retry(Download* download, qint64 begin, Request& request)
+{
+    // Back off while the link is gone, but keep asking so the download resumes by itself
+    request.attempts++;
+    request.deadline = m_clock() +
+                       requestTimeout * qMin(request.attempts + 1, ::maxBackoff);
+
+    const QVector<RangeSet::Range> gaps = download->sink.received().gaps(request.end);
+    for (const RangeSet::Range& gap : gaps)
+    {
+        if (gap.second <= begin)
+            continue;
+
+        const qint64 from = qMax(gap.first, begin);
+        emit requestData(download->vehicleId, download->logId, quint32(from),
+                         quint32(gap.second - from));
+    }
+}
+
+void LogDownloader::loadRanges(Download* download)
+{
+    QFile file(rangesPath(download->sink.path()));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    if (json.value(::logId).toInt() != download->logId ||
+        json.value(::size).toVariant().toLongLong() != download->sink.size())
+        return;
+
+    download->sink.setReceived(
+        RangeSet::fromVariantList(json.value(::ranges).toArray().toVariantList()));
+}
+
+void LogDownloader::saveRanges(Download* download)
+{
+    download->dirty = false;
+    download->lastSave = m_clock();
+
+    if (!download->sink.received().covered())
+        return;
+
+    QJsonObject json;
+    json.insert(::logId, download->logId);
+    json.insert(::size, download->sink.size());
+    json.insert(::ranges, QJsonArray::fromVariantList(download->sink.received().toVariantList()));
+
+    QSaveFile file(rangesPath(download->sink.path()));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Can't save download ranges" << file.fileName() << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+void LogDownloader::finish(Download* download, bool succeeded, const QString& error)
+{
+    if (succeeded)
+        QFile::remove(rangesPath(download->sink.path()));
+    else
+        this->saveRanges(download);
+
+    download->sink.close();
+    m_downloads.remove(download->id);
+
+    const int downloadId = download->id;
+    const QVariant vehicleId = download->vehicleId;
+    const qint64 size = download->sink.size();
+    delete download;
+
+    bool vehicleBusy = false;
+    for (Download* other : qAsConst(m_downloads))
+    {
+        vehicleBusy |= other->vehicleId == vehicleId;
+    }
+    if (!vehicleBusy)
+        emit requestEnd(vehicleId);
+
+    if (m_downloads.isEmpty())
+        m_ticker->stop();
+
+    if (succeeded)
+        emit progressChanged(downloadId, size, size, 0, 0, false);
+    emit finished(downloadId, succeeded, error);
+}
@@ -0,0 +1,92 @@
+#ifndef LOG_DOWNLOADER_H
+#define LOG_DOWNLOADER_H
+
+#include "mapped_file_sink.h"
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVariant>
+#include <functional>
+
+namespace md::domain
+{
+// Downloads onboard logs with LOG_REQUEST_DATA / LOG_DATA, lives on a worker thread.
+// Several requests are kept outstanding and only missing ranges are requested again.
+class LogDownloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 requestSize = 90 * 512; // LOG_DATA packets per request
+    static constexpr int maxOutstanding = 4;
+    static constexpr int requestTimeout = 1500;
+    static constexpr int stallTimeout = 5000;
+    static constexpr int tickInterval = 250;
+    static constexpr int saveInterval = 2000;
+
+    using Clock = std::function<qint64()>; // Monotonic milliseconds
+
+    explicit LogDownloader(QObject* parent = nullptr);
+    LogDownloader(Clock clock, QObject* parent = nullptr);
+    ~LogDownloader() override;
+
+    // Received ranges are kept next to the file, so broken downloads resume
+    static QString rangesPath(const QString& path);
+
+public slots:
+    void start(int downloadId, const QVariant& vehicleId, int logId, qint64 size,
+               const QString& path);
+    void cancel(int downloadId);
+    void receiveData(const QVariant& vehicleId, int logId, quint32 offset,
+                     const QByteArray& data);
+    // Retries late requests, refills the window and reports progress, run by the ticker
+    void process();
+
+signals:
+    void requestData(QVariant vehicleId, int logId, quint32 offset, quint32 count);
+    void requestEnd(QVariant vehicleId);
+
+    // Throughput in bytes per second, ETA in seconds or -1 when unknown
+    void progressChanged(int downloadId, qint64 received, qint64 total, double throughput,
+                         double eta, bool stalled);
+    void finished(int downloadId, bool succeeded, QString error);
+
+private:
+    struct Request
+    {
+        qint64 end;
+        qint64 deadline;
+        int attempts = 0;
+    };
+
+    struct Download
+    {
+        Download(int id, const QVariant& vehicleId, int logId, const QString& path);
+
+        const int id;
+        const QVariant vehicleId;
+        const int logId;
+        MappedFileSink sink;
+        QMap<qint64, Request> outstanding; // Requested ranges by begin
+        qint64 lastData = 0;
+        qint64 lastCovered = 0;
+        qint64 lastSave = 0;
+        double throughput = 0;
+        bool dirty = false;
+    };
+
+    void fill(Download* download);
+    void request(Download* download, qint64 begin, qint64 end);
+    void retry(Download* download, qint64 begin, Request& request);
+    void loadRanges(Download* download);
+    void saveRanges(Download* download);
+    void finish(Download* download, bool succeeded, const QString& error = QString());
+
+    QHash<int, Download*> m_downloads;
+    const Clock m_clock;
+    QTimer* const m_ticker;
+};
+} // namespace md::domain
+
+#endif // LOG_DOWNLOADER_H
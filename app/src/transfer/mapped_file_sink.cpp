@@ -0,0 +1,91 @@
+#include "mapped_file_sink.h"
+
+#include <QDebug>
+
+#include <cstring>
+
+using namespace md::domain;
+
+MappedFileSink::MappedFileSink(const QString& path) : m_file(path)
+{
+}
+
+MappedFileSink::~MappedFileSink()
+{
+    this->close();
+}
+
+bool MappedFileSink::open(qint64 size)
+{
+    this->close();
+
+    if (!m_file.open(QIODevice::ReadWrite) || !m_file.resize(size))
+    {
+        qWarning() << "Can't preallocate" << m_file.fileName() << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_size = size;
+    if (!size) // Nothing to map
+        return true;
+
+    m_data = m_file.map(0, size);
+    if (!m_data)
+    {
+        qWarning() << "Can't map" << m_file.fileName() << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFileSink::close()
+{
+    if (m_data)
+        m_file.unmap(m_data);
+
+    m_data = nullptr;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool MappedFileSink::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+qint64 MappedFileSink::size() const
+{
+    return m_size;
+}
+
+QString MappedFileSink::path() const
+{
+    return m_file.fileName();
+}
+
+qint64 MappedFileSink::write(qint64 offset, const char* data, qint64 length)
+{
+    if (!m_data || offset < 0 || offset >= m_size || length <= 0)
+        return 0;
+
+    length = qMin(length, m_size - offset);
+    std::memcpy(m_data + offset, data, size_t(length));
+    return m_received.insert(offset, offset + length);
+}
+
+const RangeSet& MappedFileSink::received() const
+{
+    return m_received;
+}
+
+void MappedFileSink::setReceived(const RangeSet& received)
+{
+    m_received = received;
+}
+
+bool MappedFileSink::isComplete() const
+{
+    return m_received.isComplete(m_size);
+}
@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_SINK_H
+#define MAPPED_FILE_SINK_H
+
+#include "range_set.h"
+
+#include <QFile>
+
+namespace md::domain
+{
+// Preallocated destination file, received chunks are copied straight into its mapping
+class MappedFileSink
+{
+public:
+    explicit MappedFileSink(const QString& path);
+    ~MappedFileSink();
+
+    // Keeps existing contents, so an interrupted transfer can resume
+    bool open(qint64 size);
+    void close();
+
+    bool isOpen() const;
+    qint64 size() const;
+    QString path() const;
+
+    // Returns the number of newly received bytes
+    qint64 write(qint64 offset, const char* data, qint64 length);
+
+    const RangeSet& received() const;
+    void setReceived(const RangeSet& received);
+    bool isComplete() const;
+
+private:
+    QFile m_file;
+    uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    RangeSet m_received;
+};
+} // namespace md::domain
+
+#endif // MAPPED_FILE_SINK_H
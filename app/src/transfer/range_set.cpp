@@ -0,0 +1,99 @@
+#include "range_set.h"
+
+#include <iterator>
+
+using namespace md::domain;
+
+qint64 RangeSet::insert(qint64 begin, qint64 end)
+{
+    if (begin >= end)
+        return 0;
+
+    const qint64 coveredBefore = m_covered;
+
+    // Step back to a range that may touch the new one
+    auto it = m_ranges.upperBound(begin);
+    if (it != m_ranges.begin() && std::prev(it).value() >= begin)
+        --it;
+
+    // Swallow every range overlapping or adjacent to [begin, end)
+    while (it != m_ranges.end() && it.key() <= end)
+    {
+        begin = qMin(begin, it.key());
+        end = qMax(end, it.value());
+        m_covered -= it.value() - it.key();
+        it = m_ranges.erase(it);
+    }
+
+    m_ranges.insert(begin, end);
+    m_covered += end - begin;
+    return m_covered - coveredBefore;
+}
+
+void RangeSet::clear()
+{
+    m_ranges.clear();
+    m_covered = 0;
+}
+
+bool RangeSet::contains(qint64 begin, qint64 end) const
+{
+    auto it = m_ranges.upperBound(begin);
+    if (it == m_ranges.begin())
+        return false;
+
+    --it;
+    return it.key() <= begin && it.value() >= end;
+}
+
+qint64 RangeSet::covered() const
+{
+    return m_covered;
+}
+
+int RangeSet::count() const
+{
+    return m_ranges.count();
+}
+
+QVector<RangeSet::Range> RangeSet::gaps(qint64 total) const
+{
+    QVector<Range> gaps;
+    qint64 position = 0;
+    for (auto it = m_ranges.constBegin(); it != m_ranges.constEnd() && position < total; ++it)
+    {
+        if (it.key() > position)
+            gaps.append({ position, qMin(it.key(), total) });
+        position = qMax(position, it.value());
+    }
+    if (position < total)
+        gaps.append({ position, total });
+    return gaps;
+}
+
+bool RangeSet::isComplete(qint64 total) const
+{
+    return this->contains(0, total) || total <= 0;
+}
+
+QVariantList RangeSet::toVariantList() const
+{
+    QVariantList list;
+    for (auto it = m_ranges.constBegin(); it != m_ranges.constEnd(); ++it)
+    {
+        list.append(QVariantList({ it.key(), it.value() }));
+    }
+    return list;
+}
+
+RangeSet RangeSet::fromVariantList(const QVariantList& list)
+{
+    RangeSet set;
+    for (const QVariant& item : list)
+    {
+        const QVariantList range = item.toList();
+        if (range.count() == 2)
+            set.insert(range.at(0).toLongLong(), range.at(1).toLongLong());
+    }
+    return set;
+}
@@ -0,0 +1,38 @@
+#ifndef RANGE_SET_H
+#define RANGE_SET_H
+
+#include <QMap>
+#include <QPair>
+#include <QVariantList>
+#include <QVector>
+
+namespace md::domain
+{
+// Disjoint half-open byte ranges, adjacent ranges are merged
+class RangeSet
+{
+public:
+    using Range = QPair<qint64, qint64>;
+
+    // Returns the number of newly covered bytes
+    qint64 insert(qint64 begin, qint64 end);
+    void clear();
+
+    bool contains(qint64 begin, qint64 end) const;
+    qint64 covered() const;
+    int count() const;
+
+    // Uncovered ranges inside [0, total)
+    QVector<Range> gaps(qint64 total) const;
+    bool isComplete(qint64 total) const;
+
+    QVariantList toVariantList() const;
+    static RangeSet fromVariantList(const QVariantList& list);
+
+private:
+    QMap<qint64, qint64> m_ranges; // Begin to end
+    qint64 m_covered = 0;
+};
+} // namespace md::domain
+
+#endif // RANGE_SET_H
@@ -0,0 +1,207 @@
+#include "mission_validation_service.h"
+
+#include <QDebug>
+#include <QtMath>
+
+namespace
+{
+constexpr char id[] = "id";
+constexpr char name[] = "name";
+constexpr char minValue[] = "minValue";
+constexpr char maxValue[] = "maxValue";
+
+double limitValue(const QVariant& value)
+{
+    bool ok = false;
+    const double limit = value.toDouble(&ok);
+    return ok ? limit : qQNaN();
+}
+} // namespace
+
+using namespace md::domain;
+
+MissionValidationService::MissionValidationService(IMissionsService* missions, QObject* parent) :
+    QObject(parent),
+    m_missions(missions),
+    m_validator(new MissionValidator(ValidationLimits::fromSettings()))
+{
+    qRegisterMetaType<QVector<QStringList>>("QVector<QStringList>");
+
+    m_validator->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_validator, &QObject::deleteLater);
+    connect(m_validator, &MissionValidator::validated, this,
+            &MissionValidationService::onValidated);
+    m_thread.setObjectName("MissionValidation");
+    m_thread.start(QThread::LowPriority);
+
+    connect(m_missions, &IMissionsService::missionAdded, this,
+            &MissionValidationService::onMissionAdded);
+    connect(m_missions, &IMissionsService::missionRemoved, this,
+            &MissionValidationService::onMissionRemoved);
+
+    for (Mission* mission : m_missions->missions())
+    {
+        this->onMissionAdded(mission);
+    }
+}
+
+MissionValidationService::~MissionValidationService()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool MissionValidationService::isValid(Mission* mission) const
+{
+    auto it = m_results.constFind(mission);
+    return it != m_results.constEnd() && !it->pending && !it->invalidCount;
+}
+
+bool MissionValidationService::isPending(Mission* mission) const
+{
+    return m_results.value(mission).pending > 0;
+}
+
+int MissionValidationService::invalidCount(Mission* mission) const
+{
+    return m_results.value(mission).invalidCount;
+}
+
+QStringList MissionValidationService::itemErrors(Mission* mission, int index) const
+{
+    return m_results.value(mission).errors.value(index);
+}
+
+QStringList MissionValidationService::errors(Mission* mission) const
+{
+    const QVector<QStringList> errors = m_results.value(mission).errors;
+
+    QStringList list;
+    for (int i = 0; i < errors.count(); ++i)
+    {
+        for (const QString& error : errors.at(i))
+        {
+            list.append(QString("%1: %2").arg(i).arg(error));
+        }
+    }
+    return list;
+}
+
+template<typename Call>
+void MissionValidationService::post(Mission* mission, Call call)
+{
+    m_results[mission].pending++;
+    emit validationChanged(mission);
+
+    QMetaObject::invokeMethod(m_validator, [this, call]() {
+        call(m_validator);
+    });
+}
+
+void MissionValidationService::onMissionAdded(Mission* mission)
+{
+    m_routeMissions.insert(this->routeKey(mission), mission);
+    m_results.insert(mission, Result());
+
+    QVector<ItemSnapshot> items;
+    MissionRoute* route = mission->route();
+    items.reserve(route->count());
+    for (int i = 0; i < route->count(); ++i)
+    {
+        items.append(this->snapshot(mission, route->item(i)));
+    }
+
+    this->post(mission, [key = this->routeKey(mission), items](MissionValidator* validator) {
+        validator->reset(key, items);
+    });
+
+    // Snapshots are taken here, the worker never touches route items
+    connect(mission->route, &MissionRoute::itemAdded, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                this->post(mission, [key = this->routeKey(mission), index,
+                                     snapshot = this->snapshot(mission, item)](
+                                        MissionValidator* validator) {
+                    validator->insertItem(key, index, snapshot);
+                });
+            });
+    connect(mission->route, &MissionRoute::itemChanged, this,
+            [this, mission](int index, MissionRouteItem* item) {
+                this->post(mission, [key = this->routeKey(mission), index,
+                                     snapshot = this->snapshot(mission, item)](
+                                        MissionValidator* validator) {
+                    validator->updateItem(key, index, snapshot);
+                });
+            });
+    connect(mission->route, &MissionRoute::itemRemoved, this, [this, mission](int index) {
+        this->post(mission, [key = this->routeKey(mission), index](MissionValidator* validator) {
+            validator->removeItem(key, index);
+        });
+    });
+}
+
+void MissionValidationService::onMissionRemoved(Mission* mission)
+{
+    disconnect(mission->route, nullptr, this, nullptr);
+
+    const QString key = this->routeKey(mission);
+    QMetaObject::invokeMethod(m_validator, [this, key]() {
+        m_validator->removeRoute(key);
+    });
+
+    m_routeMissions.remove(key);
+    m_results.remove(mission);
+}
+
+void MissionValidationService::onValidated(const QString& routeKey,
+                                           const QVector<QStringList>& errors, int invalidCount)
+{
+    Mission* mission = m_routeMissions.value(routeKey);
+    auto it = m_results.find(mission);
+    if (!mission || it == m_results.end())
+        return;
+
+    it->errors = errors;
+    it->invalidCount = invalidCount;
+    it->pending = qMax(it->pending - 1, 0);
+
+    emit validationChanged(mission);
+}
+
+ItemSnapshot MissionValidationService::snapshot(Mission* mission, MissionRouteItem* item) const
+{
+    ItemSnapshot snapshot;
+    snapshot.home = item->type() == mission->type()->homeItemType;
+
+    const Geodetic position = item->position();
+    snapshot.positioned = position.isValid();
+    if (snapshot.positioned)
+    {
+        snapshot.latitude = position.latitude();
+        snapshot.longitude = position.longitude();
+        snapshot.altitude = position.altitude();
+    }
+
+    const QVariantMap parameters = item->parametersMap();
+    for (auto parameter : item->type()->parameters.values())
+    {
+        const QVariantMap type = parameter->toVariantMap();
+        const QVariant value = parameters.value(type.value(::id).toString());
+        bool ok = false;
+        const double number = value.toDouble(&ok);
+        if (!ok)
+            continue;
+
+        const double min = ::limitValue(type.value(::minValue));
+        const double max = ::limitValue(type.value(::maxValue));
+        if (qIsNaN(min) && qIsNaN(max))
+            continue;
+
+        snapshot.parameters.append({ type.value(::name).toString(), number, min, max });
+    }
+    return snapshot;
+}
+
+QString MissionValidationService::routeKey(Mission* mission) const
+{
+    return mission->id().toString();
+}
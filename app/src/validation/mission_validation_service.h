@@ -0,0 +1,58 @@
+#ifndef MISSION_VALIDATION_SERVICE_H
+#define MISSION_VALIDATION_SERVICE_H
+
+#include "i_missions_service.h"
+#include "mission_validator.h"
+
+#include <QThread>
+
+namespace md::domain
+{
+// Validates mission routes on a worker thread as they are edited
+class MissionValidationService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MissionValidationService(IMissionsService* missions, QObject* parent = nullptr);
+    ~MissionValidationService() override;
+
+    // False while validation of the latest edits is pending
+    bool isValid(Mission* mission) const;
+    bool isPending(Mission* mission) const;
+    int invalidCount(Mission* mission) const;
+    QStringList itemErrors(Mission* mission, int index) const;
+    QStringList errors(Mission* mission) const;
+
+signals:
+    void validationChanged(Mission* mission);
+
+private slots:
+    void onMissionAdded(Mission* mission);
+    void onMissionRemoved(Mission* mission);
+    void onValidated(const QString& routeKey, const QVector<QStringList>& errors,
+                     int invalidCount);
+
+private:
+    ItemSnapshot snapshot(Mission* mission, MissionRouteItem* item) const;
+    QString routeKey(Mission* mission) const;
+
+    template<typename Call>
+    void post(Mission* mission, Call call);
+
+    struct Result
+    {
+        QVector<QStringList> errors;
+        int invalidCount = 0;
+        int pending = 0;
+    };
+
+    IMissionsService* const m_missions;
+    QThread m_thread;
+    MissionValidator* const m_validator;
+    QHash<QString, Mission*> m_routeMissions;
+    QHash<Mission*, Result> m_results;
+};
+} // namespace md::domain
+
+#endif // MISSION_VALIDATION_SERVICE_H
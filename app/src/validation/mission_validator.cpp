@@ -0,0 +1,137 @@
+#include "mission_validator.h"
+
+#include <QSettings>
+#include <QtMath>
+
+#include "geodesy_kernels.h"
+
+using namespace md::domain;
+
+ValidationLimits ValidationLimits::fromSettings()
+{
+    QSettings settings;
+    ValidationLimits limits;
+    limits.minAltitude = settings.value(minAltitudeSetting, limits.minAltitude).toDouble();
+    limits.maxAltitude = settings.value(maxAltitudeSetting, limits.maxAltitude).toDouble();
+    limits.maxLegLength = settings.value(maxLegLengthSetting, limits.maxLegLength).toDouble();
+    return limits;
+}
+
+MissionValidator::MissionValidator(const ValidationLimits& limits, QObject* parent) :
+    QObject(parent),
+    m_limits(limits)
+{
+}
+
+void MissionValidator::reset(const QString& routeKey, const QVector<ItemSnapshot>& items)
+{
+    Route& route = m_routes[routeKey];
+    route.items = items;
+    route.errors = QVector<QStringList>(items.count());
+    route.invalidCount = 0;
+
+    this->revalidate(routeKey, route, 0, items.count() - 1);
+}
+
+void MissionValidator::insertItem(const QString& routeKey, int index, const ItemSnapshot& item)
+{
+    Route& route = m_routes[routeKey];
+    if (index < 0 || index > route.items.count())
+    {
+        emit validated(routeKey, route.errors, route.invalidCount);
+        return;
+    }
+
+    route.items.insert(index, item);
+    route.errors.insert(index, QStringList());
+
+    // New item and the next one, which has a new leg and may have lost the first place
+    this->revalidate(routeKey, route, index, index + 1);
+}
+
+void MissionValidator::updateItem(const QString& routeKey, int index, const ItemSnapshot& item)
+{
+    Route& route = m_routes[routeKey];
+    if (index < 0 || index >= route.items.count())
+    {
+        emit validated(routeKey, route.errors, route.invalidCount);
+        return;
+    }
+
+    route.items[index] = item;
+
+    this->revalidate(routeKey, route, index, index + 1);
+}
+
+void MissionValidator::removeItem(const QString& routeKey, int index)
+{
+    Route& route = m_routes[routeKey];
+    if (index < 0 || index >= route.items.count())
+    {
+        emit validated(routeKey, route.errors, route.invalidCount);
+        return;
+    }
+
+    if (!route.errors.at(index).isEmpty())
+        route.invalidCount--;
+
+    route.items.removeAt(index);
+    route.errors.removeAt(index);
+
+    // Item taking the removed place has a new leg
+    this->revalidate(routeKey, route, index, index);
+}
+
+void MissionValidator::removeRoute(const QString& routeKey)
+{
+    m_routes.remove(routeKey);
+}
+
+void MissionValidator::revalidate(const QString& routeKey, Route& route, int from, int to)
+{
+    for (int i = qMax(from, 0); i <= qMin(to, route.items.count() - 1); ++i)
+    {
+        const QStringList errors = this->validateItem(route, i);
+        route.invalidCount += int(!errors.isEmpty()) - int(!route.errors.at(i).isEmpty());
+        route.errors[i] = errors;
+    }
+
+    emit validated(routeKey, route.errors, route.invalidCount);
+}
+
+QStringList MissionValidator::validateItem(const Route& route, int index) const
+{
+    const ItemSnapshot& item = route.items.at(index);
+    QStringList errors;
+
+    if (index == 0 && !item.home)
+        errors.append(tr("First item must be home"));
+    else if (index > 0 && item.home)
+        errors.append(tr("Home must be the first item"));
+
+    if (item.positioned)
+    {
+        if (item.altitude < m_limits.minAltitude || item.altitude > m_limits.maxAltitude)
+            errors.append(tr("Altitude %1 m is out of limits").arg(item.altitude));
+
+        const ItemSnapshot* previous = index > 0 ? &route.items.at(index - 1) : nullptr;
+        if (previous && previous->positioned)
+        {
+            double distance = 0;
+            geodesy::haversine(&previous->latitude, &previous->longitude, &item.latitude,
+                               &item.longitude, &distance, 1);
+            if (distance > m_limits.maxLegLength)
+                errors.append(tr("Leg length %1 m exceeds %2 m")
+                                  .arg(qRound(distance))
+                                  .arg(m_limits.maxLegLength));
+        }
+    }
+
+    for (const ItemSnapshot::ParameterCheck& parameter : item.parameters)
+    {
+        if (parameter.value < parameter.minValue || parameter.value > parameter.maxValue)
+            errors.append(tr("%1 is out of range").arg(parameter.name));
+    }
+
+    return errors;
+}
@@ -0,0 +1,77 @@
+#ifndef MISSION_VALIDATOR_H
+#define MISSION_VALIDATOR_H
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+namespace md::domain
+{
+struct ValidationLimits
+{
+    static constexpr char minAltitudeSetting[] = "missions/minAltitude";
+    static constexpr char maxAltitudeSetting[] = "missions/maxAltitude";
+    static constexpr char maxLegLengthSetting[] = "missions/maxLegLength";
+
+    static ValidationLimits fromSettings();
+
+    double minAltitude = -500;
+    double maxAltitude = 10000;
+    double maxLegLength = 50000;
+};
+
+// Thread-independent copy of the route item data that validation needs
+struct ItemSnapshot
+{
+    struct ParameterCheck
+    {
+        QString name;
+        double value;
+        double minValue; // NaN if not limited
+        double maxValue; // NaN if not limited
+    };
+
+    bool home = false;
+    bool positioned = false;
+    double latitude = 0;
+    double longitude = 0;
+    double altitude = 0;
+    QVector<ParameterCheck> parameters;
+};
+
+// Lives on the validation thread, keeps per-item results of every route
+class MissionValidator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MissionValidator(const ValidationLimits& limits, QObject* parent = nullptr);
+
+    void reset(const QString& routeKey, const QVector<ItemSnapshot>& items);
+    void insertItem(const QString& routeKey, int index, const ItemSnapshot& item);
+    void updateItem(const QString& routeKey, int index, const ItemSnapshot& item);
+    void removeItem(const QString& routeKey, int index);
+    void removeRoute(const QString& routeKey);
+
+signals:
+    // Once per call, out of range edits included, the service counts them to settle results
+    void validated(const QString& routeKey, const QVector<QStringList>& errors, int invalidCount);
+
+private:
+    struct Route
+    {
+        QVector<ItemSnapshot> items;
+        QVector<QStringList> errors;
+        int invalidCount = 0;
+    };
+
+    void revalidate(const QString& routeKey, Route& route, int from, int to);
+    QStringList validateItem(const Route& route, int index) const;
+
+    const ValidationLimits m_limits;
+    QHash<QString, Route> m_routes;
+};
+} // namespace md::domain
+
+#endif // MISSION_VALIDATOR_H
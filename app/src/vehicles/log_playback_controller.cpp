@@ -0,0 +1,132 @@
+#include "log_playback_controller.h"
+
+#include <QDebug>
+#include <QUrl>
+
+#include "locator.h"
+
+namespace
+{
+constexpr char id[] = "id";
+} // namespace
+
+using namespace md::domain;
+using namespace md::presentation;
+
+LogPlaybackController::LogPlaybackController(QObject* parent) :
+    QObject(parent),
+    m_playback(md::app::Locator::get<LogPlaybackService>()),
+    m_vehicles(md::app::Locator::get<IVehiclesService>())
+{
+    Q_ASSERT(m_playback);
+    Q_ASSERT(m_vehicles);
+
+    IPropertyTree* pTree = md::app::Locator::get<IPropertyTree>();
+    Q_ASSERT(pTree);
+
+    connect(m_playback, &LogPlaybackService::logChanged, this, &LogPlaybackController::logChanged);
+    connect(m_playback, &LogPlaybackService::timeChanged, this,
+            &LogPlaybackController::timeChanged);
+    connect(m_playback, &LogPlaybackService::playingChanged, this,
+            &LogPlaybackController::playingChanged);
+    connect(m_playback, &LogPlaybackService::rateChanged, this,
+            &LogPlaybackController::rateChanged);
+    connect(pTree, &IPropertyTree::propertiesChanged, this,
+            [this](const QString& nodeId, const QVariantMap& properties) {
+                if (nodeId == m_playback->nodeId())
+                    emit telemetryChanged(nodeId, properties);
+            });
+}
+
+bool LogPlaybackController::isLoading() const
+{
+    return m_playback->isLoading();
+}
+
+bool LogPlaybackController::isOpened() const
+{
+    return m_playback->isOpen();
+}
+
+QString LogPlaybackController::path() const
+{
+    return m_playback->path();
+}
+
+QVariant LogPlaybackController::vehicleId() const
+{
+    return m_playback->vehicleId();
+}
+
+QString LogPlaybackController::nodeId() const
+{
+    return m_playback->nodeId();
+}
+
+QJsonObject LogPlaybackController::replayVehicle() const
+{
+    Vehicle* vehicle = m_vehicles->vehicle(m_playback->vehicleId());
+    if (!vehicle || !m_playback->isOpen())
+        return QJsonObject();
+
+    QVariantMap map = vehicle->toVariantMap();
+    map.insert(::id, m_playback->nodeId());
+    return QJsonObject::fromVariantMap(map);
+}
+
+QJsonArray LogPlaybackController::track() const
+{
+    return m_playback->track();
+}
+
+int LogPlaybackController::duration() const
+{
+    return int(m_playback->duration());
+}
+
+int LogPlaybackController::time() const
+{
+    return int(m_playback->time());
+}
+
+bool LogPlaybackController::isPlaying() const
+{
+    return m_playback->isPlaying();
+}
+
+double LogPlaybackController::rate() const
+{
+    return m_playback->rate();
+}
+
+void LogPlaybackController::open(const QString& path, const QVariant& vehicleId)
+{
+    // Accept both plain paths and file urls
+    const QUrl url(path);
+    m_playback->open(url.isLocalFile() ? url.toLocalFile() : path, vehicleId);
+}
+
+void LogPlaybackController::close()
+{
+    m_playback->close();
+}
+
+void LogPlaybackController::play()
+{
+    m_playback->play();
+}
+
+void LogPlaybackController::pause()
+{
+    m_playback->pause();
+}
+
+void LogPlaybackController::seek(int time)
+{
+    m_playback->seek(time);
+}
+
+void LogPlaybackController::setRate(double rate)
+{
+    m_playback->setRate(rate);
+}
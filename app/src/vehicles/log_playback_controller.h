@@ -0,0 +1,67 @@
+#ifndef LOG_PLAYBACK_CONTROLLER_H
+#define LOG_PLAYBACK_CONTROLLER_H
+
+#include "i_vehicles_service.h"
+#include "log_playback_service.h"
+
+#include <QJsonObject>
+
+namespace md::presentation
+{
+class LogPlaybackController : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool loading READ isLoading NOTIFY logChanged)
+    Q_PROPERTY(bool opened READ isOpened NOTIFY logChanged)
+    Q_PROPERTY(QString path READ path NOTIFY logChanged)
+    Q_PROPERTY(QVariant vehicleId READ vehicleId NOTIFY logChanged)
+    Q_PROPERTY(QString nodeId READ nodeId NOTIFY logChanged)
+    Q_PROPERTY(QJsonArray track READ track NOTIFY logChanged)
+    Q_PROPERTY(int duration READ duration NOTIFY logChanged)
+
+    Q_PROPERTY(int time READ time WRITE seek NOTIFY timeChanged)
+    Q_PROPERTY(bool playing READ isPlaying NOTIFY playingChanged)
+    Q_PROPERTY(double rate READ rate WRITE setRate NOTIFY rateChanged)
+
+public:
+    explicit LogPlaybackController(QObject* parent = nullptr);
+
+    bool isLoading() const;
+    bool isOpened() const;
+    QString path() const;
+    QVariant vehicleId() const;
+    QString nodeId() const;
+    QJsonArray track() const;
+    int duration() const;
+
+    // Replayed vehicle, a copy of the source one identified by the playback node
+    Q_INVOKABLE QJsonObject replayVehicle() const;
+
+    int time() const;
+    bool isPlaying() const;
+    double rate() const;
+
+public slots:
+    void open(const QString& path, const QVariant& vehicleId);
+    void close();
+
+    void play();
+    void pause();
+    void seek(int time);
+    void setRate(double rate);
+
+signals:
+    void logChanged();
+    void timeChanged();
+    void playingChanged();
+    void rateChanged();
+    void telemetryChanged(QString nodeId, QVariantMap telemetry);
+
+private:
+    domain::LogPlaybackService* const m_playback;
+    domain::IVehiclesService* const m_vehicles;
+};
+} // namespace md::presentation
+
+#endif // LOG_PLAYBACK_CONTROLLER_H
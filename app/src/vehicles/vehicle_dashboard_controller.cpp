@@ -16,11 +16,13 @@ VehicleDashboardController::VehicleDashboardController(QObject* parent) :
     QObject(parent),
     m_pTree(md::app::Locator::get<IPropertyTree>()),
     m_features(md::app::Locator::get<IVehiclesFeatures>()),
-    m_commands(md::app::Locator::get<ICommandsService>())
+    m_commands(md::app::Locator::get<CommandPipeline>()),
+    m_rates(md::app::Locator::get<TelemetryRateService>())
 {
     Q_ASSERT(m_pTree);
     Q_ASSERT(m_features);
     Q_ASSERT(m_commands);
+    Q_ASSERT(m_rates);
 
     connect(m_pTree, &IPropertyTree::propertiesChanged, this,
             &VehicleDashboardController::telemetryChanged);
@@ -55,7 +57,7 @@ void VehicleDashboardController::sendCommand(const QString& commandId, const QVa
     if (m_selectedVehicleId.isNull())
         return;
 
-    emit m_commands->requestCommand(commandId)->exec(m_selectedVehicleId, args);
+    m_commands->send(m_selectedVehicleId, commandId, args);
 }
 
 void VehicleDashboardController::selectVehicle(const QString& vehicleId)
@@ -64,6 +66,7 @@ void VehicleDashboardController::selectVehicle(const QString& vehicleId)
         return;
 
     m_selectedVehicleId = vehicleId;
+    m_rates->setSelectedVehicle(vehicleId);
     emit selectedVehicleChanged();
     emit telemetryChanged();
 }
@@ -1,9 +1,10 @@
 #ifndef VEHICLE_DASHBOARD_CONTROLLER_H
 #define VEHICLE_DASHBOARD_CONTROLLER_H
 
-#include "i_command_service.h"
+#include "command_pipeline.h"
 #include "i_property_tree.h"
 #include "i_vehicles_features.h"
+#include "telemetry_rate_service.h"
 
 #include <QJsonArray>
 
@@ -36,7 +37,8 @@ signals:
 private:
     domain::IPropertyTree* const m_pTree;
     domain::IVehiclesFeatures* const m_features;
-    domain::ICommandsService* const m_commands;
+    domain::CommandPipeline* const m_commands;
+    domain::TelemetryRateService* const m_rates;
 
     QString m_selectedVehicleId;
 };
@@ -11,11 +11,13 @@ VehiclesMapController::VehiclesMapController(QObject* parent) :
     QObject(parent),
     m_vehicles(md::app::Locator::get<IVehiclesService>()),
     m_pTree(md::app::Locator::get<IPropertyTree>()),
-    m_commands(md::app::Locator::get<ICommandsService>())
+    m_commands(md::app::Locator::get<CommandPipeline>()),
+    m_rates(md::app::Locator::get<TelemetryRateService>())
 {
     Q_ASSERT(m_vehicles);
     Q_ASSERT(m_pTree);
     Q_ASSERT(m_commands);
+    Q_ASSERT(m_rates);
 
     connect(m_vehicles, &IVehiclesService::vehicleAdded, this, [this](Vehicle* vehicle) {
         emit vehicleAdded(vehicle->toVariantMap());
@@ -73,7 +75,13 @@ QVariantMap VehiclesMapController::telemetry(const QVariant& vehicleId) const
 void VehiclesMapController::sendCommand(const QVariant& vehicleId, const QString& commandId,
                                         const QVariantList& args)
 {
-    emit m_commands->requestCommand(commandId)->exec(vehicleId, args);
+    m_commands->send(vehicleId, commandId, args);
+}
+
+void VehiclesMapController::broadcastCommand(const QVariantList& vehicleIds,
+                                             const QString& commandId, const QVariantList& args)
+{
+    m_commands->broadcast(vehicleIds, commandId, args);
 }
 
 void VehiclesMapController::setTracking(bool tracking)
@@ -82,6 +90,7 @@ void VehiclesMapController::setTracking(bool tracking)
         return;
 
     m_tracking = tracking;
+    m_rates->setTracking(tracking);
     emit trackingChanged();
 }
 
@@ -93,5 +102,6 @@ void VehiclesMapController::selectVehicle(const QVariant& vehicleId)
     this->setTracking(false);
 
     m_selectedVehicleId = vehicleId;
+    m_rates->setSelectedVehicle(vehicleId);
     emit selectedVehicleChanged(vehicleId);
 }
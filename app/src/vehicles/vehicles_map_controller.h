@@ -1,9 +1,10 @@
 #ifndef VEHICLES_MAP_CONTROLLER_H
 #define VEHICLES_MAP_CONTROLLER_H
 
-#include "i_command_service.h"
+#include "command_pipeline.h"
 #include "i_property_tree.h"
 #include "i_vehicles_service.h"
+#include "telemetry_rate_service.h"
 
 #include <QJsonArray>
 
@@ -34,6 +35,8 @@ public:
 public slots:
     void selectVehicle(const QVariant& vehicleId);
     void sendCommand(const QVariant& vehicleId, const QString& commandId, const QVariantList& args);
+    void broadcastCommand(const QVariantList& vehicleIds, const QString& commandId,
+                          const QVariantList& args);
 
     void setTracking(bool tracking);
 
@@ -51,7 +54,8 @@ signals:
 private:
     domain::IVehiclesService* const m_vehicles;
     domain::IPropertyTree* const m_pTree;
-    domain::ICommandsService* const m_commands;
+    domain::CommandPipeline* const m_commands;
+    domain::TelemetryRateService* const m_rates;
 
     QVariant m_selectedVehicleId;
     bool m_tracking = false;
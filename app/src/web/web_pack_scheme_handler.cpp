@@ -0,0 +1,174 @@
+#include "web_pack_scheme_handler.h"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QWebEngineUrlRequestJob>
+#include <QWebEngineUrlScheme>
+#include <QtEndian>
+
+namespace
+{
+constexpr char packMagic[] = "DRKPACK1";
+constexpr int packMagicSize = sizeof(packMagic) - 1;
+
+class PackReader
+{
+public:
+    PackReader(const uchar* data, qint64 size) : m_data(data), m_size(size)
+    {
+    }
+
+    bool isValid() const
+    {
+        return m_valid;
+    }
+
+    template<typename T>
+    T read()
+    {
+        if (!this->canRead(sizeof(T)))
+            return T();
+
+        T value = qFromLittleEndian<T>(m_data + m_pos);
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    QByteArray readBytes(int length)
+    {
+        if (!this->canRead(length))
+            return QByteArray();
+
+        QByteArray bytes(reinterpret_cast<const char*>(m_data + m_pos), length);
+        m_pos += length;
+        return bytes;
+    }
+
+private:
+    bool canRead(qint64 length)
+    {
+        if (m_pos + length > m_size)
+            m_valid = false;
+        return m_valid;
+    }
+
+    const uchar* const m_data;
+    const qint64 m_size;
+    qint64 m_pos = packMagicSize;
+    bool m_valid = true;
+};
+} // namespace
+
+using namespace md::app;
+
+void WebPackSchemeHandler::registerScheme()
+{
+    QWebEngineUrlScheme webScheme(scheme);
+    webScheme.setSyntax(QWebEngineUrlScheme::Syntax::Host);
+    QWebEngineUrlScheme::Flags flags = QWebEngineUrlScheme::SecureScheme |
+                                       QWebEngineUrlScheme::LocalScheme |
+                                       QWebEngineUrlScheme::LocalAccessAllowed;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // Cesium loads assets and workers with XHR, Chromium allows it only for CORS schemes
+    flags |= QWebEngineUrlScheme::CorsEnabled;
+#endif
+    webScheme.setFlags(flags);
+    QWebEngineUrlScheme::registerScheme(webScheme);
+}
+
+WebPackSchemeHandler::WebPackSchemeHandler(const QString& packPath, QObject* parent) :
+    QWebEngineUrlSchemeHandler(parent),
+    m_file(packPath)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    if (!this->open())
+    {
+        qWarning() << "Web pack is not available:" << packPath;
+        m_entries.clear();
+    }
+#else
+    // Without CORS on the scheme the map can't fetch its assets, plain files are used instead
+    qInfo() << "Web pack needs Qt 5.14 or newer, serving web from files";
+#endif
+}
+
+WebPackSchemeHandler::~WebPackSchemeHandler()
+{
+    if (m_data)
+        m_file.unmap(m_data);
+}
+
+bool WebPackSchemeHandler::isOpen() const
+{
+    return !m_entries.isEmpty();
+}
+
+QUrl WebPackSchemeHandler::url(const QString& path) const
+{
+    QUrl url;
+    url.setScheme(scheme);
+    url.setHost(host);
+    url.setPath('/' + path);
+    return url;
+}
+
+QByteArray WebPackSchemeHandler::data(const QString& path) const
+{
+    auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd())
+        return QByteArray();
+
+    return QByteArray::fromRawData(it->data, it->size);
+}
+
+void WebPackSchemeHandler::requestStarted(QWebEngineUrlRequestJob* job)
+{
+    const QString path = job->requestUrl().path().mid(1);
+    auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd())
+    {
+        job->fail(QWebEngineUrlRequestJob::UrlNotFound);
+        return;
+    }
+
+    // Raw data keeps pointing into the mapped pack, no copy is made
+    auto buffer = new QBuffer(job);
+    buffer->setData(QByteArray::fromRawData(it->data, it->size));
+    buffer->open(QIODevice::ReadOnly);
+
+    job->reply(it->mimeType, buffer);
+}
+
+bool WebPackSchemeHandler::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = m_file.size();
+    if (size < packMagicSize)
+        return false;
+
+    m_data = m_file.map(0, size);
+    if (!m_data || qstrncmp(reinterpret_cast<const char*>(m_data), ::packMagic, packMagicSize))
+        return false;
+
+    PackReader reader(m_data, size);
+    const quint32 count = reader.read<quint32>();
+    m_entries.reserve(count);
+
+    for (quint32 i = 0; i < count && reader.isValid(); ++i)
+    {
+        const QString path = QString::fromUtf8(reader.readBytes(reader.read<quint16>()));
+        const QByteArray mimeType = reader.readBytes(reader.read<quint16>());
+        const quint64 offset = reader.read<quint64>();
+        const quint64 length = reader.read<quint64>();
+
+        if (offset + length > quint64(size))
+            return false;
+
+        m_entries.insert(path, { mimeType, reinterpret_cast<const char*>(m_data + offset),
+                                 qint64(length) });
+    }
+
+    return reader.isValid();
+}
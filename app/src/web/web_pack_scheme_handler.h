@@ -0,0 +1,48 @@
+#ifndef WEB_PACK_SCHEME_HANDLER_H
+#define WEB_PACK_SCHEME_HANDLER_H
+
+#include <QFile>
+#include <QHash>
+#include <QWebEngineUrlSchemeHandler>
+
+namespace md::app
+{
+// Serves web assets from a single memory-mapped pack file, see scripts/webpackgen.py
+class WebPackSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+    Q_OBJECT
+
+public:
+    static constexpr char scheme[] = "dreka";
+    static constexpr char host[] = "app";
+
+    // Must be called before QGuiApplication construction
+    static void registerScheme();
+
+    explicit WebPackSchemeHandler(const QString& packPath, QObject* parent = nullptr);
+    ~WebPackSchemeHandler() override;
+
+    bool isOpen() const;
+    QUrl url(const QString& path) const;
+    // Points into the mapped pack, empty if there is no such entry
+    QByteArray data(const QString& path) const;
+
+    void requestStarted(QWebEngineUrlRequestJob* job) override;
+
+private:
+    bool open();
+
+    struct Entry
+    {
+        QByteArray mimeType;
+        const char* data;
+        qint64 size;
+    };
+
+    QFile m_file;
+    uchar* m_data = nullptr;
+    QHash<QString, Entry> m_entries;
+};
+} // namespace md::app
+
+#endif // WEB_PACK_SCHEME_HANDLER_H
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+#include <QtMath>
+
+#include "airspace_index.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int volumeCount = 20000;
+constexpr int queryCount = 10000;
+
+// Irregular star shaped polygons, several kilometers across, over a 10 by 10 degrees area
+QVector<AirspaceVolume> randomVolumes(QRandomGenerator& random, int count)
+{
+    QVector<AirspaceVolume> volumes;
+    volumes.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        AirspaceVolume volume;
+        volume.id = QString::number(i);
+        volume.inclusion = random.bounded(2);
+        volume.floor = random.bounded(3000);
+        volume.ceiling = volume.floor + random.bounded(100, 5000);
+
+        const double centerX = 30 + random.generateDouble() * 10;
+        const double centerY = 50 + random.generateDouble() * 10;
+        const int vertices = random.bounded(3, 16);
+        for (int vertex = 0; vertex < vertices; ++vertex)
+        {
+            const double angle = 2 * M_PI * vertex / vertices;
+            const double radius = 0.01 + random.generateDouble() * 0.2;
+            volume.boundary.append(
+                QPointF(centerX + radius * qCos(angle), centerY + radius * qSin(angle)));
+        }
+        volumes.append(volume);
+    }
+    return volumes;
+}
+
+// Plain crossing number over every volume, written independently of the index
+QVector<int> bruteForce(const QVector<AirspaceVolume>& volumes, double latitude,
+                        double longitude, double altitude)
+{
+    QVector<int> result;
+    for (int i = 0; i < volumes.count(); ++i)
+    {
+        const AirspaceVolume& volume = volumes.at(i);
+        if (altitude < volume.floor || altitude > volume.ceiling)
+            continue;
+
+        bool inside = false;
+        const QVector<QPointF>& ring = volume.boundary;
+        for (int j = 0, k = ring.count() - 1; j < ring.count(); k = j++)
+        {
+            if ((ring.at(j).y() > latitude) != (ring.at(k).y() > latitude) &&
+                longitude < (ring.at(k).x() - ring.at(j).x()) * (latitude - ring.at(j).y()) /
+                                    (ring.at(k).y() - ring.at(j).y()) +
+                                ring.at(j).x())
+            {
+                inside = !inside;
+            }
+        }
+        if (inside)
+            result.append(i);
+    }
+    return result;
+}
+} // namespace
+
+TEST(AirspaceIndexTest, testEmpty)
+{
+    AirspaceIndex index;
+    index.build({});
+
+    EXPECT_EQ(index.count(), 0);
+    EXPECT_TRUE(index.query(55, 37, 100).isEmpty());
+}
+
+TEST(AirspaceIndexTest, testAgainstBruteForce)
+{
+    QRandomGenerator random(42);
+    const QVector<AirspaceVolume> volumes = ::randomVolumes(random, ::volumeCount);
+
+    AirspaceIndex index;
+    index.build(volumes);
+    ASSERT_EQ(index.count(), ::volumeCount);
+
+    QVector<double> latitudes, longitudes, altitudes;
+    for (int i = 0; i < ::queryCount; ++i)
+    {
+        latitudes.append(50 + random.generateDouble() * 10);
+        longitudes.append(30 + random.generateDouble() * 10);
+        altitudes.append(random.bounded(8000));
+    }
+
+    int hits = 0;
+    for (int i = 0; i < ::queryCount; ++i)
+    {
+        const QVector<int> expected = ::bruteForce(volumes, latitudes.at(i), longitudes.at(i),
+                                                   altitudes.at(i));
+        ASSERT_EQ(index.query(latitudes.at(i), longitudes.at(i), altitudes.at(i)), expected)
+            << "query " << i;
+        hits += expected.count();
+    }
+    EXPECT_GT(hits, 0);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "airspace_service.h"
+#include "property_tree.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr char vehicleNode[] = "vehicle_1";
+
+// Field to fly in, a tower to keep away from and a corridor closed between 200 and 400 meters
+constexpr char airspaces[] = R"({ "volumes": [
+    { "id": "field", "inclusion": true, "floor": 0, "ceiling": 500, "boundary": [
+        { "latitude": 55.0, "longitude": 37.0 }, { "latitude": 55.0, "longitude": 37.1 },
+        { "latitude": 55.1, "longitude": 37.1 }, { "latitude": 55.1, "longitude": 37.0 } ] },
+    { "id": "tower", "boundary": [
+        { "latitude": 55.04, "longitude": 37.04 }, { "latitude": 55.04, "longitude": 37.06 },
+        { "latitude": 55.06, "longitude": 37.06 }, { "latitude": 55.06, "longitude": 37.04 } ] },
+    { "id": "corridor", "floor": 200, "ceiling": 400, "boundary": [
+        { "latitude": 55.07, "longitude": 37.0 }, { "latitude": 55.07, "longitude": 37.1 },
+        { "latitude": 55.09, "longitude": 37.1 }, { "latitude": 55.09, "longitude": 37.0 } ] }
+] })";
+} // namespace
+
+class AirspaceServiceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        path = dir.filePath("airspaces.json");
+
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(::airspaces);
+        file.close();
+
+        service.reset(new AirspaceService(&pTree, &traffic, path));
+        ASSERT_EQ(service->index().count(), 3);
+    }
+
+    // Airspaces and breach the service published for the vehicle at the position
+    QPair<QStringList, bool> fly(double latitude, double longitude, double altitude)
+    {
+        pTree.appendProperties(::vehicleNode, { { "latitude", latitude },
+                                                { "longitude", longitude },
+                                                { "altitudeAmsl", altitude } });
+        const QVariantMap properties = pTree.properties(::vehicleNode);
+        QStringList airspaces = properties.value("airspaces").toStringList();
+        airspaces.sort();
+        return { airspaces, properties.value("geofenceBreach").toBool() };
+    }
+
+    qint64 now = 0;
+    TimerWheel timers{ [this]() {
+        return now;
+    } };
+    TrafficService traffic{ &timers };
+    PropertyTree pTree;
+    QTemporaryDir dir;
+    QString path;
+    QScopedPointer<AirspaceService> service;
+};
+
+TEST_F(AirspaceServiceTest, testInsideInclusion)
+{
+    const auto result = fly(55.02, 37.02, 100);
+    EXPECT_EQ(result.first, QStringList({ "field" }));
+    EXPECT_FALSE(result.second);
+}
+
+TEST_F(AirspaceServiceTest, testExclusionInsideInclusion)
+{
+    const auto result = fly(55.05, 37.05, 100);
+    EXPECT_EQ(result.first, QStringList({ "field", "tower" }));
+    EXPECT_TRUE(result.second);
+
+    // Leaving the exclusion clears the breach
+    EXPECT_FALSE(fly(55.03, 37.05, 100).second);
+}
+
+TEST_F(AirspaceServiceTest, testOutsideEveryInclusion)
+{
+    const auto result = fly(55.2, 37.05, 100);
+    EXPECT_TRUE(result.first.isEmpty());
+    EXPECT_TRUE(result.second);
+}
+
+TEST_F(AirspaceServiceTest, testFloorAndCeiling)
+{
+    // Under the corridor, in it, over it and over the field ceiling
+    EXPECT_FALSE(fly(55.08, 37.05, 199).second);
+    EXPECT_EQ(fly(55.08, 37.05, 200), qMakePair(QStringList({ "corridor", "field" }), true));
+    EXPECT_TRUE(fly(55.08, 37.05, 400).second);
+    EXPECT_EQ(fly(55.08, 37.05, 401), qMakePair(QStringList({ "field" }), false));
+    EXPECT_EQ(fly(55.08, 37.05, 501), qMakePair(QStringList(), true));
+}
+
+TEST_F(AirspaceServiceTest, testNoInclusions)
+{
+    // Without inclusions only exclusions are breached
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(::airspaces).replace(R"("inclusion": true)", R"("inclusion": false)"));
+    file.close();
+    service->load(path);
+
+    EXPECT_EQ(fly(55.2, 37.05, 100), qMakePair(QStringList(), false));
+    EXPECT_TRUE(fly(55.02, 37.02, 100).second);
+}
+
+TEST_F(AirspaceServiceTest, testTrafficChangesOnly)
+{
+    QSignalSpy changed(service.data(), &AirspaceService::airspacesChanged);
+    const QVariantMap inTower({ { "code", "A1B2C3" },
+                                { "position", QVariantMap({ { "latitude", 55.05 },
+                                                            { "longitude", 37.05 },
+                                                            { "altitude", 250 } }) } });
+
+    traffic.updateTraffic({ inTower });
+    ASSERT_EQ(changed.count(), 1);
+    EXPECT_EQ(changed.at(0).at(0).toString(), "A1B2C3");
+    EXPECT_TRUE(changed.at(0).at(2).toBool());
+
+    // The same airspaces are not reported again
+    traffic.updateTraffic({ inTower });
+    EXPECT_EQ(changed.count(), 1);
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+#include "command_pipeline.h"
+#include "command_service.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr char commandId[] = "arm";
+
+// MAV_RESULT values of COMMAND_ACK
+constexpr int mavResultAccepted = 0;
+constexpr int mavResultDenied = 2;
+constexpr int mavResultInProgress = 5;
+} // namespace
+
+class CommandPipelineTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        QObject::connect(commands.requestCommand(::commandId), &Command::exec,
+                         [this](const QVariant& vehicleId, const QVariantList& args) {
+                             sent.append({ vehicleId, args });
+                         });
+        pipeline.setAckTracking(true);
+    }
+
+    // Runs the wheel tick by tick, as its own timer would
+    void advance(qint64 msec)
+    {
+        const qint64 until = now + msec;
+        while (now < until)
+        {
+            now += TimerWheel::tickInterval;
+            timers.process();
+        }
+    }
+
+    int sentTo(const QVariant& vehicleId) const
+    {
+        int count = 0;
+        for (const auto& command : sent)
+        {
+            if (command.first == vehicleId)
+                count++;
+        }
+        return count;
+    }
+
+    qint64 now = 0;
+    TimerWheel timers{ [this]() {
+        return now;
+    } };
+    CommandsService commands;
+    CommandPipeline pipeline{ &commands, &timers };
+    QVector<QPair<QVariant, QVariantList>> sent;
+};
+
+TEST_F(CommandPipelineTest, testAccepted)
+{
+    QSignalSpy finished(&pipeline, &CommandPipeline::finished);
+    const int handle = pipeline.send(1, ::commandId, { 1 });
+    ASSERT_EQ(sent.count(), 1);
+    EXPECT_EQ(sent.at(0).second, QVariantList({ 1 }));
+    EXPECT_TRUE(pipeline.isPending(handle));
+
+    pipeline.acknowledge(1, ::commandId, ::mavResultAccepted);
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(0).toInt(), handle);
+    EXPECT_TRUE(finished.at(0).at(1).toBool());
+    EXPECT_EQ(finished.at(0).at(2).toMap().value("1").toInt(), CommandPipeline::Accepted);
+    EXPECT_FALSE(pipeline.isPending(handle));
+
+    // Nothing is resent once acked
+    advance(CommandPipeline::maxAttempts * CommandPipeline::ackTimeout);
+    EXPECT_EQ(sent.count(), 1);
+    EXPECT_EQ(timers.count(), 0);
+}
+
+TEST_F(CommandPipelineTest, testRetryUntilAck)
+{
+    QSignalSpy finished(&pipeline, &CommandPipeline::finished);
+    pipeline.send(1, ::commandId, {});
+
+    advance(CommandPipeline::ackTimeout - TimerWheel::tickInterval);
+    EXPECT_EQ(sent.count(), 1);
+
+    // A lost command is sent again after the ack timeout
+    advance(2 * TimerWheel::tickInterval);
+    EXPECT_EQ(sent.count(), 2);
+    EXPECT_EQ(finished.count(), 0);
+
+    pipeline.acknowledge(1, ::commandId, ::mavResultAccepted);
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_TRUE(finished.at(0).at(1).toBool());
+}
+
+TEST_F(CommandPipelineTest, testTimeoutAfterMaxAttempts)
+{
+    QSignalSpy finished(&pipeline, &CommandPipeline::finished);
+    const int handle = pipeline.send(1, ::commandId, {});
+
+    for (int attempt = 1; attempt < CommandPipeline::maxAttempts; ++attempt)
+    {
+        advance(CommandPipeline::ackTimeout + TimerWheel::tickInterval);
+        EXPECT_EQ(sent.count(), attempt + 1);
+    }
+    EXPECT_EQ(finished.count(), 0);
+
+    advance(CommandPipeline::ackTimeout + TimerWheel::tickInterval);
+    EXPECT_EQ(sent.count(), CommandPipeline::maxAttempts);
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_FALSE(finished.at(0).at(1).toBool());
+    EXPECT_EQ(finished.at(0).at(2).toMap().value("1").toInt(), CommandPipeline::Timeout);
+    EXPECT_FALSE(pipeline.isPending(handle));
+
+    // A late ack is ignored
+    pipeline.acknowledge(1, ::commandId, ::mavResultAccepted);
+    EXPECT_EQ(finished.count(), 1);
+}
+
+TEST_F(CommandPipelineTest, testInProgressExtendsTimeout)
+{
+    QSignalSpy finished(&pipeline, &CommandPipeline::finished);
+    pipeline.send(1, ::commandId, {});
+
+    advance(CommandPipeline::ackTimeout - TimerWheel::tickInterval);
+    pipeline.acknowledge(1, ::commandId, ::mavResultInProgress);
+
+    // No resend while the vehicle reports progress
+    advance(CommandPipeline::inProgressTimeout - TimerWheel::tickInterval);
+    EXPECT_EQ(sent.count(), 1);
+    EXPECT_EQ(finished.count(), 0);
+
+    pipeline.acknowledge(1, ::commandId, ::mavResultInProgress);
+    advance(CommandPipeline::inProgressTimeout - TimerWheel::tickInterval);
+    EXPECT_EQ(sent.count(), 1);
+
+    // Silence after progress is a lost ack again
+    advance(2 * TimerWheel::tickInterval);
+    EXPECT_EQ(sent.count(), 2);
+
+    pipeline.acknowledge(1, ::commandId, ::mavResultAccepted);
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_TRUE(finished.at(0).at(1).toBool());
+}
+
+TEST_F(CommandPipelineTest, testNewerCommandSupersedes)
+{
+    QSignalSpy finished(&pipeline, &CommandPipeline::finished);
+    const int first = pipeline.send(1, ::commandId, { 1 });
+    advance(CommandPipeline::ackTimeout / 2);
+    const int second = pipeline.send(1, ::commandId, { 2 });
+
+    // The older one ends at once, the ack belongs to the newer one
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(0).toInt(), first);
+    EXPECT_EQ(finished.at(0).at(2).toMap().value("1").toInt(), CommandPipeline::Canceled);
+
+    pipeline.acknowledge(1, ::commandId, ::mavResultAccepted);
+    ASSERT_EQ(finished.count(), 2);
+    EXPECT_EQ(finished.at(1).at(0).toInt(), second);
+    EXPECT_TRUE(finished.at(1).at(1).toBool());
+
+    // The superseded timer does not resend anything
+    advance(CommandPipeline::maxAttempts * CommandPipeline::ackTimeout);
+    ASSERT_EQ(sent.count(), 2);
+    EXPECT_EQ(sent.at(1).second, QVariantList({ 2 }));
+}
+
+TEST_F(CommandPipelineTest, testBroadcastWaitsForEveryVehicle)
+{
+    QSignalSpy finished(&pipeline, &CommandPipeline::finished);
+    pipeline.broadcast({ 1, 2, 3 }, ::commandId, {});
+    ASSERT_EQ(sent.count(), 3);
+
+    pipeline.acknowledge(1, ::commandId, ::mavResultAccepted);
+    pipeline.acknowledge(2, ::commandId, ::mavResultDenied);
+    EXPECT_EQ(finished.count(), 0);
+
+    // Only the silent vehicle is retried
+    advance(CommandPipeline::maxAttempts * CommandPipeline::ackTimeout + TimerWheel::tickInterval);
+    EXPECT_EQ(sentTo(1), 1);
+    EXPECT_EQ(sentTo(2), 1);
+    EXPECT_EQ(sentTo(3), CommandPipeline::maxAttempts);
+
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_FALSE(finished.at(0).at(1).toBool());
+    const QVariantMap results = finished.at(0).at(2).toMap();
+    EXPECT_EQ(results.value("1").toInt(), CommandPipeline::Accepted);
+    EXPECT_EQ(results.value("2").toInt(), CommandPipeline::Rejected);
+    EXPECT_EQ(results.value("3").toInt(), CommandPipeline::Timeout);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtMath>
+
+#include "conflict_detector.h"
+#include "geodesy_kernels.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int ownCount = 20;
+constexpr int trafficCount = 5000;
+
+// Dense traffic over a 300 km square, own vehicles in the middle of it
+void randomScene(QRandomGenerator& random, QVector<OwnState>& own,
+                 QVector<TrafficState>& traffic)
+{
+    for (int i = 0; i < ::ownCount; ++i)
+    {
+        OwnState vehicle;
+        vehicle.id = QString::number(i);
+        vehicle.latitude = 55 + random.generateDouble() * 0.5;
+        vehicle.longitude = 37 + random.generateDouble() * 0.5;
+        vehicle.altitude = 500 + random.bounded(1000);
+        vehicle.groundSpeed = 20 + random.bounded(30);
+        vehicle.course = random.bounded(360);
+        own.append(vehicle);
+    }
+
+    for (int i = 0; i < ::trafficCount; ++i)
+    {
+        TrafficState target;
+        target.code = QString::number(100000 + i);
+        target.latitude = 53.8 + random.generateDouble() * 2.7;
+        target.longitude = 35 + random.generateDouble() * 4.5;
+        target.altitude = random.bounded(2000);
+        target.heading = random.bounded(360);
+        target.groundSpeed = 50 + random.bounded(200);
+        target.verticalSpeed = random.bounded(-10, 10);
+        traffic.append(target);
+    }
+}
+
+// Every pair with the same closest point of approach, without the spatial hash
+QVector<QStringList> bruteForce(const QVector<OwnState>& own,
+                                const QVector<TrafficState>& traffic,
+                                const ConflictParameters& parameters)
+{
+    QVector<QStringList> result;
+    for (const OwnState& vehicle : own)
+    {
+        QStringList codes;
+        const double course = qDegreesToRadians(vehicle.course);
+        for (const TrafficState& target : traffic)
+        {
+            double east, north, up;
+            const double altitude = target.altitude;
+            geodesy::toEnu(Geodetic(vehicle.latitude, vehicle.longitude, vehicle.altitude),
+                           &target.latitude, &target.longitude, &altitude, &east, &north, &up,
+                           1);
+
+            const double heading = qDegreesToRadians(target.heading);
+            const double vEast = target.groundSpeed * qSin(heading) -
+                                 vehicle.groundSpeed * qSin(course);
+            const double vNorth = target.groundSpeed * qCos(heading) -
+                                  vehicle.groundSpeed * qCos(course);
+            const double vUp = target.verticalSpeed - vehicle.verticalSpeed;
+
+            const double closing = vEast * vEast + vNorth * vNorth;
+            const double t = closing > 0 ? -(east * vEast + north * vNorth) / closing : 0;
+            const double tcpa = qBound(0.0, t, parameters.horizon);
+            if (qHypot(east + vEast * tcpa, north + vNorth * tcpa) <
+                    parameters.horizontalSeparation &&
+                qAbs(up + vUp * tcpa) < parameters.verticalSeparation)
+                codes.append(target.code);
+        }
+        codes.sort();
+        result.append(codes);
+    }
+    return result;
+}
+
+// Returns the number of conflicts, all of them must match the brute force ones
+int expectBruteForce(const QVector<OwnState>& own, const QVector<TrafficState>& traffic,
+                     const ConflictParameters& parameters)
+{
+    const QVector<QVector<Conflict>> conflicts = ConflictDetector::detect(own, traffic,
+                                                                          parameters);
+    const QVector<QStringList> expected = ::bruteForce(own, traffic, parameters);
+
+    int total = 0;
+    for (int i = 0; i < own.count(); ++i)
+    {
+        QStringList codes;
+        for (const Conflict& conflict : conflicts.at(i))
+        {
+            codes.append(conflict.code);
+        }
+        codes.sort();
+        EXPECT_EQ(codes, expected.at(i)) << "vehicle " << i;
+        total += codes.count();
+    }
+    return total;
+}
+} // namespace
+
+TEST(ConflictDetectorTest, testHeadOn)
+{
+    OwnState vehicle;
+    vehicle.id = "own";
+    vehicle.latitude = 55;
+    vehicle.longitude = 37;
+    vehicle.altitude = 500;
+    vehicle.groundSpeed = 50;
+    vehicle.course = 0;
+
+    // 5 km to the north, flying south at the same altitude
+    TrafficState target;
+    target.code = "target";
+    target.latitude = 55 + 5000 / (geodesy::meanRadius * M_PI / 180);
+    target.longitude = 37;
+    target.altitude = 500;
+    target.heading = 180;
+    target.groundSpeed = 50;
+
+    const QVector<QVector<Conflict>> conflicts = ConflictDetector::detect({ vehicle }, { target },
+                                                                          ConflictParameters());
+    ASSERT_EQ(conflicts.count(), 1);
+    ASSERT_EQ(conflicts.first().count(), 1);
+    EXPECT_NEAR(conflicts.first().first().timeToCpa, 50, 0.5);
+    EXPECT_NEAR(conflicts.first().first().horizontalDistance, 0, 1);
+}
+
+TEST(ConflictDetectorTest, testWideLatitudes)
+{
+    QRandomGenerator random(34);
+    const double metersPerDegree = geodesy::meanRadius * M_PI / 180;
+    QVector<OwnState> own;
+    QVector<TrafficState> traffic;
+
+    // Far from the mean latitude, converging targets up to the edge of the search radius
+    for (const double latitude : { 40.0, 65.0, 10.0, 75.0 })
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            OwnState vehicle;
+            vehicle.id = QString::number(own.count());
+            vehicle.latitude = latitude + random.generateDouble() * 0.2;
+            vehicle.longitude = 20 + random.generateDouble() * 0.2;
+            vehicle.altitude = 1000;
+            vehicle.groundSpeed = 50;
+            vehicle.course = random.bounded(360);
+            own.append(vehicle);
+
+            for (int j = 0; j < 40; ++j)
+            {
+                const double bearing = qDegreesToRadians(double(random.bounded(360)));
+                const double distance = 20000 + random.bounded(25000);
+                TrafficState target;
+                target.code = QString::number(100000 + traffic.count());
+                target.latitude = vehicle.latitude +
+                                  distance * qCos(bearing) / metersPerDegree;
+                target.longitude = vehicle.longitude +
+                                   distance * qSin(bearing) /
+                                       (metersPerDegree * qCos(qDegreesToRadians(latitude)));
+                target.altitude = 1000 + random.bounded(-100, 100);
+                target.heading = qRadiansToDegrees(bearing) + 180 + random.bounded(-3, 3);
+                target.groundSpeed = 250 + random.bounded(50);
+                traffic.append(target);
+            }
+        }
+    }
+
+    EXPECT_GT(::expectBruteForce(own, traffic, ConflictParameters()), 100);
+}
+
+TEST(ConflictDetectorTest, testDenseTraffic)
+{
+    QRandomGenerator random(42);
+    QVector<OwnState> own;
+    QVector<TrafficState> traffic;
+    ::randomScene(random, own, traffic);
+
+    EXPECT_GT(::expectBruteForce(own, traffic, ConflictParameters()), 0);
+}
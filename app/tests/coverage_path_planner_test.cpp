@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <QtMath>
+
+#include "coverage_path_planner.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr double tolerance = 1e-3;
+constexpr double sampleStep = 5;
+
+double distanceToSegment(const QPointF& point, const QPointF& a, const QPointF& b)
+{
+    const QPointF ab = b - a;
+    const double lengthSquared = QPointF::dotProduct(ab, ab);
+    const double t = lengthSquared > 0
+                         ? qBound(0.0, QPointF::dotProduct(point - a, ab) / lengthSquared, 1.0)
+                         : 0.0;
+    const QPointF delta = point - (a + ab * t);
+    return qSqrt(QPointF::dotProduct(delta, delta));
+}
+
+double distanceToRing(const QPointF& point, const QPolygonF& ring)
+{
+    double distance = std::numeric_limits<double>::max();
+    for (int i = 0; i < ring.count(); ++i)
+    {
+        distance = qMin(distance,
+                        ::distanceToSegment(point, ring.at(i), ring.at((i + 1) % ring.count())));
+    }
+    return distance;
+}
+
+// Points along the path stay in the area and out of the holes, edges may be followed
+void expectInside(const QPolygonF& path, const QPolygonF& area, const QVector<QPolygonF>& holes)
+{
+    for (int i = 0; i + 1 < path.count(); ++i)
+    {
+        const QPointF a = path.at(i);
+        const QPointF b = path.at(i + 1);
+        const int samples = qMax(1, qCeil(::distanceToSegment(a, b, b) / ::sampleStep));
+        for (int s = 0; s <= samples; ++s)
+        {
+            const QPointF point = a + (b - a) * (double(s) / samples);
+            ASSERT_TRUE(area.containsPoint(point, Qt::OddEvenFill) ||
+                        ::distanceToRing(point, area) < ::tolerance)
+                << "segment " << i << " leaves the area at " << point.x() << ", " << point.y();
+
+            for (const QPolygonF& hole : holes)
+            {
+                ASSERT_FALSE(hole.containsPoint(point, Qt::OddEvenFill) &&
+                             ::distanceToRing(point, hole) > ::tolerance)
+                    << "segment " << i << " crosses a hole at " << point.x() << ", " << point.y();
+            }
+        }
+    }
+}
+
+// Points a spacing away from the edges are within half of it from a lane, nearer ones depend on
+// the edge angle
+void expectCovered(const QPolygonF& path, const QPolygonF& area, const QVector<QPolygonF>& holes,
+                   double spacing)
+{
+    const QRectF bounds = area.boundingRect();
+    for (double x = bounds.left(); x <= bounds.right(); x += spacing / 2)
+    {
+        for (double y = bounds.top(); y <= bounds.bottom(); y += spacing / 2)
+        {
+            const QPointF point(x, y);
+            if (!area.containsPoint(point, Qt::OddEvenFill) ||
+                ::distanceToRing(point, area) < spacing)
+                continue;
+
+            bool nearHole = false;
+            for (const QPolygonF& hole : holes)
+            {
+                nearHole |= hole.containsPoint(point, Qt::OddEvenFill) ||
+                            ::distanceToRing(point, hole) < spacing;
+            }
+            if (nearHole)
+                continue;
+
+            double distance = std::numeric_limits<double>::max();
+            for (int i = 0; i + 1 < path.count(); ++i)
+            {
+                distance = qMin(distance, ::distanceToSegment(point, path.at(i), path.at(i + 1)));
+            }
+            ASSERT_LE(distance, spacing / 2 + ::tolerance)
+                << "not covered at " << point.x() << ", " << point.y();
+        }
+    }
+}
+} // namespace
+
+TEST(CoveragePathPlannerTest, testConvexAreaLanes)
+{
+    const QPolygonF square(
+        QVector<QPointF>{ { 0, 0 }, { 1000, 0 }, { 1000, 1000 }, { 0, 1000 } });
+    CoverageParameters parameters;
+    parameters.spacing = 100;
+
+    const QPolygonF path = CoveragePathPlanner(square).plan(parameters, QPointF(0, 0));
+
+    // Entry and exit of every lane
+    EXPECT_EQ(path.count() % 2, 0);
+    EXPECT_GE(path.count(), 18);
+    for (const QPointF& point : path)
+    {
+        EXPECT_TRUE(square.boundingRect().adjusted(-1, -1, 1, 1).contains(point));
+    }
+}
+
+TEST(CoveragePathPlannerTest, testConcaveArea)
+{
+    // U shape, lanes across the notch split into cells on both arms
+    const QPolygonF area(QVector<QPointF>{ { 0, 0 },
+                                           { 3000, 0 },
+                                           { 3000, 3000 },
+                                           { 2000, 3000 },
+                                           { 2000, 1000 },
+                                           { 1000, 1000 },
+                                           { 1000, 3000 },
+                                           { 0, 3000 } });
+    CoverageParameters parameters;
+    parameters.spacing = 100;
+
+    for (double heading : { 0.0, 30.0, 90.0, 135.0 })
+    {
+        SCOPED_TRACE(heading);
+        parameters.heading = heading;
+
+        const QPolygonF path = CoveragePathPlanner(area).plan(parameters, QPointF(0, 0));
+        ASSERT_FALSE(path.isEmpty());
+        ::expectInside(path, area, {});
+        ::expectCovered(path, area, {}, parameters.spacing);
+    }
+}
+
+TEST(CoveragePathPlannerTest, testHoles)
+{
+    const QPolygonF area(
+        QVector<QPointF>{ { 0, 0 }, { 3000, 0 }, { 3000, 3000 }, { 0, 3000 } });
+    const QVector<QPolygonF> holes = {
+        QPolygonF(QVector<QPointF>{ { 800, 800 }, { 1400, 800 }, { 1400, 1400 }, { 800, 1400 } }),
+        QPolygonF(QVector<QPointF>{ { 1800, 1500 }, { 2600, 2000 }, { 1900, 2600 } })
+    };
+    CoverageParameters parameters;
+    parameters.spacing = 100;
+
+    for (double heading : { 0.0, 45.0, 90.0, 160.0 })
+    {
+        SCOPED_TRACE(heading);
+        parameters.heading = heading;
+
+        const QPolygonF path = CoveragePathPlanner(area, holes).plan(parameters, QPointF(0, 0));
+        ASSERT_FALSE(path.isEmpty());
+        ::expectInside(path, area, holes);
+        ::expectCovered(path, area, holes, parameters.spacing);
+    }
+}
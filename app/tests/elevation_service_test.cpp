@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include "elevation_service.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int tileSize = 1201;
+
+// Height grows linearly to the east and to the north, so interpolation is exact
+double expectedHeight(double latitude, double longitude)
+{
+    return (longitude - 37) * 2400 + (latitude - 55) * 1200;
+}
+} // namespace
+
+class ElevationServiceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+
+        QByteArray data(::tileSize * ::tileSize * 2, Qt::Uninitialized);
+        for (int row = 0; row < ::tileSize; ++row)
+        {
+            for (int column = 0; column < ::tileSize; ++column)
+            {
+                const qint16 sample = column * 2 + (::tileSize - 1 - row);
+                qToBigEndian(sample, data.data() + (row * ::tileSize + column) * 2);
+            }
+        }
+
+        QFile file(dir.filePath("N55E037.hgt"));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    QTemporaryDir dir;
+};
+
+TEST_F(ElevationServiceTest, testHeights)
+{
+    ElevationService service(dir.path());
+
+    EXPECT_NEAR(service.height(55.5, 37.25), ::expectedHeight(55.5, 37.25), 0.01);
+    EXPECT_NEAR(service.height(55.1, 37.9), ::expectedHeight(55.1, 37.9), 0.01);
+    EXPECT_TRUE(qIsNaN(service.height(10.5, 10.5)));
+}
+
+TEST_F(ElevationServiceTest, testBatchMatchesScalar)
+{
+    ElevationService service(dir.path());
+
+    const int count = 10000;
+    QVector<double> latitudes(count);
+    QVector<double> longitudes(count);
+    QRandomGenerator random(42);
+    for (int i = 0; i < count; ++i)
+    {
+        latitudes[i] = 55 + random.generateDouble();
+        longitudes[i] = 37 + random.generateDouble();
+    }
+    QVector<float> heights(count);
+    service.heights(latitudes.constData(), longitudes.constData(), heights.data(), count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_NEAR(heights.at(i), ::expectedHeight(latitudes.at(i), longitudes.at(i)), 0.01);
+        ASSERT_NEAR(heights.at(i), service.height(latitudes.at(i), longitudes.at(i)), 0.01);
+    }
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+
+#include "fenwick_tree.h"
+
+using namespace md::domain;
+
+namespace
+{
+void expectPrefixes(const FenwickTree<qint64>& tree, const QVector<qint64>& values)
+{
+    ASSERT_EQ(tree.count(), values.count());
+
+    qint64 sum = 0;
+    for (int i = 0; i <= values.count(); ++i)
+    {
+        ASSERT_EQ(tree.prefix(i), sum) << "prefix " << i;
+        if (i < values.count())
+            sum += values.at(i);
+    }
+}
+} // namespace
+
+TEST(FenwickTreeTest, testRandomEdits)
+{
+    QRandomGenerator random(42);
+    FenwickTree<qint64> tree;
+    QVector<qint64> values;
+
+    for (int step = 0; step < 2000; ++step)
+    {
+        const int action = random.bounded(4);
+        const qint64 value = random.bounded(1000);
+        if (action == 0 && !values.isEmpty())
+        {
+            tree.removeLast();
+            values.removeLast();
+        }
+        else if (action == 1 && !values.isEmpty())
+        {
+            const int index = random.bounded(values.count());
+            tree.set(index, value);
+            values[index] = value;
+        }
+        else
+        {
+            tree.append(value);
+            values.append(value);
+        }
+
+        if (step % 50 == 0)
+            ::expectPrefixes(tree, values);
+    }
+    ::expectPrefixes(tree, values);
+
+    FenwickTree<qint64> built;
+    built.build(values);
+    ::expectPrefixes(built, values);
+}
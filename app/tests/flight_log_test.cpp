@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFloat16>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "flight_log.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr quint32 globalPositionIntId = 33;
+constexpr quint8 gpsType = 130;
+constexpr int recordCount = 10;
+constexpr quint64 startUs = 1600000000000000;
+
+// Both MAVLink magic bytes in the payload, 55.52 degrees
+constexpr qint32 magicLatitude = 0x2117FEFD;
+
+// .tlog record of GLOBAL_POSITION_INT in a MAVLink v1 frame, the index does not check CRC
+QByteArray tlogRecord(int index)
+{
+    QByteArray payload(28, 0);
+    qToLittleEndian<quint32>(quint32(index * 100), payload.data());
+    qToLittleEndian<qint32>(::magicLatitude + index, payload.data() + 4);
+    qToLittleEndian<qint32>(370000000 + index, payload.data() + 8);
+    qToLittleEndian<qint32>(150000 + index * 1000, payload.data() + 12);
+    qToLittleEndian<quint16>(0xFFFF, payload.data() + 26);
+
+    QByteArray record(8, 0);
+    qToBigEndian<quint64>(::startUs + quint64(index) * 100000, record.data());
+    record.append(char(0xFE));
+    record.append(char(payload.size()));
+    record.append(char(index));
+    record.append(char(1));
+    record.append(char(1));
+    record.append(char(::globalPositionIntId));
+    record.append(payload);
+    record.append(QByteArray(2, 0));
+    return record;
+}
+
+QByteArray tlog(int count)
+{
+    QByteArray log;
+    for (int i = 0; i < count; ++i)
+    {
+        log.append(::tlogRecord(i));
+    }
+    return log;
+}
+
+void writeField(QByteArray& message, int offset, const char* text, int size)
+{
+    std::memcpy(message.data() + offset, text, qMin(size_t(size), qstrlen(text)));
+}
+
+// GPS format with a half float speed in the middle, so later fields depend on its size
+QByteArray dataFlashGpsFormat()
+{
+    QByteArray message(89, 0);
+    message[0] = char(0xA3);
+    message[1] = char(0x95);
+    message[2] = char(128);
+    message[3] = char(::gpsType);
+    message[4] = char(25);
+    ::writeField(message, 5, "GPS", 4);
+    ::writeField(message, 9, "QLLgf", 16);
+    ::writeField(message, 25, "TimeUS,Lat,Lng,Spd,Alt", 64);
+    return message;
+}
+
+QByteArray dataFlashGps(int index)
+{
+    QByteArray message(25, 0);
+    message[0] = char(0xA3);
+    message[1] = char(0x95);
+    message[2] = char(::gpsType);
+    qToLittleEndian<quint64>(::startUs + quint64(index) * 100000, message.data() + 3);
+    qToLittleEndian<qint32>(555000000 + index, message.data() + 11);
+    qToLittleEndian<qint32>(370000000 + index, message.data() + 15);
+
+    const qfloat16 speed(12.5f + index);
+    quint16 speedBits;
+    std::memcpy(&speedBits, &speed, sizeof(speedBits));
+    qToLittleEndian<quint16>(speedBits, message.data() + 19);
+
+    const float altitude = 150.5f + index;
+    quint32 altitudeBits;
+    std::memcpy(&altitudeBits, &altitude, sizeof(altitudeBits));
+    qToLittleEndian<quint32>(altitudeBits, message.data() + 21);
+    return message;
+}
+} // namespace
+
+class FlightLogTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        path = dir.filePath("flight.tlog");
+    }
+
+    void write(const QByteArray& data, const QDateTime& modified = QDateTime())
+    {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(data);
+        file.flush();
+        if (modified.isValid())
+            ASSERT_TRUE(file.setFileTime(modified, QFileDevice::FileModificationTime));
+    }
+
+    QTemporaryDir dir;
+    QString path;
+};
+
+TEST_F(FlightLogTest, testMagicBytesInPayload)
+{
+    write(::tlog(::recordCount));
+
+    FlightLog log(path);
+    ASSERT_TRUE(log.open());
+    ASSERT_EQ(log.index().format(), FlightLogIndex::Tlog);
+    EXPECT_EQ(log.index().messageCount(), ::recordCount);
+    EXPECT_EQ(log.duration(), (::recordCount - 1) * 100);
+
+    const FlightLogIndex::Series* series = log.index().series(::globalPositionIntId);
+    ASSERT_TRUE(series);
+    for (int i = 0; i < ::recordCount; ++i)
+    {
+        EXPECT_EQ(series->offsets.at(i), qint64(i) * ::tlogRecord(i).size() + 8);
+        EXPECT_EQ(series->times.at(i), i * 100);
+    }
+
+    const QVariantMap sample = log.sampleAt(450);
+    EXPECT_DOUBLE_EQ(sample.value("latitude").toDouble(), (::magicLatitude + 4) / 1e7);
+    EXPECT_DOUBLE_EQ(sample.value("altitudeAmsl").toDouble(), 154.0);
+}
+
+TEST_F(FlightLogTest, testTruncatedLastFrame)
+{
+    QByteArray data = ::tlog(::recordCount);
+    data.chop(5);
+    write(data);
+
+    FlightLog log(path);
+    ASSERT_TRUE(log.open());
+    EXPECT_EQ(log.index().messageCount(), ::recordCount - 1);
+    EXPECT_EQ(log.duration(), (::recordCount - 2) * 100);
+
+    // The end of the log shows the last complete frame
+    const QVariantMap sample = log.sampleAt(10000);
+    EXPECT_DOUBLE_EQ(sample.value("latitude").toDouble(),
+                     (::magicLatitude + ::recordCount - 2) / 1e7);
+}
+
+TEST_F(FlightLogTest, testDataFlashMessageBeforeFormat)
+{
+    path = dir.filePath("flight.bin");
+    write(::dataFlashGps(0) + ::dataFlashGpsFormat() + ::dataFlashGps(1) + ::dataFlashGps(2));
+
+    FlightLog log(path);
+    ASSERT_TRUE(log.open());
+    ASSERT_EQ(log.index().format(), FlightLogIndex::DataFlash);
+    EXPECT_EQ(log.index().dataFlashType("GPS"), quint32(::gpsType));
+
+    // Nothing tells the length of a message before its FMT, it is skipped
+    const FlightLogIndex::Series* series = log.index().series(::gpsType);
+    ASSERT_TRUE(series);
+    ASSERT_EQ(series->offsets.count(), 2);
+    EXPECT_EQ(series->offsets.at(0), ::dataFlashGps(0).size() + ::dataFlashGpsFormat().size());
+    EXPECT_EQ(log.duration(), 100);
+
+    // Fields after the half float are read at their offsets
+    const QVariantMap sample = log.sampleAt(100);
+    EXPECT_DOUBLE_EQ(sample.value("latitude").toDouble(), 555000002 / 1e7);
+    EXPECT_DOUBLE_EQ(sample.value("gs").toDouble(), 14.5);
+    EXPECT_DOUBLE_EQ(sample.value("altitudeAmsl").toDouble(), 152.5);
+}
+
+TEST_F(FlightLogTest, testCacheInvalidation)
+{
+    const QDateTime modified = QDateTime::currentDateTime().addSecs(-3600);
+    write(::tlog(::recordCount), modified);
+    {
+        FlightLog log(path);
+        ASSERT_TRUE(log.open());
+        ASSERT_TRUE(QFile::exists(FlightLogIndex::cachePath(path)));
+    }
+
+    // Same size and modification time, the cached index is taken as is
+    QByteArray shifted = ::tlog(::recordCount);
+    qToBigEndian<quint64>(::startUs - 1000000, shifted.data());
+    write(shifted, modified);
+    {
+        FlightLog log(path);
+        ASSERT_TRUE(log.open());
+        EXPECT_EQ(log.duration(), (::recordCount - 1) * 100);
+    }
+
+    // A new modification time makes the index rebuilt, the first record is a second earlier now
+    write(shifted, modified.addSecs(1));
+    {
+        FlightLog log(path);
+        ASSERT_TRUE(log.open());
+        EXPECT_EQ(log.duration(), (::recordCount - 1) * 100 + 1000);
+    }
+
+    // So does a new size
+    write(::tlog(::recordCount + 1), modified.addSecs(1));
+    {
+        FlightLog log(path);
+        ASSERT_TRUE(log.open());
+        EXPECT_EQ(log.index().messageCount(), ::recordCount + 1);
+    }
+}
@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QQueue>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <algorithm>
+#include <random>
+
+#include "ftp_client.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int burstChunks = 16;
+constexpr int timeout = 30000;
+
+// Remote side of MAVLink FTP, loses and shuffles burst replies
+class FakeFtpServer
+{
+public:
+    FakeFtpServer(const QHash<QString, QByteArray>& files, double dropRate) :
+        m_files(files),
+        m_dropRate(dropRate)
+    {
+    }
+
+    void receive(const QByteArray& raw)
+    {
+        const FtpPayload request = FtpPayload::decode(raw);
+        switch (request.opcode)
+        {
+        case FtpPayload::OpenFileRO:
+            this->open(request);
+            break;
+        case FtpPayload::ReadFile:
+            this->read(request);
+            break;
+        case FtpPayload::BurstReadFile:
+            this->burst(request);
+            break;
+        case FtpPayload::TerminateSession:
+            m_sessions.remove(request.session);
+            this->ack(request, request.session, 0, QByteArray());
+            break;
+        default:
+            this->nak(request, FtpPayload::UnknownCommand);
+            break;
+        }
+    }
+
+    bool hasReplies() const
+    {
+        return !m_replies.isEmpty();
+    }
+
+    QByteArray takeReply()
+    {
+        return m_replies.dequeue();
+    }
+
+    int openSessions() const
+    {
+        return m_sessions.count();
+    }
+
+    int dropped() const
+    {
+        return m_dropped;
+    }
+
+private:
+    void open(const FtpPayload& request)
+    {
+        const QString path = QString::fromUtf8(request.data);
+        if (!m_files.contains(path))
+        {
+            this->nak(request, FtpPayload::FileNotFound);
+            return;
+        }
+
+        const quint8 session = m_nextSession++;
+        m_sessions.insert(session, path);
+        QByteArray size(4, '\0');
+        qToLittleEndian<quint32>(m_files.value(path).size(), size.data());
+        this->ack(request, session, 0, size);
+    }
+
+    void read(const FtpPayload& request)
+    {
+        const QByteArray file = m_files.value(m_sessions.value(request.session));
+        if (request.offset >= quint32(file.size()))
+        {
+            this->nak(request, FtpPayload::EndOfFile);
+            return;
+        }
+
+        this->ack(request, request.session, request.offset, file.mid(request.offset, request.size));
+    }
+
+    void burst(const FtpPayload& request)
+    {
+        const QByteArray file = m_files.value(m_sessions.value(request.session));
+        if (request.offset >= quint32(file.size()))
+        {
+            this->nak(request, FtpPayload::EndOfFile);
+            return;
+        }
+
+        QVector<QByteArray> chunks;
+        for (int i = 0; i < ::burstChunks; ++i)
+        {
+            const quint32 offset = request.offset + i * FtpPayload::maxDataSize;
+            if (offset >= quint32(file.size()))
+                break;
+
+            FtpPayload reply = this->reply(request, request.session, offset,
+                                           file.mid(offset, FtpPayload::maxDataSize));
+            reply.seq += i;
+            reply.burstComplete = i + 1 == ::burstChunks ||
+                                  offset + FtpPayload::maxDataSize >= quint32(file.size());
+            chunks.append(reply.encode());
+        }
+
+        // The completing chunk is kept, so the client never has to wait for a timeout
+        std::shuffle(chunks.begin(), chunks.end(), std::mt19937(m_random.generate()));
+        for (const QByteArray& chunk : qAsConst(chunks))
+        {
+            if (!FtpPayload::decode(chunk).burstComplete && m_random.generateDouble() < m_dropRate)
+                m_dropped++;
+            else
+                m_replies.enqueue(chunk);
+        }
+    }
+
+    FtpPayload reply(const FtpPayload& request, quint8 session, quint32 offset,
+                     const QByteArray& data)
+    {
+        FtpPayload reply;
+        reply.seq = request.seq + 1;
+        reply.session = session;
+        reply.opcode = FtpPayload::Ack;
+        reply.requestOpcode = request.opcode;
+        reply.offset = offset;
+        reply.size = quint8(data.size());
+        reply.data = data;
+        return reply;
+    }
+
+    void ack(const FtpPayload& request, quint8 session, quint32 offset, const QByteArray& data)
+    {
+        m_replies.enqueue(this->reply(request, session, offset, data).encode());
+    }
+
+    void nak(const FtpPayload& request, FtpPayload::Error error)
+    {
+        FtpPayload reply = this->reply(request, request.session, 0, QByteArray(1, char(error)));
+        reply.opcode = FtpPayload::Nak;
+        m_replies.enqueue(reply.encode());
+    }
+
+    const QHash<QString, QByteArray> m_files;
+    const double m_dropRate;
+    QRandomGenerator m_random = QRandomGenerator(42);
+    QHash<quint8, QString> m_sessions;
+    quint8 m_nextSession = 1;
+    QQueue<QByteArray> m_replies;
+    int m_dropped = 0;
+};
+
+QByteArray randomFile(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator random(size);
+    for (char& byte : data)
+    {
+        byte = char(random.bounded(256));
+    }
+    return data;
+}
+} // namespace
+
+class FtpClientTest : public ::testing::Test
+{
+protected:
+    void connect(FtpClient& client, FakeFtpServer& server)
+    {
+        QObject::connect(&client, &FtpClient::sendPayload, [&server](const QByteArray& raw) {
+            server.receive(raw);
+        });
+        QObject::connect(&client, &FtpClient::finished,
+                         [this](int transferId, bool succeeded, const QString& error) {
+                             results.insert(transferId, succeeded);
+                             errors.insert(transferId, error);
+                         });
+    }
+
+    // Replies are delivered one by one from here, never from inside sendPayload
+    void wait(FtpClient& client, FakeFtpServer& server, int finishedCount)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (results.count() < finishedCount && timer.elapsed() < ::timeout)
+        {
+            if (server.hasReplies())
+                client.receivePayload(server.takeReply());
+            else
+                QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 50);
+        }
+    }
+
+    QByteArray read(const QString& path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    QTemporaryDir dir;
+    QHash<int, bool> results;
+    QHash<int, QString> errors;
+};
+
+TEST_F(FtpClientTest, testDroppedAndReorderedBursts)
+{
+    const QHash<QString, QByteArray> files = { { "/fs/microsd/log/1.ulg", ::randomFile(200000) },
+                                               { "/fs/microsd/log/2.ulg", ::randomFile(77777) },
+                                               { "/fs/microsd/log/3.ulg", ::randomFile(239) },
+                                               { "/fs/microsd/log/4.ulg", ::randomFile(5000) } };
+    FakeFtpServer server(files, 0.2);
+    FtpClient client;
+    this->connect(client, server);
+
+    // One more than sessions, the last one waits in the queue
+    int transferId = 0;
+    QHash<int, QString> paths;
+    for (const QString& remotePath : files.keys())
+    {
+        paths.insert(++transferId, remotePath);
+        client.download(transferId, remotePath, dir.filePath(QString::number(transferId)));
+    }
+
+    this->wait(client, server, files.count());
+
+    ASSERT_EQ(results.count(), files.count());
+    EXPECT_GT(server.dropped(), 0);
+    EXPECT_EQ(server.openSessions(), 0);
+    for (auto it = paths.constBegin(); it != paths.constEnd(); ++it)
+    {
+        EXPECT_TRUE(results.value(it.key())) << errors.value(it.key()).toStdString();
+        EXPECT_EQ(this->read(dir.filePath(QString::number(it.key()))), files.value(it.value()))
+            << it.value().toStdString();
+    }
+}
+
+TEST_F(FtpClientTest, testMissingFile)
+{
+    FakeFtpServer server({}, 0);
+    FtpClient client;
+    this->connect(client, server);
+
+    client.download(1, "/fs/microsd/log/none.ulg", dir.filePath("none"));
+    this->wait(client, server, 1);
+
+    ASSERT_TRUE(results.contains(1));
+    EXPECT_FALSE(results.value(1));
+    EXPECT_FALSE(errors.value(1).isEmpty());
+}
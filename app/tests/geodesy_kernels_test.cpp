@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+#include <QtMath>
+
+#include "geodesy_kernels.h"
+
+using namespace md::domain;
+
+namespace
+{
+// Straightforward per pair math
+void scalarLeg(double lat1, double lon1, double lat2, double lon2, double& distance,
+               double& bearing)
+{
+    const double phi1 = qDegreesToRadians(lat1);
+    const double phi2 = qDegreesToRadians(lat2);
+    const double dLambda = qDegreesToRadians(lon2 - lon1);
+    const double sinDPhi = std::sin((phi2 - phi1) / 2);
+    const double sinDLambda = std::sin(dLambda / 2);
+    const double a = sinDPhi * sinDPhi + std::cos(phi1) * std::cos(phi2) * sinDLambda * sinDLambda;
+    distance = 2 * geodesy::meanRadius * std::asin(std::sqrt(std::fmin(1.0, a)));
+
+    const double y = std::sin(dLambda) * std::cos(phi2);
+    const double x = std::cos(phi1) * std::sin(phi2) -
+                     std::sin(phi1) * std::cos(phi2) * std::cos(dLambda);
+    bearing = std::fmod(qRadiansToDegrees(std::atan2(y, x)) + 360.0, 360.0);
+}
+
+GeodeticArrays randomPath(int count)
+{
+    GeodeticArrays path;
+    path.resize(count);
+    QRandomGenerator random(42);
+    double latitude = 55.0;
+    double longitude = 37.0;
+    for (int i = 0; i < count; ++i)
+    {
+        latitude += random.generateDouble() * 0.002 - 0.001;
+        longitude += random.generateDouble() * 0.002 - 0.001;
+        path.latitudes[i] = latitude;
+        path.longitudes[i] = longitude;
+        path.altitudes[i] = 0;
+    }
+    return path;
+}
+} // namespace
+
+TEST(GeodesyKernelsTest, testLegsMatchScalar)
+{
+    const GeodeticArrays path = ::randomPath(1000);
+    QVector<double> distances(path.count() - 1);
+    QVector<double> bearings(path.count() - 1);
+    geodesy::legs(path.latitudes.constData(), path.longitudes.constData(), distances.data(),
+                  bearings.data(), path.count());
+
+    for (int i = 0; i < path.count() - 1; ++i)
+    {
+        double distance, bearing;
+        ::scalarLeg(path.latitudes.at(i), path.longitudes.at(i), path.latitudes.at(i + 1),
+                    path.longitudes.at(i + 1), distance, bearing);
+        ASSERT_NEAR(distances.at(i), distance, 1e-6);
+        ASSERT_NEAR(bearings.at(i), bearing, 1e-6);
+    }
+}
+
+TEST(GeodesyKernelsTest, testEnuRoundTrip)
+{
+    const GeodeticArrays path = ::randomPath(1000);
+    const Geodetic origin = path.at(0);
+    const int count = path.count();
+    QVector<double> east(count), north(count), up(count);
+    geodesy::toEnu(origin, path.latitudes.constData(), path.longitudes.constData(),
+                   path.altitudes.constData(), east.data(), north.data(), up.data(), count);
+
+    GeodeticArrays back;
+    back.resize(count);
+    geodesy::fromEnu(origin, east.constData(), north.constData(), up.constData(),
+                     back.latitudes.data(), back.longitudes.data(), back.altitudes.data(), count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_NEAR(back.latitudes.at(i), path.latitudes.at(i), 1e-9);
+        ASSERT_NEAR(back.longitudes.at(i), path.longitudes.at(i), 1e-9);
+        ASSERT_NEAR(back.altitudes.at(i), path.altitudes.at(i), 1e-3);
+    }
+}
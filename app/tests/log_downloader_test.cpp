@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QQueue>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include "log_downloader.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int downloadId = 1;
+constexpr int vehicleId = 1;
+constexpr int logId = 7;
+constexpr int logSize = 300001;
+constexpr int logDataSize = 90; // Bytes in one LOG_DATA
+constexpr qint64 timeout = 600000;
+
+// Vehicle side of LOG_REQUEST_DATA, answers with LOG_DATA chunks and loses some of them
+class FakeLogResponder
+{
+public:
+    struct Request
+    {
+        quint32 offset;
+        quint32 count;
+        qint64 time;
+    };
+
+    FakeLogResponder(const QByteArray& log, double dropRate) : m_log(log), m_dropRate(dropRate)
+    {
+    }
+
+    void receive(quint32 offset, quint32 count, qint64 time)
+    {
+        m_requests.append({ offset, count, time });
+
+        const quint32 end = qMin(offset + count, quint32(m_log.size()));
+        for (quint32 chunk = offset; chunk < end; chunk += ::logDataSize)
+        {
+            const int size = qMin<int>(::logDataSize, end - chunk);
+            if (m_random.generateDouble() < m_dropRate)
+                m_dropped++;
+            else
+                m_replies.enqueue({ chunk, m_log.mid(chunk, size) });
+        }
+    }
+
+    bool hasReplies() const
+    {
+        return !m_replies.isEmpty();
+    }
+
+    // Offset and data of the next LOG_DATA
+    QPair<quint32, QByteArray> takeReply()
+    {
+        return m_replies.dequeue();
+    }
+
+    void clear()
+    {
+        m_replies.clear();
+    }
+
+    const QVector<Request>& requests() const
+    {
+        return m_requests;
+    }
+
+    qint64 requestedBytes() const
+    {
+        qint64 bytes = 0;
+        for (const Request& request : m_requests)
+        {
+            bytes += request.count;
+        }
+        return bytes;
+    }
+
+    int dropped() const
+    {
+        return m_dropped;
+    }
+
+private:
+    const QByteArray m_log;
+    const double m_dropRate;
+    QRandomGenerator m_random = QRandomGenerator(40);
+    QVector<Request> m_requests;
+    QQueue<QPair<quint32, QByteArray>> m_replies;
+    int m_dropped = 0;
+};
+
+QByteArray randomLog(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator random(size);
+    for (char& byte : data)
+    {
+        byte = char(random.bounded(256));
+    }
+    return data;
+}
+} // namespace
+
+class LogDownloaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        path = dir.filePath("7.bin");
+    }
+
+    void create(double dropRate)
+    {
+        if (!responder)
+            responder.reset(new FakeLogResponder(log, dropRate));
+
+        downloader.reset(new LogDownloader([this]() {
+            return now;
+        }));
+        QObject::connect(downloader.data(), &LogDownloader::requestData,
+                         [this](const QVariant&, int, quint32 offset, quint32 count) {
+                             responder->receive(offset, count, now);
+                         });
+        QObject::connect(downloader.data(), &LogDownloader::finished,
+                         [this](int, bool succeeded, const QString&) {
+                             results.append(succeeded);
+                         });
+        downloader->start(::downloadId, ::vehicleId, ::logId, log.size(), path);
+    }
+
+    void deliver()
+    {
+        const QPair<quint32, QByteArray> reply = responder->takeReply();
+        downloader->receiveData(::vehicleId, ::logId, reply.first, reply.second);
+    }
+
+    // Replies arrive as long as there are any, the clock runs only when the link is silent
+    void run(qint64 until = ::timeout)
+    {
+        while (results.isEmpty() && now < until)
+        {
+            if (responder->hasReplies())
+            {
+                this->deliver();
+            }
+            else
+            {
+                now += LogDownloader::tickInterval;
+                downloader->process();
+            }
+        }
+    }
+
+    QByteArray read() const
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    const QByteArray log = ::randomLog(::logSize);
+    QTemporaryDir dir;
+    QString path;
+    qint64 now = 0;
+    QScopedPointer<FakeLogResponder> responder;
+    QScopedPointer<LogDownloader> downloader;
+    QVector<bool> results;
+};
+
+TEST_F(LogDownloaderTest, testGapRepair)
+{
+    create(0.3);
+    run();
+
+    ASSERT_EQ(results, QVector<bool>({ true }));
+    EXPECT_GT(responder->dropped(), 0);
+    EXPECT_EQ(read(), log);
+    EXPECT_FALSE(QFile::exists(LogDownloader::rangesPath(path)));
+
+    // Only the gaps are asked again, not whole requests
+    EXPECT_LT(responder->requestedBytes(), 2 * log.size());
+}
+
+TEST_F(LogDownloaderTest, testWindowRefill)
+{
+    create(0);
+    ASSERT_EQ(responder->requests().count(), LogDownloader::maxOutstanding);
+
+    // The next request goes out as soon as the first one is filled, without waiting for a tick
+    const int chunks = (LogDownloader::requestSize + ::logDataSize - 1) / ::logDataSize;
+    for (int i = 0; i < chunks - 1; ++i)
+    {
+        deliver();
+    }
+    EXPECT_EQ(responder->requests().count(), LogDownloader::maxOutstanding);
+
+    deliver();
+    ASSERT_EQ(responder->requests().count(), LogDownloader::maxOutstanding + 1);
+    EXPECT_EQ(responder->requests().last().offset,
+              quint32(LogDownloader::maxOutstanding * LogDownloader::requestSize));
+
+    run();
+    ASSERT_EQ(results, QVector<bool>({ true }));
+    EXPECT_EQ(read(), log);
+}
+
+TEST_F(LogDownloaderTest, testRetryBackoff)
+{
+    create(1.0);
+    run(120000);
+    EXPECT_TRUE(results.isEmpty());
+
+    QVector<qint64> times;
+    for (const FakeLogResponder::Request& request : responder->requests())
+    {
+        if (request.offset == 0)
+            times.append(request.time);
+    }
+    ASSERT_GT(times.count(), 4);
+
+    // Intervals grow up to a limit and stay there, the download keeps asking
+    EXPECT_GE(times.at(1) - times.at(0), LogDownloader::requestTimeout);
+    for (int i = 2; i < times.count(); ++i)
+    {
+        EXPECT_GE(times.at(i) - times.at(i - 1), times.at(i - 1) - times.at(i - 2));
+    }
+    const qint64 last = times.at(times.count() - 1) - times.at(times.count() - 2);
+    EXPECT_EQ(last, times.at(times.count() - 2) - times.at(times.count() - 3));
+    EXPECT_LE(last, 8 * LogDownloader::requestTimeout + LogDownloader::tickInterval);
+}
+
+TEST_F(LogDownloaderTest, testResumeAfterRestart)
+{
+    create(0);
+    const int delivered = 1000;
+    for (int i = 0; i < delivered; ++i)
+    {
+        deliver();
+    }
+
+    // The app quits with requests in flight, received ranges stay next to the file
+    downloader.reset();
+    responder->clear();
+    ASSERT_TRUE(QFile::exists(LogDownloader::rangesPath(path)));
+
+    const int requested = responder->requests().count();
+    create(0);
+    ASSERT_GT(responder->requests().count(), requested);
+    EXPECT_EQ(responder->requests().at(requested).offset, quint32(delivered * ::logDataSize));
+
+    run();
+    ASSERT_EQ(results, QVector<bool>({ true }));
+    EXPECT_EQ(read(), log);
+    EXPECT_FALSE(QFile::exists(LogDownloader::rangesPath(path)));
+}
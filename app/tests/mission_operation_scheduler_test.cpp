@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "mission_items_repository_sql.h"
+#include "mission_operation_scheduler.h"
+#include "missions_repository_sql.h"
+#include "missions_service.h"
+#include "sqlite_schema.h"
+
+using namespace md;
+using namespace md::domain;
+
+namespace
+{
+const MissionType missionType("test", "Test", nullptr, {});
+
+// Runs operations on demand: refused vehicles never start, the others start at once or queued
+class FakeMissionsService : public MissionsService
+{
+public:
+    using MissionsService::MissionsService;
+
+    void startOperation(Mission* mission, MissionOperation::Type type) override
+    {
+        starts.append(mission);
+        if (refused.contains(mission->vehicleId().toString()))
+            return;
+
+        MissionOperation* operation = new MissionOperation(mission, type, this);
+        running.append(operation);
+        if (queuedStart)
+        {
+            QMetaObject::invokeMethod(
+                this,
+                [this, operation]() {
+                    emit operationStarted(operation);
+                },
+                Qt::QueuedConnection);
+        }
+        else
+        {
+            emit operationStarted(operation);
+        }
+    }
+
+    void endOperation(MissionOperation* operation, MissionOperation::State state) override
+    {
+        if (!running.removeOne(operation))
+            return;
+
+        operation->state.set(state);
+        emit operationEnded(operation);
+        operation->deleteLater();
+    }
+
+    void removeMission(Mission* mission)
+    {
+        emit missionRemoved(mission);
+    }
+
+    MissionOperation* runningFor(Mission* mission) const
+    {
+        for (MissionOperation* operation : running)
+        {
+            if (operation->mission() == mission)
+                return operation;
+        }
+        return nullptr;
+    }
+
+    QList<Mission*> starts;
+    QList<MissionOperation*> running;
+    QSet<QString> refused;
+    bool queuedStart = false;
+};
+} // namespace
+
+class MissionOperationSchedulerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        schema.reset(new data_source::SqliteSchema(dir.filePath("dreka.db")));
+        schema->setup();
+
+        missionsRepository.reset(new data_source::MissionsRepositorySql(schema->db()));
+        itemsRepository.reset(new data_source::MissionItemsRepositorySql(schema->db()));
+        missions.reset(new FakeMissionsService(missionsRepository.data(), itemsRepository.data()));
+        scheduler.reset(new MissionOperationScheduler(missions.data(), [this]() {
+            return now;
+        }));
+    }
+
+    void TearDown() override
+    {
+        scheduler.reset();
+        qDeleteAll(created);
+    }
+
+    Mission* createMission(const QString& vehicleId)
+    {
+        Mission* mission = new Mission(&::missionType, vehicleId, vehicleId);
+        created.append(mission);
+        return mission;
+    }
+
+    void advance(qint64 msec)
+    {
+        now += msec;
+        scheduler->dispatch();
+    }
+
+    void succeed(Mission* mission)
+    {
+        MissionOperation* operation = missions->runningFor(mission);
+        ASSERT_TRUE(operation);
+        missions->endOperation(operation, MissionOperation::Succeeded);
+    }
+
+    qint64 now = 0;
+    QList<Mission*> created;
+
+    QTemporaryDir dir;
+    QScopedPointer<data_source::SqliteSchema> schema;
+    QScopedPointer<data_source::MissionsRepositorySql> missionsRepository;
+    QScopedPointer<data_source::MissionItemsRepositorySql> itemsRepository;
+    QScopedPointer<FakeMissionsService> missions;
+    QScopedPointer<MissionOperationScheduler> scheduler;
+};
+
+TEST_F(MissionOperationSchedulerTest, testLinksShareSlotsFairly)
+{
+    // Two vehicles behind one radio and a vehicle on its own link
+    scheduler->setLinkResolver([](Mission* mission) {
+        return mission->vehicleId().toString() == "solo" ? QString("wifi") : QString("radio");
+    });
+    const QList<Mission*> radio = { createMission("a"), createMission("b"), createMission("c") };
+    Mission* solo = createMission("solo");
+    QSignalSpy finished(scheduler.data(), &MissionOperationScheduler::batchFinished);
+
+    scheduler->startBatch(radio + QList<Mission*>{ solo }, MissionOperation::Upload);
+
+    // The busy radio does not make the other link wait behind it
+    ASSERT_EQ(missions->starts.count(), MissionOperationScheduler::maxPerLink + 1);
+    EXPECT_EQ(missions->starts.at(0), radio.at(0));
+    EXPECT_EQ(missions->starts.at(1), solo);
+    EXPECT_EQ(missions->starts.at(2), radio.at(1));
+
+    // A freed slot goes to the next mission on the same link
+    succeed(radio.at(0));
+    ASSERT_EQ(missions->starts.count(), 4);
+    EXPECT_EQ(missions->starts.last(), radio.at(2));
+
+    succeed(solo);
+    succeed(radio.at(1));
+    succeed(radio.at(2));
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(1).toInt(), 4);
+    EXPECT_EQ(finished.at(0).at(2).toInt(), 0);
+}
+
+TEST_F(MissionOperationSchedulerTest, testRefusedStartsBackOff)
+{
+    Mission* mission = createMission("offline");
+    missions->refused.insert("offline");
+    QSignalSpy finished(scheduler.data(), &MissionOperationScheduler::batchFinished);
+
+    scheduler->startBatch({ mission }, MissionOperation::Upload);
+    ASSERT_EQ(missions->starts.count(), 1);
+
+    // A start is refused only once its deadline passes
+    advance(MissionOperationScheduler::startTimeout - 1);
+    EXPECT_EQ(missions->starts.count(), 1);
+    advance(1);
+    EXPECT_EQ(missions->starts.count(), 1);
+
+    // Then retried after the delay, doubled with every attempt
+    advance(MissionOperationScheduler::retryDelay - 1);
+    EXPECT_EQ(missions->starts.count(), 1);
+    advance(1);
+    EXPECT_EQ(missions->starts.count(), 2);
+
+    advance(MissionOperationScheduler::startTimeout);
+    advance(2 * MissionOperationScheduler::retryDelay - 1);
+    EXPECT_EQ(missions->starts.count(), 2);
+    advance(1);
+    EXPECT_EQ(missions->starts.count(), 3);
+
+    advance(MissionOperationScheduler::startTimeout);
+    EXPECT_EQ(missions->starts.count(), MissionOperationScheduler::maxAttempts);
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(1).toInt(), 0);
+    EXPECT_EQ(finished.at(0).at(2).toInt(), 1);
+}
+
+TEST_F(MissionOperationSchedulerTest, testLateStartIsNotRefused)
+{
+    Mission* mission = createMission("a");
+    missions->queuedStart = true;
+    QSignalSpy finished(scheduler.data(), &MissionOperationScheduler::batchFinished);
+
+    scheduler->startBatch({ mission }, MissionOperation::Download);
+    QCoreApplication::processEvents();
+    advance(MissionOperationScheduler::startTimeout);
+
+    succeed(mission);
+    EXPECT_EQ(missions->starts.count(), 1);
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(1).toInt(), 1);
+}
+
+TEST_F(MissionOperationSchedulerTest, testCancelBatch)
+{
+    const QList<Mission*> batch = { createMission("a"), createMission("a"), createMission("a") };
+    Mission* starting = createMission("b");
+    missions->refused.insert("b");
+    QSignalSpy finished(scheduler.data(), &MissionOperationScheduler::batchFinished);
+
+    const int batchId = scheduler->startBatch(batch + QList<Mission*>{ starting },
+                                              MissionOperation::Upload);
+    ASSERT_EQ(missions->running.count(), 2);
+
+    // Running operations are canceled, waiting and starting jobs never start
+    scheduler->cancelBatch(batchId);
+    EXPECT_TRUE(missions->running.isEmpty());
+    EXPECT_FALSE(scheduler->isActive(batchId));
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(1).toInt(), 0);
+    EXPECT_EQ(finished.at(0).at(2).toInt(), 4);
+
+    advance(MissionOperationScheduler::startTimeout + MissionOperationScheduler::retryDelay);
+    EXPECT_EQ(missions->starts.count(), 3);
+}
+
+TEST_F(MissionOperationSchedulerTest, testRemovedMissionsFail)
+{
+    const QList<Mission*> batch = { createMission("a"), createMission("a"), createMission("a") };
+    QSignalSpy finished(scheduler.data(), &MissionOperationScheduler::batchFinished);
+
+    scheduler->startBatch(batch, MissionOperation::Upload);
+    ASSERT_EQ(missions->starts.count(), 2);
+
+    // A waiting mission is dropped from the queue
+    missions->removeMission(batch.at(2));
+    succeed(batch.at(0));
+    EXPECT_EQ(missions->starts.count(), 2);
+
+    // A running one frees its slot and its late end is ignored
+    MissionOperation* operation = missions->runningFor(batch.at(1));
+    missions->removeMission(batch.at(1));
+    ASSERT_EQ(finished.count(), 1);
+    EXPECT_EQ(finished.at(0).at(1).toInt(), 1);
+    EXPECT_EQ(finished.at(0).at(2).toInt(), 2);
+
+    missions->endOperation(operation, MissionOperation::Succeeded);
+    EXPECT_EQ(finished.count(), 1);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+#include "mission_validator.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr char routeKey[] = "route";
+
+ItemSnapshot item(bool home, double latitude, double longitude, double altitude)
+{
+    ItemSnapshot snapshot;
+    snapshot.home = home;
+    snapshot.positioned = true;
+    snapshot.latitude = latitude;
+    snapshot.longitude = longitude;
+    snapshot.altitude = altitude;
+    return snapshot;
+}
+} // namespace
+
+class MissionValidatorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        qRegisterMetaType<QVector<QStringList>>("QVector<QStringList>");
+    }
+};
+
+TEST_F(MissionValidatorTest, testLegAndAltitudeLimits)
+{
+    MissionValidator validator(ValidationLimits{});
+    QSignalSpy spy(&validator, &MissionValidator::validated);
+
+    validator.reset(::routeKey, { ::item(true, 55.0, 37.0, 0), ::item(false, 55.01, 37.0, 100) });
+    ASSERT_EQ(spy.count(), 1);
+    EXPECT_EQ(spy.last().at(2).toInt(), 0);
+
+    // Farther than the leg limit and above the altitude one
+    validator.insertItem(::routeKey, 2, ::item(false, 56.0, 37.0, 20000));
+    ASSERT_EQ(spy.count(), 2);
+    EXPECT_EQ(spy.last().at(2).toInt(), 1);
+
+    validator.removeItem(::routeKey, 2);
+    ASSERT_EQ(spy.count(), 3);
+    EXPECT_EQ(spy.last().at(2).toInt(), 0);
+}
+
+TEST_F(MissionValidatorTest, testOutOfRangeEditsAreAnswered)
+{
+    MissionValidator validator(ValidationLimits{});
+    QSignalSpy spy(&validator, &MissionValidator::validated);
+
+    validator.reset(::routeKey, { ::item(true, 55.0, 37.0, 0) });
+    validator.insertItem(::routeKey, 5, ::item(false, 55.0, 37.0, 0));
+    validator.updateItem(::routeKey, -1, ::item(false, 55.0, 37.0, 0));
+    validator.removeItem(::routeKey, 3);
+
+    ASSERT_EQ(spy.count(), 4);
+    EXPECT_EQ(spy.last().at(0).toString(), ::routeKey);
+    EXPECT_EQ(spy.last().at(2).toInt(), 0);
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <QRandomGenerator>
+
+#include "route_diff.h"
+
+using namespace md::domain;
+
+namespace
+{
+constexpr int routeSize = 500;
+
+QVector<quint64> route(int count, quint64 first = 1)
+{
+    QVector<quint64> hashes;
+    for (int i = 0; i < count; ++i)
+    {
+        hashes.append(first + i);
+    }
+    return hashes;
+}
+
+// Onboard route after the script is carried out
+QVector<quint64> apply(const QVector<quint64>& onboard, const QVector<quint64>& local,
+                       const QVector<RouteEdit>& script)
+{
+    QVector<quint64> result;
+    int position = 0;
+    for (const RouteEdit& edit : script)
+    {
+        while (position < edit.onboardIndex)
+        {
+            result.append(onboard.at(position++));
+        }
+
+        if (edit.type != RouteEdit::Insert)
+            position++;
+        if (edit.type != RouteEdit::Remove)
+            result.append(local.at(edit.localIndex));
+    }
+    while (position < onboard.count())
+    {
+        result.append(onboard.at(position++));
+    }
+    return result;
+}
+
+void expectEdit(const RouteEdit& edit, RouteEdit::Type type, int onboardIndex, int localIndex)
+{
+    EXPECT_EQ(edit.type, type);
+    EXPECT_EQ(edit.onboardIndex, onboardIndex);
+    EXPECT_EQ(edit.localIndex, localIndex);
+}
+
+void expectTransfer(const RouteTransfer& transfer, int from, int count, bool partial)
+{
+    EXPECT_EQ(transfer.from, from);
+    EXPECT_EQ(transfer.count, count);
+    EXPECT_EQ(transfer.partial, partial);
+}
+} // namespace
+
+TEST(RouteDiffTest, testSameRoute)
+{
+    const QVector<quint64> onboard = ::route(::routeSize);
+    QVector<RouteEdit> script;
+    ASSERT_TRUE(diffRoutes(onboard, onboard, script));
+
+    EXPECT_TRUE(script.isEmpty());
+    ::expectTransfer(routeTransfer(script, onboard.count()), onboard.count(), 0, true);
+}
+
+TEST(RouteDiffTest, testInsertAtHead)
+{
+    const QVector<quint64> onboard = ::route(::routeSize);
+    const QVector<quint64> local = QVector<quint64>({ 0 }) + onboard;
+    QVector<RouteEdit> script;
+    ASSERT_TRUE(diffRoutes(onboard, local, script));
+
+    ASSERT_EQ(script.count(), 1);
+    ::expectEdit(script.at(0), RouteEdit::Insert, 0, 0);
+    EXPECT_EQ(::apply(onboard, local, script), local);
+
+    // Every item moves, the whole route is sent
+    ::expectTransfer(routeTransfer(script, local.count()), 0, local.count(), false);
+}
+
+TEST(RouteDiffTest, testRemoveAtTail)
+{
+    const QVector<quint64> onboard = ::route(::routeSize);
+    const QVector<quint64> local = onboard.mid(0, ::routeSize - 1);
+    QVector<RouteEdit> script;
+    ASSERT_TRUE(diffRoutes(onboard, local, script));
+
+    ASSERT_EQ(script.count(), 1);
+    ::expectEdit(script.at(0), RouteEdit::Remove, ::routeSize - 1, ::routeSize - 1);
+    EXPECT_EQ(::apply(onboard, local, script), local);
+
+    // Only the count changes, no item is sent
+    ::expectTransfer(routeTransfer(script, local.count()), local.count(), 0, false);
+}
+
+TEST(RouteDiffTest, testSingleReplace)
+{
+    const QVector<quint64> onboard = ::route(::routeSize);
+    QVector<quint64> local = onboard;
+    local[250] = 1000;
+    QVector<RouteEdit> script;
+    ASSERT_TRUE(diffRoutes(onboard, local, script));
+
+    // One changed waypoint of a long route is a single partial write
+    ASSERT_EQ(script.count(), 1);
+    ::expectEdit(script.at(0), RouteEdit::Replace, 250, 250);
+    EXPECT_EQ(::apply(onboard, local, script), local);
+    ::expectTransfer(routeTransfer(script, local.count()), 250, 1, true);
+}
+
+TEST(RouteDiffTest, testSeparateReplaces)
+{
+    const QVector<quint64> onboard = ::route(::routeSize);
+    QVector<quint64> local = onboard;
+    local[10] = 1000;
+    local[20] = 1001;
+    QVector<RouteEdit> script;
+    ASSERT_TRUE(diffRoutes(onboard, local, script));
+
+    ASSERT_EQ(script.count(), 2);
+    ::expectEdit(script.at(0), RouteEdit::Replace, 10, 10);
+    ::expectEdit(script.at(1), RouteEdit::Replace, 20, 20);
+
+    // Unchanged items between them are written too, the range must be contiguous
+    ::expectTransfer(routeTransfer(script, local.count()), 10, 11, true);
+}
+
+TEST(RouteDiffTest, testMixedEdits)
+{
+    // Second item removed, fifth replaced, one inserted after the eighth
+    const QVector<quint64> onboard = ::route(10);
+    const QVector<quint64> local({ 1, 3, 4, 50, 6, 7, 8, 80, 9, 10 });
+    QVector<RouteEdit> script;
+    ASSERT_TRUE(diffRoutes(onboard, local, script));
+
+    ASSERT_EQ(script.count(), 3);
+    ::expectEdit(script.at(0), RouteEdit::Remove, 1, 1);
+    ::expectEdit(script.at(1), RouteEdit::Replace, 4, 3);
+    ::expectEdit(script.at(2), RouteEdit::Insert, 8, 7);
+    EXPECT_EQ(::apply(onboard, local, script), local);
+    ::expectTransfer(routeTransfer(script, local.count()), 1, 9, false);
+}
+
+TEST(RouteDiffTest, testRandomEdits)
+{
+    QRandomGenerator random(37);
+    for (int run = 0; run < 200; ++run)
+    {
+        // Few distinct hashes, so there are many equally short scripts
+        QVector<quint64> onboard;
+        for (int i = random.bounded(60); i > 0; --i)
+        {
+            onboard.append(random.bounded(4));
+        }
+
+        QVector<quint64> local = onboard;
+        const int edits = random.bounded(10);
+        for (int i = 0; i < edits; ++i)
+        {
+            const int index = random.bounded(local.count() + 1);
+            if (random.bounded(2) || local.isEmpty())
+                local.insert(index, random.bounded(4));
+            else
+                local.removeAt(qMin(index, local.count() - 1));
+        }
+
+        QVector<RouteEdit> script;
+        ASSERT_TRUE(diffRoutes(onboard, local, script));
+        ASSERT_LE(script.count(), edits);
+        ASSERT_EQ(::apply(onboard, local, script), local) << "run " << run;
+    }
+}
+
+TEST(RouteDiffTest, testFallbackBeyondMaxEdits)
+{
+    const QVector<quint64> onboard = ::route(300);
+    QVector<RouteEdit> script;
+
+    // Nothing in common, same count: every item is replaced in place
+    const QVector<quint64> replaced = ::route(300, 1000);
+    EXPECT_FALSE(diffRoutes(onboard, replaced, script, 256));
+    script = rewriteRoute(onboard.count(), replaced.count());
+    EXPECT_EQ(::apply(onboard, replaced, script), replaced);
+    ::expectTransfer(routeTransfer(script, replaced.count()), 0, 300, true);
+
+    // Shorter local route: the tail is removed and the whole route is sent
+    const QVector<quint64> shorter = ::route(200, 1000);
+    EXPECT_FALSE(diffRoutes(onboard, shorter, script, 256));
+    script = rewriteRoute(onboard.count(), shorter.count());
+    EXPECT_EQ(::apply(onboard, shorter, script), shorter);
+    ::expectTransfer(routeTransfer(script, shorter.count()), 0, 200, false);
+
+    // Longer local route: the tail is inserted
+    const QVector<quint64> longer = ::route(400, 1000);
+    EXPECT_FALSE(diffRoutes(onboard, longer, script, 256));
+    script = rewriteRoute(onboard.count(), longer.count());
+    EXPECT_EQ(::apply(onboard, longer, script), longer);
+    ::expectTransfer(routeTransfer(script, longer.count()), 0, 400, false);
+
+    // The same edits fit under a higher limit
+    EXPECT_TRUE(diffRoutes(onboard, replaced, script, 600));
+    EXPECT_EQ(::apply(onboard, replaced, script), replaced);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+
+#include "property_tree.h"
+#include "sqlite_schema.h"
+#include "telemetry_rate_service.h"
+#include "vehicles_repository_sql.h"
+#include "vehicles_service.h"
+
+using namespace md;
+using namespace md::domain;
+
+namespace
+{
+constexpr char vehicleId[] = "1";
+constexpr double metersPerDegree = 111195; // Of latitude on the haversine sphere
+
+// MAVLink message ids
+constexpr int attitude = 30;
+constexpr int globalPositionInt = 33;
+
+const Geodetic viewCenter(55.0, 37.0, 0);
+} // namespace
+
+class TelemetryRateServiceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        schema.reset(new data_source::SqliteSchema(dir.filePath("dreka.db")));
+        schema->setup();
+
+        vehiclesRepository.reset(new data_source::VehiclesRepositorySql(schema->db()));
+        vehicles.reset(new VehiclesService(vehiclesRepository.data()));
+        service.reset(new TelemetryRateService(vehicles.data(), &pTree));
+    }
+
+    // Tier of the vehicle placed the distance north of the view center
+    TelemetryRateService::Tier moveTo(double distance)
+    {
+        pTree.appendProperties(::vehicleId,
+                               { { "latitude", ::viewCenter.latitude() +
+                                                   distance / ::metersPerDegree },
+                                 { "longitude", ::viewCenter.longitude() } });
+        service->updateTiers({ ::vehicleId });
+        return service->tier(::vehicleId);
+    }
+
+    void report(double utilization)
+    {
+        service->setLinkUtilization(utilization);
+        service->evaluate();
+    }
+
+    PropertyTree pTree;
+    QTemporaryDir dir;
+    QScopedPointer<data_source::SqliteSchema> schema;
+    QScopedPointer<data_source::VehiclesRepositorySql> vehiclesRepository;
+    QScopedPointer<VehiclesService> vehicles;
+    QScopedPointer<TelemetryRateService> service;
+};
+
+TEST_F(TelemetryRateServiceTest, testIntervals)
+{
+    using Service = TelemetryRateService;
+
+    // Microseconds from the tier rate in Hz
+    EXPECT_EQ(Service::intervals(Service::Tracked, 1).value(::attitude), 40000);
+    EXPECT_EQ(Service::intervals(Service::Selected, 1).value(::attitude), 100000);
+    EXPECT_EQ(Service::intervals(Service::Visible, 1).value(::attitude), 500000);
+    EXPECT_EQ(Service::intervals(Service::Background, 1).value(::attitude), 2000000);
+    EXPECT_EQ(Service::intervals(Service::Background, 1).value(::globalPositionInt), 1000000);
+
+    // The budget stretches every interval, the focused vehicle four times less
+    EXPECT_EQ(Service::intervals(Service::Visible, 8).value(::attitude), 4000000);
+    EXPECT_EQ(Service::intervals(Service::Tracked, 8).value(::attitude), 80000);
+    EXPECT_EQ(Service::intervals(Service::Selected, 2), Service::intervals(Service::Selected, 1));
+
+    const QMap<int, int> background = Service::intervals(Service::Background, 1);
+    for (Service::Tier tier : { Service::Tracked, Service::Selected, Service::Visible })
+    {
+        const QMap<int, int> faster = Service::intervals(tier, 1);
+        EXPECT_EQ(faster.keys(), background.keys());
+        for (int messageId : background.keys())
+        {
+            EXPECT_LE(faster.value(messageId), background.value(messageId)) << messageId;
+        }
+    }
+}
+
+TEST_F(TelemetryRateServiceTest, testVisibilityHysteresis)
+{
+    // Camera straight above the center, the view radius is its height
+    service->setViewport(::viewCenter,
+                         Geodetic(::viewCenter.latitude(), ::viewCenter.longitude(), 1000));
+
+    EXPECT_EQ(moveTo(900), TelemetryRateService::Visible);
+
+    // A shown vehicle leaves only past the hysteresis band
+    EXPECT_EQ(moveTo(1100), TelemetryRateService::Visible);
+    EXPECT_EQ(moveTo(1300), TelemetryRateService::Background);
+
+    // And enters again only inside the view radius
+    EXPECT_EQ(moveTo(1100), TelemetryRateService::Background);
+    EXPECT_EQ(moveTo(950), TelemetryRateService::Visible);
+
+    // The selected vehicle is never demoted by the view
+    service->setSelectedVehicle(::vehicleId);
+    EXPECT_EQ(moveTo(5000), TelemetryRateService::Selected);
+}
+
+TEST_F(TelemetryRateServiceTest, testBudgetFollowsFreshReports)
+{
+    report(0.9);
+    EXPECT_EQ(service->budgetFactor(), 2);
+
+    // A report moves the budget once, view changes and later evaluations keep it
+    service->setSelectedVehicle(::vehicleId);
+    service->setTracking(true);
+    service->evaluate();
+    EXPECT_EQ(service->budgetFactor(), 2);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        report(0.9);
+    }
+    EXPECT_EQ(service->budgetFactor(), TelemetryRateService::maxBudgetFactor);
+
+    // Utilisation between the bounds holds the budget
+    report(0.6);
+    EXPECT_EQ(service->budgetFactor(), TelemetryRateService::maxBudgetFactor);
+    report(0.3);
+    EXPECT_EQ(service->budgetFactor(), TelemetryRateService::maxBudgetFactor / 2);
+}
+
+TEST_F(TelemetryRateServiceTest, testStaleReportDecays)
+{
+    report(0.9);
+    report(0.9);
+    report(0.9);
+    ASSERT_EQ(service->budgetFactor(), 8);
+
+    // Without reports the last one stops counting, the budget relaxes step by step
+    for (int i = 1; i < TelemetryRateService::staleEvaluations; ++i)
+    {
+        service->evaluate();
+        EXPECT_EQ(service->budgetFactor(), 8);
+    }
+    service->evaluate();
+    EXPECT_EQ(service->budgetFactor(), 4);
+    service->evaluate();
+    EXPECT_EQ(service->budgetFactor(), 2);
+    service->evaluate();
+    service->evaluate();
+    EXPECT_EQ(service->budgetFactor(), 1);
+
+    // A new report is fresh again
+    report(0.9);
+    EXPECT_EQ(service->budgetFactor(), 2);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cmath>
+
+#include "property_tree.h"
+#include "sqlite_schema.h"
+#include "telemetry_shm_exporter.h"
+#include "vehicles_repository_sql.h"
+#include "vehicles_service.h"
+
+using namespace md;
+
+namespace
+{
+constexpr char vehicleNode[] = "vehicle_1";
+constexpr char playbackNode[] = "playback/vehicle_1";
+constexpr int readAttempts = 10;
+} // namespace
+
+class TelemetryShmExporterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        schema.reset(new data_source::SqliteSchema(dir.filePath("dreka.db")));
+        schema->setup();
+
+        vehiclesRepository.reset(new data_source::VehiclesRepositorySql(schema->db()));
+        vehicles.reset(new domain::VehiclesService(vehiclesRepository.data()));
+        exporter.reset(new app::TelemetryShmExporter(&pTree, vehicles.data()));
+
+        // Not the default name, a running app must not be disturbed
+        name = QString("/dreka_test_%1").arg(QCoreApplication::applicationPid());
+        ASSERT_TRUE(exporter->open(name));
+        shm = this->map();
+        ASSERT_TRUE(shm);
+    }
+
+    void TearDown() override
+    {
+        if (shm)
+            ::munmap(const_cast<dreka_telemetry_shm_t*>(shm), sizeof(dreka_telemetry_shm_t));
+        exporter.reset();
+    }
+
+    // Maps the segment the way a companion process does
+    const dreka_telemetry_shm_t* map() const
+    {
+        const int fd = ::shm_open(name.toLocal8Bit().constData(), O_RDONLY, 0);
+        if (fd < 0)
+            return nullptr;
+
+        void* data = ::mmap(nullptr, sizeof(dreka_telemetry_shm_t), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        return data == MAP_FAILED ? nullptr : static_cast<const dreka_telemetry_shm_t*>(data);
+    }
+
+    domain::PropertyTree pTree;
+    QTemporaryDir dir;
+    QScopedPointer<data_source::SqliteSchema> schema;
+    QScopedPointer<data_source::VehiclesRepositorySql> vehiclesRepository;
+    QScopedPointer<domain::VehiclesService> vehicles;
+    QScopedPointer<app::TelemetryShmExporter> exporter;
+    QString name;
+    const dreka_telemetry_shm_t* shm = nullptr;
+};
+
+TEST_F(TelemetryShmExporterTest, testWriteReadBack)
+{
+    exporter->setNodeFilter([](const QString& nodeId) {
+        return nodeId == ::vehicleNode;
+    });
+    EXPECT_EQ(shm->magic, DREKA_SHM_MAGIC);
+    EXPECT_EQ(shm->version, DREKA_SHM_VERSION);
+    EXPECT_EQ(shm->slot_size, sizeof(dreka_vehicle_slot_t));
+    EXPECT_EQ(shm->slot_count, 0u);
+
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.5 },
+                                            { "longitude", 37.5 },
+                                            { "altitudeAmsl", 150.5 },
+                                            { "roll", 0.25 },
+                                            { "batteryRemaining", 80 } });
+    ASSERT_EQ(shm->slot_count, 1u);
+
+    dreka_vehicle_state_t state;
+    ASSERT_EQ(::dreka_shm_read(shm, 0, &state, ::readAttempts), 1);
+    EXPECT_STREQ(state.vehicle_id, ::vehicleNode);
+    EXPECT_GT(state.timestamp_us, 0);
+    EXPECT_DOUBLE_EQ(state.latitude, 55.5);
+    EXPECT_DOUBLE_EQ(state.longitude, 37.5);
+    EXPECT_DOUBLE_EQ(state.altitude_amsl, 150.5);
+    EXPECT_FLOAT_EQ(state.roll, 0.25f);
+    EXPECT_FLOAT_EQ(state.battery_remaining, 80.0f);
+
+    // Fields never reported are NaN
+    EXPECT_TRUE(std::isnan(state.altitude_relative));
+    EXPECT_TRUE(std::isnan(state.pitch));
+
+    // An update keeps the fields it does not carry, a reset field becomes NaN
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.6 }, { "roll", QVariant() } });
+    ASSERT_EQ(::dreka_shm_read(shm, 0, &state, ::readAttempts), 1);
+    EXPECT_DOUBLE_EQ(state.latitude, 55.6);
+    EXPECT_DOUBLE_EQ(state.longitude, 37.5);
+    EXPECT_TRUE(std::isnan(state.roll));
+    EXPECT_EQ(shm->slot_count, 1u);
+
+    // Properties not in the layout do not touch the slot
+    const uint32_t seq = shm->slots[0].seq;
+    pTree.appendProperties(::vehicleNode, { { "mode", "AUTO" } });
+    EXPECT_EQ(shm->slots[0].seq, seq);
+}
+
+TEST_F(TelemetryShmExporterTest, testOnlyVehicleNodes)
+{
+    // Neither a playback node nor a node of an unknown vehicle takes a slot
+    pTree.appendProperties(::playbackNode, { { "latitude", 55.5 }, { "longitude", 37.5 } });
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.5 }, { "longitude", 37.5 } });
+    EXPECT_EQ(shm->slot_count, 0u);
+
+    dreka_vehicle_state_t state;
+    EXPECT_EQ(::dreka_shm_read(shm, 0, &state, ::readAttempts), 0);
+}
+
+TEST_F(TelemetryShmExporterTest, testCloseUnlinks)
+{
+    exporter->close();
+    EXPECT_FALSE(exporter->isOpen());
+    EXPECT_EQ(this->map(), nullptr);
+}
+#endif
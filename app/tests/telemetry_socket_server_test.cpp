@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QWebSocket>
+
+#include "mission_items_repository_sql.h"
+#include "missions_repository_sql.h"
+#include "missions_service.h"
+#include "property_tree.h"
+#include "sqlite_schema.h"
+#include "telemetry_socket_server.h"
+#include "vehicles_repository_sql.h"
+#include "vehicles_service.h"
+
+using namespace md;
+
+namespace
+{
+constexpr char vehicleNode[] = "vehicle_1";
+constexpr int waitTimeout = 2000;
+constexpr int payloadSize = 1024 * 1024;
+constexpr int maxTicks = 5000;
+
+// Skips other messages until one of the type arrives
+QJsonObject waitFor(QSignalSpy& spy, const QString& type)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < ::waitTimeout)
+    {
+        while (!spy.isEmpty())
+        {
+            const QJsonObject json =
+                QJsonDocument::fromJson(spy.takeFirst().at(0).toString().toUtf8()).object();
+            if (json.value("type").toString() == type)
+                return json;
+        }
+        spy.wait(100);
+    }
+    return QJsonObject();
+}
+} // namespace
+
+class TelemetrySocketServerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        schema.reset(new data_source::SqliteSchema(dir.filePath("dreka.db")));
+        schema->setup();
+
+        vehiclesRepository.reset(new data_source::VehiclesRepositorySql(schema->db()));
+        vehicles.reset(new domain::VehiclesService(vehiclesRepository.data()));
+        missionsRepository.reset(new data_source::MissionsRepositorySql(schema->db()));
+        itemsRepository.reset(new data_source::MissionItemsRepositorySql(schema->db()));
+        missions.reset(
+            new domain::MissionsService(missionsRepository.data(), itemsRepository.data()));
+
+        server.reset(new app::TelemetrySocketServer(&pTree, vehicles.data(), missions.data()));
+        ASSERT_TRUE(server->listen(0));
+
+        QSignalSpy connected(&client, &QWebSocket::connected);
+        client.open(QUrl(QString("ws://127.0.0.1:%1").arg(server->port())));
+        ASSERT_TRUE(connected.wait(::waitTimeout));
+    }
+
+    void TearDown() override
+    {
+        client.close();
+    }
+
+    QTemporaryDir dir;
+    QScopedPointer<data_source::SqliteSchema> schema;
+    QScopedPointer<data_source::VehiclesRepositorySql> vehiclesRepository;
+    QScopedPointer<domain::VehiclesService> vehicles;
+    QScopedPointer<data_source::MissionsRepositorySql> missionsRepository;
+    QScopedPointer<data_source::MissionItemsRepositorySql> itemsRepository;
+    QScopedPointer<domain::MissionsService> missions;
+    domain::PropertyTree pTree;
+    QScopedPointer<app::TelemetrySocketServer> server;
+    QWebSocket client;
+};
+
+TEST_F(TelemetrySocketServerTest, testSnapshotOnConnect)
+{
+    QSignalSpy messages(&client, &QWebSocket::textMessageReceived);
+
+    EXPECT_TRUE(::waitFor(messages, "vehicles").value("vehicles").isArray());
+    EXPECT_TRUE(::waitFor(messages, "missions").value("missions").isArray());
+    EXPECT_EQ(server->clientCount(), 1);
+}
+
+TEST_F(TelemetrySocketServerTest, testPropertiesAreSentAsDeltas)
+{
+    QSignalSpy messages(&client, &QWebSocket::textMessageReceived);
+
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.1 }, { "longitude", 37.2 } });
+    const QJsonObject first = ::waitFor(messages, "properties");
+    ASSERT_EQ(first.value("node").toString(), ::vehicleNode);
+    EXPECT_DOUBLE_EQ(first.value("properties").toObject().value("latitude").toDouble(), 55.1);
+    EXPECT_DOUBLE_EQ(first.value("properties").toObject().value("longitude").toDouble(), 37.2);
+
+    // Only what changed since the last message
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.3 } });
+    const QJsonObject second = ::waitFor(messages, "properties");
+    const QJsonObject properties = second.value("properties").toObject();
+    EXPECT_DOUBLE_EQ(properties.value("latitude").toDouble(), 55.3);
+    EXPECT_FALSE(properties.contains("longitude"));
+}
+
+TEST_F(TelemetrySocketServerTest, testResubscribeStartsFromFullState)
+{
+    QSignalSpy messages(&client, &QWebSocket::textMessageReceived);
+
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.1 }, { "longitude", 37.2 } });
+    ASSERT_FALSE(::waitFor(messages, "properties").isEmpty());
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.3 } });
+    ASSERT_FALSE(::waitFor(messages, "properties").isEmpty());
+
+    client.sendTextMessage(R"({"type":"subscribe","topics":["properties"],"nodes":["vehicle_1"]})");
+    const QJsonObject properties = ::waitFor(messages, "properties").value("properties").toObject();
+    EXPECT_DOUBLE_EQ(properties.value("latitude").toDouble(), 55.3);
+    EXPECT_DOUBLE_EQ(properties.value("longitude").toDouble(), 37.2);
+}
+
+TEST_F(TelemetrySocketServerTest, testNodeFilter)
+{
+    QSignalSpy messages(&client, &QWebSocket::textMessageReceived);
+    client.sendTextMessage(R"({"type":"subscribe","topics":["properties"],"nodes":["vehicle_2"]})");
+    ASSERT_FALSE(::waitFor(messages, "subscribed").isEmpty());
+
+    pTree.appendProperties(::vehicleNode, { { "latitude", 55.1 } });
+    pTree.appendProperties("vehicle_2", { { "latitude", 56.1 } });
+
+    const QJsonObject json = ::waitFor(messages, "properties");
+    EXPECT_EQ(json.value("node").toString(), "vehicle_2");
+    EXPECT_TRUE(::waitFor(messages, "properties").isEmpty());
+}
+
+TEST_F(TelemetrySocketServerTest, testStalledClientIsConflatedThenDropped)
+{
+    // Only the stalled client takes properties
+    QSignalSpy messages(&client, &QWebSocket::textMessageReceived);
+    client.sendTextMessage(R"({"type":"subscribe","topics":["vehicles"]})");
+    ASSERT_FALSE(::waitFor(messages, "subscribed").isEmpty());
+
+    // Upgrades to WebSocket and stops reading, socket buffers fill up after that
+    QTcpSocket stalled;
+    stalled.setReadBufferSize(1);
+    stalled.connectToHost(QHostAddress::LocalHost, server->port());
+    ASSERT_TRUE(stalled.waitForConnected(::waitTimeout));
+    stalled.write("GET / HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\n"
+                  "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                  "Sec-WebSocket-Version: 13\r\n\r\n");
+    ASSERT_TRUE(QTest::qWaitFor(
+        [this]() {
+            return server->clientCount() == 2;
+        },
+        ::waitTimeout));
+
+    // Every tick changes a large property, stalled client gets it at the default rate first
+    int ticks = 0;
+    auto step = [&]() {
+        pTree.appendProperties(::vehicleNode,
+                               { { "payload", QString(::payloadSize, QChar('a' + ticks % 26)) } });
+        server->tick();
+        QCoreApplication::processEvents();
+        ++ticks;
+    };
+    while (server->pendingBytes() <= app::TelemetrySocketServer::conflateBytes &&
+           ticks < ::maxTicks)
+    {
+        step();
+    }
+    ASSERT_LT(ticks, ::maxTicks);
+    ASSERT_EQ(server->clientCount(), 2);
+
+    // Then once a second, so it takes a few seconds of changes to fall behind for good
+    const int conflateTicks = app::TelemetrySocketServer::conflateInterval /
+                              app::TelemetrySocketServer::tickInterval;
+    int sends = 0;
+    for (int i = 0; i < 4 * conflateTicks && server->clientCount() == 2; ++i)
+    {
+        const qint64 pendingBytes = server->pendingBytes();
+        step();
+        if (server->pendingBytes() > pendingBytes)
+            ++sends;
+    }
+    EXPECT_GE(sends, 1);
+    EXPECT_LE(sends, 5); // One per second, the timer may add a due tick
+
+    while (server->clientCount() == 2 && ticks < ::maxTicks)
+    {
+        step();
+    }
+    EXPECT_EQ(server->clientCount(), 1);
+    EXPECT_LE(server->pendingBytes(), app::TelemetrySocketServer::conflateBytes);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <QRandomGenerator>
+#include <memory>
+
+#include "timer_wheel.h"
+
+using namespace md::domain;
+
+namespace
+{
+// Reference schedule: a timer is due at its deadline and fires on the first tick past it
+struct Reference
+{
+    QHash<TimerWheel::TimerId, qint64> deadlines;
+    int fired = 0;
+};
+} // namespace
+
+TEST(TimerWheelTest, testFiresOnTime)
+{
+    qint64 now = 1000;
+    TimerWheel wheel([&now]() {
+        return now;
+    });
+
+    QVector<qint64> firedAt;
+    wheel.schedule(0, [&]() {
+        firedAt.append(now);
+    });
+    wheel.schedule(50, [&]() {
+        firedAt.append(now);
+    });
+
+    now += TimerWheel::tickInterval;
+    wheel.process();
+    EXPECT_EQ(firedAt, QVector<qint64>({ 1020 }));
+
+    now += TimerWheel::tickInterval;
+    wheel.process();
+    EXPECT_EQ(firedAt.count(), 1);
+
+    now += TimerWheel::tickInterval;
+    wheel.process();
+    EXPECT_EQ(firedAt, QVector<qint64>({ 1020, 1060 }));
+    EXPECT_EQ(wheel.count(), 0);
+}
+
+TEST(TimerWheelTest, testRandomSchedule)
+{
+    QRandomGenerator random(47);
+    qint64 now = 0;
+    TimerWheel wheel([&now]() {
+        return now;
+    });
+    Reference reference;
+
+    std::function<void()> scheduleRandom;
+    const auto onFired = [&](TimerWheel::TimerId timerId) {
+        ASSERT_TRUE(reference.deadlines.contains(timerId));
+        EXPECT_GE(now, reference.deadlines.value(timerId)) << "timer " << timerId << " early";
+        reference.deadlines.remove(timerId);
+        reference.fired++;
+
+        // Callbacks reschedule, like retries do
+        if (random.bounded(4) == 0)
+            scheduleRandom();
+    };
+    scheduleRandom = [&]() {
+        // Mostly short timeouts, some spanning the upper levels of the wheel
+        const int msec = random.bounded(10) ? random.bounded(5000)
+                                            : random.bounded(24 * 3600 * 1000);
+        auto timerId = std::make_shared<TimerWheel::TimerId>();
+        *timerId = wheel.schedule(msec, [timerId, &onFired]() {
+            onFired(*timerId);
+        });
+        reference.deadlines.insert(*timerId, now + msec);
+    };
+
+    for (int step = 0; step < 50000; ++step)
+    {
+        const int action = random.bounded(10);
+        const QList<TimerWheel::TimerId> timerIds = reference.deadlines.keys();
+        if (action < 4)
+        {
+            scheduleRandom();
+        }
+        else if (action == 4 && !timerIds.isEmpty())
+        {
+            const TimerWheel::TimerId timerId = timerIds.at(random.bounded(timerIds.count()));
+            ASSERT_TRUE(wheel.cancel(timerId));
+            reference.deadlines.remove(timerId);
+        }
+        else if (action == 5 && !timerIds.isEmpty())
+        {
+            const TimerWheel::TimerId timerId = timerIds.at(random.bounded(timerIds.count()));
+            const int msec = random.bounded(5000);
+            ASSERT_TRUE(wheel.restart(timerId, msec));
+            reference.deadlines.insert(timerId, now + msec);
+        }
+        else
+        {
+            // Busy event loops skip ticks, rarely for minutes
+            now += random.bounded(100) ? random.bounded(3 * TimerWheel::tickInterval)
+                                       : random.bounded(600000);
+            wheel.process();
+
+            // Nothing due up to the last whole tick may be left waiting
+            const qint64 tickStart = now - now % TimerWheel::tickInterval;
+            for (auto it = reference.deadlines.constBegin();
+                 it != reference.deadlines.constEnd(); ++it)
+            {
+                ASSERT_GT(it.value(), tickStart) << "timer " << it.key() << " missed";
+            }
+        }
+        ASSERT_EQ(wheel.count(), reference.deadlines.count());
+    }
+
+    EXPECT_GT(reference.fired, 10000);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+
+#include "web_pack_scheme_handler.h"
+
+using namespace md::app;
+
+class WebPackTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+            GTEST_SKIP() << "Web pack is served with Qt 5.14 or newer";
+        if (QString(PYTHON_EXECUTABLE).isEmpty())
+            GTEST_SKIP() << "Python is required to generate the pack";
+
+        ASSERT_TRUE(dir.isValid());
+        packPath = dir.filePath("web.pack");
+
+        const int result = QProcess::execute(
+            PYTHON_EXECUTABLE, { QString(DREKA_SOURCE_DIR) + "/scripts/webpackgen.py", packPath,
+                                 webDir.absolutePath() + "=web" });
+        ASSERT_EQ(result, 0);
+    }
+
+    QTemporaryDir dir;
+    QString packPath;
+    const QDir webDir = QDir(QString(DREKA_SOURCE_DIR) + "/app/web");
+};
+
+TEST_F(WebPackTest, testIndexReferencesResolve)
+{
+    WebPackSchemeHandler handler(packPath);
+    ASSERT_TRUE(handler.isOpen());
+
+    const QByteArray index = handler.data("web/index.html");
+    ASSERT_FALSE(index.isEmpty());
+
+    // Cesium is packed next to web in the app, the page reaches it by a relative path too
+    QRegularExpression reference("(?:src|href)=\"([^\":]+)\"");
+    auto it = reference.globalMatch(QString::fromUtf8(index));
+    while (it.hasNext())
+    {
+        const QString path = QDir::cleanPath("web/" + it.next().captured(1));
+        if (path.startsWith("Cesium/"))
+            continue;
+
+        QFile file(webDir.absoluteFilePath(path.mid(4)));
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly)) << path.toStdString();
+        EXPECT_EQ(handler.data(path), file.readAll()) << path.toStdString();
+    }
+}
@@ -200,6 +200,24 @@ class CesiumWrapper {
                 vehiclesView.setTrackLength(vehiclesMapController.trackLength);
             }
 
+            var logPlaybackController = channel.objects.logPlaybackController;
+            if (logPlaybackController) {
+                const flightPath = new Path(that.viewer, Cesium.Color.ORANGE);
+                const replay = new Vehicles(that.viewer);
+                const setReplay = () => {
+                    flightPath.setPositions(logPlaybackController.track);
+                    logPlaybackController.replayVehicle(vehicle => {
+                        replay.clear();
+                        if (vehicle.id)
+                            replay.setVehicle(vehicle.id, vehicle);
+                    });
+                }
+
+                logPlaybackController.logChanged.connect(setReplay);
+                logPlaybackController.telemetryChanged.connect((nodeId, data) => { replay.setTelemetry(nodeId, data); });
+                setReplay();
+            }
+
             var adsbController = channel.objects.adsbController;
             if (adsbController) {
                 const adsb = new Adsb(that.viewer);
@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+"""
+Packing directory trees into a single web pack file,
+served by the application's in-process URL scheme handler.
+
+Pack layout (little-endian):
+    magic      8 bytes  b'DRKPACK1'
+    count      uint32   number of entries
+    entries    count x (uint16 path length, path utf-8,
+                        uint16 mime length, mime ascii,
+                        uint64 data offset, uint64 data size)
+    data       concatenated file contents, 16 bytes aligned
+"""
+import os
+import argparse
+import mimetypes
+import struct
+import fnmatch
+import re
+
+MAGIC = b'DRKPACK1'
+ALIGNMENT = 16
+
+MIME_OVERRIDES = {
+    '.js': 'application/javascript',
+    '.mjs': 'application/javascript',
+    '.json': 'application/json',
+    '.wasm': 'application/wasm',
+    '.glb': 'model/gltf-binary',
+    '.gltf': 'model/gltf+json',
+    '.css': 'text/css',
+    '.html': 'text/html',
+    '.svg': 'image/svg+xml',
+    '.ktx2': 'image/ktx2',
+}
+
+def mime_type(path):
+    """
+    Precompute MIME type for the file, falling back to octet stream
+    """
+    ext = os.path.splitext(path)[1].lower()
+    if ext in MIME_OVERRIDES:
+        return MIME_OVERRIDES[ext]
+    mime, _ = mimetypes.guess_type(path)
+    return mime or 'application/octet-stream'
+
+def scan(direc, prefix, excludes):
+    """
+    Scan tree starting from direc, returning (pack path, file path) pairs
+    """
+    excludes = r'|'.join([fnmatch.translate(x) for x in excludes]) or r'$.'
+
+    resources = []
+    for path, dirs, files in os.walk(direc):
+        dirs.sort()
+        for f in sorted(files):
+            full = os.path.join(path, f)
+            if re.match(excludes, full):
+                continue
+            relative = os.path.relpath(full, direc).replace(os.sep, '/')
+            resources.append((prefix + '/' + relative, full))
+    return resources
+
+def write_pack(output, resources):
+    """
+    Write header, entry table and aligned file contents
+    """
+    entries = []
+    header_size = len(MAGIC) + 4
+    for name, full in resources:
+        entry_name = name.encode('utf-8')
+        entry_mime = mime_type(full).encode('ascii')
+        entries.append((entry_name, entry_mime, full, os.path.getsize(full)))
+        header_size += 2 + len(entry_name) + 2 + len(entry_mime) + 8 + 8
+
+    offset = (header_size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+    table = []
+    for entry_name, entry_mime, full, size in entries:
+        table.append((entry_name, entry_mime, offset, size))
+        offset = (offset + size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+    with open(output, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<I', len(table)))
+        for entry_name, entry_mime, data_offset, size in table:
+            f.write(struct.pack('<H', len(entry_name)))
+            f.write(entry_name)
+            f.write(struct.pack('<H', len(entry_mime)))
+            f.write(entry_mime)
+            f.write(struct.pack('<QQ', data_offset, size))
+
+        for (entry_name, entry_mime, data_offset, size), (_, _, full, _) in zip(table, entries):
+            f.write(b'\0' * (data_offset - f.tell()))
+            with open(full, 'rb') as source:
+                f.write(source.read())
+
+def directory_with_prefix(string):
+    """
+    Parse 'directory=prefix' argument
+    """
+    direc, _, prefix = string.partition('=')
+    if not os.path.isdir(direc):
+        msg = "%s is not a valid directory" % direc
+        raise argparse.ArgumentTypeError(msg)
+    return direc, (prefix or os.path.basename(os.path.normpath(direc))).strip('/')
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='Packs directory trees into a single web pack file.')
+    parser.add_argument('output', metavar='output', type=str,
+        help='Output pack file path.')
+    parser.add_argument('directories', metavar='directory[=prefix]', nargs='+',
+        type=directory_with_prefix,
+        help='Directory to pack, optionally followed by its path prefix inside the pack.')
+    parser.add_argument('-e', '--exclude', action='append', metavar='exclude',
+        type=str, default=[],
+        help='Pattern(s) to exclude')
+
+    args = parser.parse_args()
+    resources = []
+    for direc, prefix in args.directories:
+        resources += scan(direc, prefix, args.exclude)
+    write_pack(args.output, resources)